@@ -9,7 +9,17 @@
 			"sources": [
 				"src/chmpx.cc",
 				"src/chmpx_node.cc",
-				"src/chmpx_cbs.cc"
+				"src/chmpx_cbs.cc",
+				"src/chmpx_rcvloop.cc",
+				"src/chmpx_pool.cc",
+				"src/chmpx_request.cc",
+				"src/chmpx_cntrl.cc",
+				"src/chmpx_stats.cc",
+				"src/chmpx_msgpool.cc",
+				"src/chmpx_msgid.cc",
+				"src/chmpx_abort.cc",
+				"src/chmpx_msgiter.cc",
+				"src/chmpx_sendring.cc"
 			],
 			"include_dirs": [
 				"<!(node -e \"incpath = require('node-addon-api').include; if(incpath.length && incpath[0] === '\\\"' && incpath[incpath.length - 1] === '\\\"') incpath = incpath.slice(1, -1); process.stdout.write(incpath)\")",
@@ -47,7 +47,7 @@ Napi::Object InitAll(Napi::Env env, Napi::Object exports)
 	Napi::Function createFn = Napi::Function::New(env, CreateObject, "chmpx");
 
 	// Allow to use "require('chmpx').ChmpxNode"
-	createFn.Set("ChmpxNode", ChmpxNode::constructor.Value());
+	createFn.Set("ChmpxNode", ChmpxNode::GetConstructor(env));
 
 	// Replace module.exports with this function (does not break existing "require('chmpx')()".)
 	return createFn;
@@ -0,0 +1,121 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include "chmpx_abort.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// ChmpxAbortWatcher Class
+//---------------------------------------------------------
+bool ChmpxAbortWatcher::IsSignal(const Napi::Value& value)
+{
+	if(!value.IsObject() || value.IsBuffer() || value.IsFunction()){
+		return false;
+	}
+	Napi::Object	obj = value.As<Napi::Object>();
+	return (obj.Get("aborted").IsBoolean() && obj.Get("addEventListener").IsFunction() && obj.Get("removeEventListener").IsFunction());
+}
+
+ChmpxAbortWatcher::ChmpxAbortWatcher() : flag(make_shared<atomic<bool>>(false))
+{
+}
+
+//
+// [NOTE]
+// This does not call Detach, because the worker may be deleted
+// without JS(ex. tearing down the environment), and a failure of
+// calling JS must not throw from the destructor. The listener is
+// removed by Detach on completion of the worker, otherwise only the
+// references are released.
+//
+ChmpxAbortWatcher::~ChmpxAbortWatcher()
+{
+	signalref.Reset();
+	listenerref.Reset();
+}
+
+//
+// [NOTE]
+// Returns false if the signal has already been aborted, and the
+// flag is set in this case.
+//
+bool ChmpxAbortWatcher::Attach(Napi::Env env, const Napi::Value& signal)
+{
+	Detach();
+
+	Napi::Object	sigobj = signal.As<Napi::Object>();
+	signalref = Napi::Persistent(sigobj);
+	if(sigobj.Get("aborted").ToBoolean()){
+		flag->store(true);
+		return false;
+	}
+
+	abortflag_t		abortflag	= flag;
+	Napi::Function	listener	= Napi::Function::New(env, [abortflag](const Napi::CallbackInfo& info) -> Napi::Value
+	{
+		abortflag->store(true);
+		return info.Env().Undefined();
+	}, "chmpxAbortListener");
+
+	sigobj.Get("addEventListener").As<Napi::Function>().Call(sigobj, { Napi::String::New(env, "abort"), listener });
+	listenerref = Napi::Persistent(listener);
+	return true;
+}
+
+void ChmpxAbortWatcher::Detach(void)
+{
+	if(!signalref.IsEmpty() && !listenerref.IsEmpty()){
+		Napi::Env		env		= signalref.Env();
+		Napi::Object	sigobj	= signalref.Value();
+		sigobj.Get("removeEventListener").As<Napi::Function>().Call(sigobj, { Napi::String::New(env, "abort"), listenerref.Value() });
+	}
+	signalref.Reset();
+	listenerref.Reset();
+}
+
+//
+// [NOTE]
+// Returns signal.reason if it is set, otherwise the Error which
+// name is AbortError as same as the other APIs of Node.js.
+//
+Napi::Value ChmpxAbortWatcher::GetReason(Napi::Env env) const
+{
+	if(!signalref.IsEmpty()){
+		Napi::Value	reason = signalref.Value().Get("reason");
+		if(!reason.IsUndefined()){
+			return reason;
+		}
+	}
+	Napi::Error	err = Napi::Error::New(env, "The operation was aborted.");
+	err.Value().Set("name", Napi::String::New(env, "AbortError"));
+	return err.Value();
+}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,76 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_ABORT_H
+#define CHMPX_ABORT_H
+
+#include <atomic>
+#include <memory>
+#include "chmpx_common.h"
+
+//---------------------------------------------------------
+// ChmpxAbortWatcher Class
+//---------------------------------------------------------
+// [NOTE]
+// This class watches the AbortSignal which is passed to the async
+// receiving methods. The abort listener sets the shared flag, and
+// the worker thread checks it between the receiving slices(see
+// ChmpxCntrl::Receive). Attach and Detach must be called on JS
+// thread, and Detach removes the listener from the signal so that
+// the signal does not keep this after the worker is completed.
+// Detach is called explicitly by the worker(OnOK/OnError), and the
+// destructor only releases the references.
+//
+class ChmpxAbortWatcher
+{
+	public:
+		typedef std::shared_ptr<std::atomic<bool>>	abortflag_t;
+
+		// Returns true if the value looks like AbortSignal
+		static bool IsSignal(const Napi::Value& value);
+
+		ChmpxAbortWatcher();
+		virtual ~ChmpxAbortWatcher();
+
+		bool Attach(Napi::Env env, const Napi::Value& signal);
+		void Detach(void);
+
+		const std::atomic<bool>* GetFlag(void) const { return flag.get(); }
+		bool IsAborted(void) const { return flag->load(); }
+		Napi::Value GetReason(Napi::Env env) const;
+
+	protected:
+		abortflag_t				flag;
+		Napi::ObjectReference	signalref;
+		Napi::FunctionReference	listenerref;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -21,76 +21,118 @@
  *
  */
 
-#include <fullock/flckstructure.h>
-#include <fullock/flckbaselist.tcc>
 #include "chmpx_cbs.h"
 
 using namespace std;
-using namespace fullock;
 
 //---------------------------------------------------------
 // StackEmitCB Class
 //---------------------------------------------------------
-StackEmitCB::StackEmitCB() : lockval(FLCK_NOSHARED_MUTEX_VAL_UNLOCKED)
+StackEmitCB::StackEmitCB()
 {
 }
 
 StackEmitCB::~StackEmitCB()
 {
-	while(!flck_trylock_noshared_mutex(&lockval));	// LOCK
-	EmitCbsMap.clear();
-	flck_unlock_noshared_mutex(&lockval);			// UNLOCK
+	for(int pos = 0; pos < EMITTER_POS_COUNT; ++pos){
+		std::atomic_store(&slots[pos], chmpxemitslot_t());
+	}
 }
 
-bool StackEmitCB::Set(const std::string& emitter, const Napi::Function& cb)
+bool StackEmitCB::Add(Napi::Env env, int pos, const Napi::Function& cb)
 {
-	while(!flck_trylock_noshared_mutex(&lockval));	// LOCK
-
-	// clear if existed
-	auto it = EmitCbsMap.find(emitter);
-	if(EmitCbsMap.end() != it){
-		it->second.Reset();
-		EmitCbsMap.erase(it);
+	if(pos < 0 || EMITTER_POS_COUNT <= pos){
+		return false;
 	}
+	chmpxemitslot_t					slot		= std::atomic_load(&slots[pos]);
+	shared_ptr<chmpxlisteners_t>	listeners	= make_shared<chmpxlisteners_t>();
+
+	if(slot){
+		for(chmpxlisteners_t::const_iterator iter = slot->listeners->begin(); iter != slot->listeners->end(); ++iter){
+			if((*iter)->Value().StrictEquals(cb)){
+				return false;			// already added
+			}
+			listeners->push_back(*iter);
+		}
+	}
+	listeners->push_back(make_shared<Napi::FunctionReference>(Napi::Persistent(cb)));
 
-	// Insert new persistent reference
-	Napi::FunctionReference ref = Napi::Persistent(cb);
-	EmitCbsMap.emplace(emitter, std::move(ref));
-
-	flck_unlock_noshared_mutex(&lockval);			// UNLOCK
-
+	Swap(env, pos, listeners);
 	return true;
 }
 
-bool StackEmitCB::Unset(const std::string& emitter)
+bool StackEmitCB::Remove(Napi::Env env, int pos, const Napi::Function& cb)
 {
-	while(!flck_trylock_noshared_mutex(&lockval));	// LOCK
-
-	auto it = EmitCbsMap.find(emitter);
-	if(EmitCbsMap.end() == it){
-		flck_unlock_noshared_mutex(&lockval);		// UNLOCK
+	if(pos < 0 || EMITTER_POS_COUNT <= pos){
 		return false;
 	}
-	it->second.Reset();
-	EmitCbsMap.erase(it);
-
-	flck_unlock_noshared_mutex(&lockval);			// UNLOCK
+	chmpxemitslot_t	slot = std::atomic_load(&slots[pos]);
+	if(!slot){
+		return false;
+	}
+	if(cb.IsEmpty()){
+		Swap(env, pos, nullptr);
+		return true;
+	}
 
+	shared_ptr<chmpxlisteners_t>	listeners	= make_shared<chmpxlisteners_t>();
+	bool							is_found	= false;
+	for(chmpxlisteners_t::const_iterator iter = slot->listeners->begin(); iter != slot->listeners->end(); ++iter){
+		if(!is_found && (*iter)->Value().StrictEquals(cb)){
+			is_found = true;
+			continue;
+		}
+		listeners->push_back(*iter);
+	}
+	if(!is_found){
+		return false;
+	}
+	Swap(env, pos, (listeners->empty() ? nullptr : listeners));
 	return true;
 }
 
-Napi::FunctionReference* StackEmitCB::Find(const std::string& emitter)
+Napi::Function StackEmitCB::Find(int pos) const
 {
-	while(!flck_trylock_noshared_mutex(&lockval));	// LOCK
+	if(pos < 0 || EMITTER_POS_COUNT <= pos){
+		return Napi::Function();
+	}
+	chmpxemitslot_t	slot = std::atomic_load(&slots[pos]);
+	if(!slot){
+		return Napi::Function();
+	}
+	return slot->callable.Value();
+}
 
-	auto it = EmitCbsMap.find(emitter);
-	if(EmitCbsMap.end() == it){
-		flck_unlock_noshared_mutex(&lockval);		// UNLOCK
-		return nullptr;
+//
+// [NOTE]
+// The dispatcher has the listeners list which is the snapshot at
+// this time, and it is freed with the dispatcher function.
+//
+void StackEmitCB::Swap(Napi::Env env, int pos, const shared_ptr<const chmpxlisteners_t>& listeners)
+{
+	if(!listeners || listeners->empty()){
+		std::atomic_store(&slots[pos], chmpxemitslot_t());
+		return;
 	}
-	flck_unlock_noshared_mutex(&lockval);			// UNLOCK
 
-	return &it->second;
+	shared_ptr<ChmpxEmitSlot>	slot = make_shared<ChmpxEmitSlot>();
+	slot->listeners = listeners;
+	if(1 == listeners->size()){
+		slot->callable = Napi::Persistent(listeners->front()->Value());
+	}else{
+		slot->callable = Napi::Persistent(Napi::Function::New(env, [listeners](const Napi::CallbackInfo& info) -> Napi::Value
+		{
+			vector<napi_value>	args;
+			for(size_t argpos = 0; argpos < info.Length(); ++argpos){
+				args.push_back(info[argpos]);
+			}
+			for(chmpxlisteners_t::const_iterator iter = listeners->begin(); iter != listeners->end(); ++iter){
+				(*iter)->Value().Call(args);
+			}
+			return info.Env().Undefined();
+		}, "chmpxEmitDispatcher"));
+	}
+	std::atomic_store(&slots[pos], chmpxemitslot_t(slot));
 }
 
 /*
@@ -24,36 +24,75 @@
 #ifndef CHMPX_CBS_H
 #define CHMPX_CBS_H
 
-#include <string>
-#include <unordered_map>
+#include <memory>
+#include <vector>
 #include "chmpx_common.h"
 
 //---------------------------------------------------------
-// Typedefs
+// Emitter positions
 //---------------------------------------------------------
-typedef std::unordered_map<std::string, Napi::FunctionReference>	cbsmap;
+#define	EMITTER_POS_INITIALIZEONSERVER			(0)
+#define	EMITTER_POS_INITIALIZEONSLAVE			(EMITTER_POS_INITIALIZEONSERVER	+ 1)
+#define	EMITTER_POS_OPEN						(EMITTER_POS_INITIALIZEONSLAVE	+ 1)
+#define	EMITTER_POS_CLOSE						(EMITTER_POS_OPEN				+ 1)
+#define	EMITTER_POS_SEND						(EMITTER_POS_CLOSE				+ 1)
+#define	EMITTER_POS_BROADCAST					(EMITTER_POS_SEND				+ 1)
+#define	EMITTER_POS_REPLY						(EMITTER_POS_BROADCAST			+ 1)
+#define	EMITTER_POS_RECEIVE						(EMITTER_POS_REPLY				+ 1)
+#define	EMITTER_POS_DRAIN						(EMITTER_POS_RECEIVE			+ 1)
+#define	EMITTER_POS_COUNT						(EMITTER_POS_DRAIN				+ 1)
+
+//---------------------------------------------------------
+// Structure for listeners of one emitter
+//---------------------------------------------------------
+// [NOTE]
+// The slot is never modified after it is created, and on/off
+// creates new slot and swaps it. The callable is the listener
+// itself if there is one listener, otherwise the dispatcher
+// function which calls all listeners in order.
+//
+typedef std::shared_ptr<Napi::FunctionReference>	chmpxlistener_t;
+typedef std::vector<chmpxlistener_t>				chmpxlisteners_t;
+
+struct ChmpxEmitSlot
+{
+	std::shared_ptr<const chmpxlisteners_t>	listeners;
+	Napi::FunctionReference					callable;
+};
+
+typedef std::shared_ptr<const ChmpxEmitSlot>		chmpxemitslot_t;
 
 //---------------------------------------------------------
 // StackEmitCB Class
 //---------------------------------------------------------
+// [NOTE]
+// This class has the listener slot for each emitter position in
+// the fixed array, so finding the callback is O(1) without any
+// lock and string hashing. The slots are swapped atomically, and
+// Find returns the function handle(not the pointer into this
+// object), so on/off can be called while the callbacks are used.
+// The references are created and released only on JS thread.
+//
 class StackEmitCB
 {
 	public:
 		StackEmitCB();
 		virtual ~StackEmitCB();
 
-		// Set returns true if set succeeded
-		bool Set(const std::string& emitter, const Napi::Function& cb);
+		// Add returns false if the callback has already been added
+		bool Add(Napi::Env env, int pos, const Napi::Function& cb);
 
-		// Unset returns true if removed
-		bool Unset(const std::string& emitter);
+		// Remove returns true if removed(all listeners if cb is empty)
+		bool Remove(Napi::Env env, int pos, const Napi::Function& cb = Napi::Function());
 
-		// Find returns pointer to FunctionReference if set, otherwise nullptr
-		Napi::FunctionReference* Find(const std::string& emitter);
+		// Find returns the callable function if set, otherwise empty function
+		Napi::Function Find(int pos) const;
+
+	protected:
+		void Swap(Napi::Env env, int pos, const std::shared_ptr<const chmpxlisteners_t>& listeners);
 
 	protected:
-		cbsmap			EmitCbsMap;
-		volatile int	lockval;				// lock variable for mapping
+		chmpxemitslot_t	slots[EMITTER_POS_COUNT];			// accessed by atomic_load/atomic_store
 };
 
 #endif
@@ -0,0 +1,292 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include "chmpx_cntrl.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// ChmpxCntrl Class
+//---------------------------------------------------------
+// [NOTE]
+// Receive returns true without COMPKT when timeouted, it is
+// counted as timeout.
+//
+bool ChmpxCntrl::Receive(PCOMPKT* ppComPkt, unsigned char** ppbody, size_t* plength, int timeout_ms, bool no_giveup_rejoin)
+{
+	ChmpxStats::statsclock_t::time_point	start	= ChmpxStats::Now();
+	bool									result	= ChmCntrl::Receive(ppComPkt, ppbody, plength, timeout_ms, no_giveup_rejoin);
+	bool									timeout	= (result && (!ppComPkt || !(*ppComPkt)));
+
+	RecordStats(CHM_INVALID_MSGID, CHMPX_STATS_RECEIVE, result, timeout, ((result && plength) ? *plength : 0), start);
+	return result;
+}
+
+bool ChmpxCntrl::Receive(msgid_t msgid, PCOMPKT* ppComPkt, unsigned char** ppbody, size_t* plength, int timeout_ms)
+{
+	ChmpxStats::statsclock_t::time_point	start	= ChmpxStats::Now();
+	bool									result	= ChmCntrl::Receive(msgid, ppComPkt, ppbody, plength, timeout_ms);
+	bool									timeout	= (result && (!ppComPkt || !(*ppComPkt)));
+
+	RecordStats(msgid, CHMPX_STATS_RECEIVE, result, timeout, ((result && plength) ? *plength : 0), start);
+	return result;
+}
+
+bool ChmpxCntrl::Receive(PCOMPKT* ppComPkt, unsigned char** ppbody, size_t* plength, int timeout_ms, bool no_giveup_rejoin, const atomic<bool>* pabort)
+{
+	if(!pabort){
+		return Receive(ppComPkt, ppbody, plength, timeout_ms, no_giveup_rejoin);
+	}
+	return ReceiveSlices([&](int slice_ms) -> bool
+	{
+		return ChmCntrl::Receive(ppComPkt, ppbody, plength, slice_ms, no_giveup_rejoin);
+	}, CHM_INVALID_MSGID, ppComPkt, plength, timeout_ms, pabort);
+}
+
+bool ChmpxCntrl::Receive(msgid_t msgid, PCOMPKT* ppComPkt, unsigned char** ppbody, size_t* plength, int timeout_ms, const atomic<bool>* pabort)
+{
+	if(!pabort){
+		return Receive(msgid, ppComPkt, ppbody, plength, timeout_ms);
+	}
+	return ReceiveSlices([&](int slice_ms) -> bool
+	{
+		return ChmCntrl::Receive(msgid, ppComPkt, ppbody, plength, slice_ms);
+	}, msgid, ppComPkt, plength, timeout_ms, pabort);
+}
+
+//
+// [NOTE]
+// The negative timeout_ms means waiting forever, then this loops
+// until receiving or aborting. The aborted receiving is counted
+// as timeout.
+//
+bool ChmpxCntrl::ReceiveSlices(const function<bool(int)>& receiver, msgid_t msgid, PCOMPKT* ppComPkt, size_t* plength, int timeout_ms, const atomic<bool>* pabort)
+{
+	ChmpxStats::statsclock_t::time_point	start		= ChmpxStats::Now();
+	ChmpxStats::statsclock_t::time_point	deadline	= start + chrono::milliseconds(0 < timeout_ms ? timeout_ms : 0);
+	bool									result		= true;
+	bool									aborted		= false;
+
+	while(true){
+		if(pabort->load()){
+			aborted = true;
+			break;
+		}
+		int	slice_ms = ABORT_SLICE_MS;
+		if(0 <= timeout_ms){
+			int64_t	remain_ms = chrono::duration_cast<chrono::milliseconds>(deadline - ChmpxStats::Now()).count();
+			if(remain_ms < slice_ms){
+				slice_ms = static_cast<int>(0 < remain_ms ? remain_ms : 0);
+			}
+		}
+		result = receiver(slice_ms);
+		if(!result || (ppComPkt && *ppComPkt)){
+			break;				// failure or received
+		}
+		if(0 <= timeout_ms && deadline <= ChmpxStats::Now()){
+			break;				// timeouted
+		}
+	}
+	bool	timeout = (result && (!ppComPkt || !(*ppComPkt)));
+
+	RecordStats(msgid, CHMPX_STATS_RECEIVE, result, timeout, ((result && plength) ? *plength : 0), start);
+	return (result && !aborted);
+}
+
+msgid_t ChmpxCntrl::Open(bool no_giveup_rejoin)
+{
+	ChmpxStats::statsclock_t::time_point	start	= ChmpxStats::Now();
+	msgid_t									msgid	= ChmCntrl::Open(no_giveup_rejoin);
+
+	stats.Record(CHMPX_STATS_OPEN, (CHM_INVALID_MSGID != msgid), false, 0, start);
+	if(CHM_INVALID_MSGID != msgid){
+		lock_guard<mutex>	guard(msgid_lock);
+		opened_msgids.insert(msgid);
+	}
+	return msgid;
+}
+
+bool ChmpxCntrl::Close(msgid_t msgid)
+{
+	ChmpxStats::statsclock_t::time_point	start	= ChmpxStats::Now();
+	bool									result	= ChmCntrl::Close(msgid);
+
+	RecordStats(msgid, CHMPX_STATS_CLOSE, result, false, 0, start);
+	if(result){
+		lock_guard<mutex>	guard(msgid_lock);
+		opened_msgids.erase(msgid);
+		if(0 < msgid_stats.erase(msgid)){
+			--msgid_stats_count;
+		}
+	}
+	return result;
+}
+
+bool ChmpxCntrl::Send(msgid_t msgid, const unsigned char* pbody, size_t blength, chmhash_t hash, long* preceivercnt, bool is_routing)
+{
+	ChmpxStats::statsclock_t::time_point	start	= ChmpxStats::Now();
+	bool									result	= ChmCntrl::Send(msgid, pbody, blength, hash, preceivercnt, is_routing);
+
+	RecordStats(msgid, CHMPX_STATS_SEND, result, false, blength, start);
+	return result;
+}
+
+bool ChmpxCntrl::Broadcast(msgid_t msgid, const unsigned char* pbody, size_t blength, chmhash_t hash, long* preceivercnt)
+{
+	ChmpxStats::statsclock_t::time_point	start	= ChmpxStats::Now();
+	bool									result	= ChmCntrl::Broadcast(msgid, pbody, blength, hash, preceivercnt);
+
+	RecordStats(msgid, CHMPX_STATS_BROADCAST, result, false, blength, start);
+	return result;
+}
+
+bool ChmpxCntrl::Reply(PCOMPKT pComPkt, const unsigned char* pbody, size_t blength)
+{
+	ChmpxStats::statsclock_t::time_point	start	= ChmpxStats::Now();
+	bool									result	= ChmCntrl::Reply(pComPkt, pbody, blength);
+
+	stats.Record(CHMPX_STATS_REPLY, result, false, blength, start);
+	return result;
+}
+
+void ChmpxCntrl::AttachMsgIdStats(msgid_t msgid, const shared_ptr<ChmpxStats>& msgidstats)
+{
+	if(CHM_INVALID_MSGID == msgid || !msgidstats){
+		return;
+	}
+	lock_guard<mutex>	guard(msgid_lock);
+	if(msgid_stats.insert(make_pair(msgid, msgidstats)).second){
+		++msgid_stats_count;
+	}else{
+		msgid_stats[msgid] = msgidstats;
+	}
+}
+
+//
+// [NOTE]
+// The statistics of the msgid are recorded out of the lock, the
+// shared pointer keeps them even if the msgid is closed meanwhile.
+//
+void ChmpxCntrl::RecordStats(msgid_t msgid, CHMPXSTATSOP op, bool is_success, bool is_timeout, size_t bytes, const ChmpxStats::statsclock_t::time_point& start)
+{
+	stats.Record(op, is_success, is_timeout, bytes, start);
+
+	if(CHM_INVALID_MSGID == msgid || 0 == msgid_stats_count.load()){
+		return;
+	}
+	shared_ptr<ChmpxStats>	msgidstats;
+	{
+		lock_guard<mutex>	guard(msgid_lock);
+		map<msgid_t, shared_ptr<ChmpxStats>>::const_iterator	iter = msgid_stats.find(msgid);
+		if(msgid_stats.end() != iter){
+			msgidstats = iter->second;
+		}
+	}
+	if(msgidstats){
+		msgidstats->Record(op, is_success, is_timeout, bytes, start);
+	}
+}
+
+void ChmpxCntrl::BeginWork(void)
+{
+	lock_guard<mutex>	guard(work_lock);
+	++work_count;
+}
+
+//
+// [NOTE]
+// The idle hook may free this object, so nothing is accessed after
+// calling it.
+//
+void ChmpxCntrl::EndWork(void)
+{
+	function<void(void)>	hook;
+	{
+		lock_guard<mutex>	guard(work_lock);
+		if(0 < work_count){
+			--work_count;
+		}
+		if(0 == work_count){
+			work_cond.notify_all();
+			hook.swap(idle_hook);
+		}
+	}
+	if(hook){
+		hook();
+	}
+}
+
+//
+// [NOTE]
+// The negative timeout_ms means waiting forever.
+//
+size_t ChmpxCntrl::WaitWorks(int timeout_ms)
+{
+	unique_lock<mutex>	guard(work_lock);
+	if(timeout_ms < 0){
+		work_cond.wait(guard, [this]{ return (0 == work_count); });
+	}else{
+		work_cond.wait_for(guard, chrono::milliseconds(timeout_ms), [this]{ return (0 == work_count); });
+	}
+	return work_count;
+}
+
+size_t ChmpxCntrl::GetWorkCount(void)
+{
+	lock_guard<mutex>	guard(work_lock);
+	return work_count;
+}
+
+bool ChmpxCntrl::SetIdleHook(const function<void(void)>& hook)
+{
+	lock_guard<mutex>	guard(work_lock);
+	if(0 == work_count){
+		return false;
+	}
+	idle_hook = hook;
+	return true;
+}
+
+size_t ChmpxCntrl::CloseAll(void)
+{
+	set<msgid_t>	msgids;
+	{
+		lock_guard<mutex>	guard(msgid_lock);
+		msgids.swap(opened_msgids);
+	}
+	size_t	closed = 0;
+	for(set<msgid_t>::const_iterator iter = msgids.begin(); iter != msgids.end(); ++iter){
+		if(Close(*iter)){
+			++closed;
+		}
+	}
+	return closed;
+}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
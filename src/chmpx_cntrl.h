@@ -0,0 +1,134 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_CNTRL_H
+#define CHMPX_CNTRL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include "chmpx_common.h"
+#include "chmpx_stats.h"
+
+//---------------------------------------------------------
+// ChmpxCntrl Class
+//---------------------------------------------------------
+// [NOTE]
+// This class is ChmCntrl which records the statistics of the
+// operations. The methods hide the same methods of ChmCntrl, so
+// all code in this module uses this class through ChmpxCntrl*
+// (not ChmCntrl*), then the statistics are recorded on every
+// path(sync, async worker, receiving thread).
+//
+// The Receive methods with the abort flag receive in slices of
+// ABORT_SLICE_MS and check the flag between them, because the
+// blocked receiving in libchmpx can not be woken up from other
+// thread. Returns false without COMPKT when aborted.
+//
+// This class also counts the async workers which use it, and
+// WaitWorks waits until all of them are executed or the timeout
+// expires, so that the object can be cleaned up after draining
+// them. If the timeout expired, SetIdleHook hands the cleanup to
+// the last work(the hook is called by EndWork which ends it, and
+// it may free this object).
+// The msgids which are opened by Open and not closed yet are
+// recorded, and CloseAll closes them.
+//
+// The statistics of the msgid which has a msgid handle(ChmpxMsgId)
+// are also recorded in the handle. They are attached by
+// AttachMsgIdStats and detached when the msgid is closed. The map
+// is not looked up while no statistics are attached.
+//
+// IsReqHeader is the receive option on server side, and the request
+// header(see chmpx_reqhdr.h) is stripped from the received body only
+// when it is true. It is kept here, because all receiving paths
+// (sync, async worker, receiving thread) have this object.
+//
+class ChmpxCntrl : public ChmCntrl
+{
+	public:
+		static const int	ABORT_SLICE_MS = 50;
+
+		ChmpxCntrl() : req_header(false), work_count(0), msgid_stats_count(0) {}
+
+		bool Receive(PCOMPKT* ppComPkt, unsigned char** ppbody, size_t* plength, int timeout_ms, bool no_giveup_rejoin);		// on server
+		bool Receive(msgid_t msgid, PCOMPKT* ppComPkt, unsigned char** ppbody, size_t* plength, int timeout_ms);			// on slave
+		bool Receive(PCOMPKT* ppComPkt, unsigned char** ppbody, size_t* plength, int timeout_ms, bool no_giveup_rejoin, const std::atomic<bool>* pabort);	// on server
+		bool Receive(msgid_t msgid, PCOMPKT* ppComPkt, unsigned char** ppbody, size_t* plength, int timeout_ms, const std::atomic<bool>* pabort);			// on slave
+		msgid_t Open(bool no_giveup_rejoin = false);
+		bool Close(msgid_t msgid);
+		bool Send(msgid_t msgid, const unsigned char* pbody, size_t blength, chmhash_t hash, long* preceivercnt = NULL, bool is_routing = true);
+		bool Broadcast(msgid_t msgid, const unsigned char* pbody, size_t blength, chmhash_t hash, long* preceivercnt = NULL);
+		bool Reply(PCOMPKT pComPkt, const unsigned char* pbody, size_t blength);
+
+		ChmpxStats& GetStats(void) { return stats; }
+
+		// Statistics of the msgid(CHM_INVALID_MSGID is recorded only in this object)
+		void AttachMsgIdStats(msgid_t msgid, const std::shared_ptr<ChmpxStats>& msgidstats);
+		void RecordStats(msgid_t msgid, CHMPXSTATSOP op, bool is_success, bool is_timeout, size_t bytes, const ChmpxStats::statsclock_t::time_point& start);
+
+		// Receive option for the request header
+		void SetReqHeader(bool enable) { req_header = enable; }
+		bool IsReqHeader(void) const { return req_header.load(); }
+
+		// Counting async workers
+		void BeginWork(void);
+		void EndWork(void);
+		size_t WaitWorks(int timeout_ms);				// returns the count of remaining works
+		size_t GetWorkCount(void);
+		bool SetIdleHook(const std::function<void(void)>& hook);		// returns false if no work remains(the hook is not set)
+
+		// Closing opened msgids
+		size_t CloseAll(void);							// returns the count of closed msgids
+
+	protected:
+		bool ReceiveSlices(const std::function<bool(int)>& receiver, msgid_t msgid, PCOMPKT* ppComPkt, size_t* plength, int timeout_ms, const std::atomic<bool>* pabort);
+
+	protected:
+		ChmpxStats				stats;
+		std::atomic<bool>		req_header;
+
+		std::mutex				work_lock;
+		std::condition_variable	work_cond;
+		size_t					work_count;
+		std::function<void(void)>	idle_hook;			// under work_lock
+
+		std::mutex				msgid_lock;
+		std::set<msgid_t>		opened_msgids;
+		std::map<msgid_t, std::shared_ptr<ChmpxStats>>	msgid_stats;		// under msgid_lock
+		std::atomic<size_t>		msgid_stats_count;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
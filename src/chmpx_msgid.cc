@@ -0,0 +1,217 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include <stdio.h>
+#include "chmpx_msgid.h"
+#include "chmpx_node.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// Type tag for ChmpxMsgId object
+//---------------------------------------------------------
+static const napi_type_tag	stc_msgid_type_tag = { 0x63686d7078a1b2c3ULL, 0x6d736769640d4e1fULL };
+
+//---------------------------------------------------------
+// ChmpxMsgId Methods
+//---------------------------------------------------------
+Napi::Function ChmpxMsgId::Init(Napi::Env env)
+{
+	return DefineClass(env, "ChmpxMsgId", {
+		ChmpxMsgId::InstanceMethod("toBuffer",		&ChmpxMsgId::ToBuffer),
+		ChmpxMsgId::InstanceMethod("toBigInt",		&ChmpxMsgId::ToBigInt),
+		ChmpxMsgId::InstanceMethod("toString",		&ChmpxMsgId::ToString),
+		ChmpxMsgId::InstanceMethod("getStats",		&ChmpxMsgId::GetStats),
+		ChmpxMsgId::InstanceMethod("resetStats",	&ChmpxMsgId::ResetStats),
+		ChmpxMsgId::InstanceAccessor("inflight",	&ChmpxMsgId::GetInflight, nullptr),
+		ChmpxMsgId::InstanceAccessor("pending",		&ChmpxMsgId::GetPending, nullptr),
+		ChmpxMsgId::InstanceAccessor("closed",		&ChmpxMsgId::GetClosed, nullptr)
+	});
+}
+
+//
+// [NOTE]
+// The statistics of the handle are attached to pcntrl, so that the
+// operations on the msgid are recorded in them.
+//
+Napi::Object ChmpxMsgId::NewInstance(Napi::Env env, msgid_t msgid, ChmpxCntrl* pcntrl)
+{
+	Napi::EscapableHandleScope	scope(env);
+	ChmpxAddonData*				pdata	= env.GetInstanceData<ChmpxAddonData>();
+
+	// [NOTE]
+	// The msgid is passed by External which is used only in the constructor.
+	//
+	Napi::Object obj = pdata->msgid_constructor.Value().New({Napi::External<msgid_t>::New(env, &msgid)});
+	if(pcntrl){
+		pcntrl->AttachMsgIdStats(msgid, Napi::ObjectWrap<ChmpxMsgId>::Unwrap(obj)->GetState()->stats);
+	}
+	return scope.Escape(napi_value(obj)).ToObject();
+}
+
+ChmpxMsgId* ChmpxMsgId::Get(const Napi::Value& value)
+{
+	if(!value.IsObject()){
+		return NULL;
+	}
+	Napi::Object	obj = value.As<Napi::Object>();
+	if(!obj.CheckTypeTag(&stc_msgid_type_tag)){
+		return NULL;
+	}
+	return Napi::ObjectWrap<ChmpxMsgId>::Unwrap(obj);
+}
+
+ChmpxMsgId::ChmpxMsgId(const Napi::CallbackInfo& info) : Napi::ObjectWrap<ChmpxMsgId>(info), _state(new ChmpxMsgIdState(CHM_INVALID_MSGID))
+{
+	Napi::Env env = info.Env();
+
+	if(info.Length() < 1 || !info[0].IsExternal()){
+		Napi::TypeError::New(env, "ChmpxMsgId can not be created directly, use ChmpxNode::openMsgId().").ThrowAsJavaScriptException();
+		return;
+	}
+	_state->msgid = *(info[0].As<Napi::External<msgid_t>>().Data());
+	info.This().As<Napi::Object>().TypeTag(&stc_msgid_type_tag);
+}
+
+ChmpxMsgId::~ChmpxMsgId()
+{
+}
+
+/// \defgroup nodejs_methods	the methods for using from node.js
+//@{
+
+/**
+ * @memberof ChmpxMsgId
+ * @fn Buffer ToBuffer()
+ * @brief	Get the msgid as Buffer which is as same as ChmpxNode::Open returns
+ *
+ * @return	Returns the new Buffer of msgid.
+ */
+
+Napi::Value ChmpxMsgId::ToBuffer(const Napi::CallbackInfo& info)
+{
+	msgid_t	msgid = _state->msgid;
+	return Napi::Buffer<uint8_t>::Copy(info.Env(), reinterpret_cast<uint8_t*>(&msgid), static_cast<size_t>(sizeof(msgid_t)));
+}
+
+/**
+ * @memberof ChmpxMsgId
+ * @fn BigInt ToBigInt()
+ * @brief	Get the msgid as BigInt
+ *
+ * @return	Returns BigInt value of msgid.
+ */
+
+Napi::Value ChmpxMsgId::ToBigInt(const Napi::CallbackInfo& info)
+{
+	return Napi::BigInt::New(info.Env(), static_cast<uint64_t>(_state->msgid));
+}
+
+/**
+ * @memberof ChmpxMsgId
+ * @fn string ToString()
+ * @brief	Get the msgid as hex string for logging
+ *
+ * @return	Returns the string like "0x0123456789abcdef".
+ */
+
+Napi::Value ChmpxMsgId::ToString(const Napi::CallbackInfo& info)
+{
+	char	szbuff[32];
+	snprintf(szbuff, sizeof(szbuff), "0x%016llx", static_cast<unsigned long long>(_state->msgid));
+	return Napi::String::New(info.Env(), szbuff);
+}
+
+/**
+ * @memberof ChmpxMsgId
+ * @fn int inflight
+ * @brief	The count of async operations in flight on this handle
+ */
+
+Napi::Value ChmpxMsgId::GetInflight(const Napi::CallbackInfo& info)
+{
+	return Napi::Number::New(info.Env(), static_cast<double>(_state->inflight));
+}
+
+/**
+ * @memberof ChmpxMsgId
+ * @fn int pending
+ * @brief	The count of requests waiting for the reply on this handle
+ */
+
+Napi::Value ChmpxMsgId::GetPending(const Napi::CallbackInfo& info)
+{
+	return Napi::Number::New(info.Env(), static_cast<double>(_state->pending));
+}
+
+/**
+ * @memberof ChmpxMsgId
+ * @fn bool closed
+ * @brief	Whether this handle was closed by ChmpxNode::Close
+ */
+
+Napi::Value ChmpxMsgId::GetClosed(const Napi::CallbackInfo& info)
+{
+	return Napi::Boolean::New(info.Env(), _state->closed);
+}
+
+/**
+ * @memberof ChmpxMsgId
+ * @fn Object GetStats()
+ * @brief	Get the statistics of the operations on this msgid
+ *
+ *	The object is as same as ChmpxNode::GetStats, and only send, broadcast,
+ *	receive, close and request are counted. The operations are counted
+ *	until the msgid is closed.
+ *
+ * @return	Returns the statistics object.
+ */
+
+Napi::Value ChmpxMsgId::GetStats(const Napi::CallbackInfo& info)
+{
+	return _state->stats->ToObject(info.Env());
+}
+
+/**
+ * @memberof ChmpxMsgId
+ * @fn bool ResetStats()
+ * @brief	Reset the statistics of the operations on this msgid
+ *
+ * @return	Always returns true.
+ */
+
+Napi::Value ChmpxMsgId::ResetStats(const Napi::CallbackInfo& info)
+{
+	_state->stats->Reset();
+	return Napi::Boolean::New(info.Env(), true);
+}
+
+//@}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
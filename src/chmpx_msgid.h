@@ -0,0 +1,110 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_MSGID_H
+#define CHMPX_MSGID_H
+
+#include <memory>
+#include "chmpx_common.h"
+#include "chmpx_cntrl.h"
+
+//---------------------------------------------------------
+// Structure for msgid handle state
+//---------------------------------------------------------
+// [NOTE]
+// This is shared with the completion hooks of async workers and
+// the requests in flight, so it is alive until all of them are
+// completed. All members except stats are accessed only on JS
+// thread. The stats are shared with ChmpxCntrl, and it records
+// the operations on the msgid from any thread until the msgid is
+// closed.
+//
+struct ChmpxMsgIdState
+{
+	msgid_t						msgid;
+	size_t						inflight;			// async operations in flight on this handle
+	size_t						pending;			// requests waiting for the reply on this handle
+	bool						closed;
+	std::shared_ptr<ChmpxStats>	stats;
+
+	explicit ChmpxMsgIdState(msgid_t id) : msgid(id), inflight(0), pending(0), closed(false), stats(std::make_shared<ChmpxStats>()) {}
+};
+
+//---------------------------------------------------------
+// ChmpxMsgId Class
+//---------------------------------------------------------
+// [NOTE]
+// This class is the native msgid handle which is returned by
+// ChmpxNode::OpenMsgId. The methods which take msgid accept this
+// handle as same as the msgid Buffer, and the msgid is taken from
+// it without validating and copying the Buffer. The handle is
+// checked by the type tag instead of InstanceOf, because the type
+// tag does not walk the prototype chain.
+// The methods which take msgid also accept BigInt msgid.
+// The handle has the statistics of the operations on the msgid
+// (including the operations which take the msgid Buffer), and the
+// count of the requests waiting for the reply.
+//
+class ChmpxMsgId : public Napi::ObjectWrap<ChmpxMsgId>
+{
+	public:
+		typedef std::shared_ptr<ChmpxMsgIdState>	msgidstate_t;
+
+		static Napi::Function Init(Napi::Env env);
+		static Napi::Object NewInstance(Napi::Env env, msgid_t msgid, ChmpxCntrl* pcntrl);
+
+		// Returns the handle if the value is ChmpxMsgId, otherwise NULL
+		static ChmpxMsgId* Get(const Napi::Value& value);
+
+		// Constructor / Destructor
+		explicit ChmpxMsgId(const Napi::CallbackInfo& info);
+		~ChmpxMsgId();
+
+		msgid_t GetMsgId(void) const { return _state->msgid; }
+		bool IsClosed(void) const { return _state->closed; }
+		void SetClosed(void) { _state->closed = true; }
+		const msgidstate_t& GetState(void) const { return _state; }
+
+	private:
+		Napi::Value ToBuffer(const Napi::CallbackInfo& info);
+		Napi::Value ToBigInt(const Napi::CallbackInfo& info);
+		Napi::Value ToString(const Napi::CallbackInfo& info);
+		Napi::Value GetInflight(const Napi::CallbackInfo& info);
+		Napi::Value GetPending(const Napi::CallbackInfo& info);
+		Napi::Value GetClosed(const Napi::CallbackInfo& info);
+		Napi::Value GetStats(const Napi::CallbackInfo& info);
+		Napi::Value ResetStats(const Napi::CallbackInfo& info);
+
+	private:
+		msgidstate_t	_state;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,459 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include <system_error>
+#include "chmpx_msgiter.h"
+#include "chmpx_node.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// Utility functions
+//---------------------------------------------------------
+//
+// Create the result object of async iterator
+//
+static Napi::Object ChmpxCreateIterResult(Napi::Env env, const Napi::Value& value, bool is_done)
+{
+	Napi::Object	result = Napi::Object::New(env);
+	result.Set("value",	value);
+	result.Set("done",	Napi::Boolean::New(env, is_done));
+	return result;
+}
+
+//---------------------------------------------------------
+// ChmpxMsgStream Class
+//---------------------------------------------------------
+ChmpxMsgStream::ChmpxMsgStream(ChmpxCntrl* pobj, bool server, msgid_t msgid, int idle_timeout, size_t hwm, bool no_giveup) :
+	pchmcntrl(pobj), is_server(server), rcv_msgid(msgid), idle_timeout_ms(idle_timeout), high_water_mark(0 < hwm ? hwm : ChmpxMsgStream::DEFAULT_HIGH_WATER_MARK), no_giveup_rejoin(no_giveup), is_exited(true), is_ended(false), is_notified(false), is_running(false), stop_request(false)
+{
+}
+
+//
+// [NOTE]
+// This object is freed after the thread exits, because the
+// ThreadSafeFunction keeps it until then.
+//
+ChmpxMsgStream::~ChmpxMsgStream()
+{
+	RequestStop();
+}
+
+//
+// Run on JS thread
+//
+// [NOTE]
+// env is null when the ThreadSafeFunction is finalizing with
+// remaining calls, then nothing to do.
+//
+void ChmpxMsgStream::CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxMsgStream* context, void* pdata)
+{
+	if(!context || nullptr == static_cast<napi_env>(env)){
+		return;
+	}
+	context->is_notified = false;
+
+	// [NOTE]
+	// The notifier may reset itself(when the iteration is finished), so it is copied.
+	notifier_t	notify = context->notifier;
+	if(notify){
+		notify();
+	}
+}
+
+//
+// Run on JS thread
+//
+// [NOTE]
+// The holder keeps this object alive while the thread is running.
+//
+void ChmpxMsgStream::Finalize(Napi::Env env, std::shared_ptr<ChmpxMsgStream>* pholder, ChmpxMsgStream* context)
+{
+	delete pholder;
+}
+
+//
+// [NOTE]
+// This object is added to the thread list before the thread starts,
+// so that the thread can remove it when exiting.
+//
+bool ChmpxMsgStream::Start(Napi::Env env, const notifier_t& notify, const std::shared_ptr<ChmpxThreadList>& list)
+{
+	{
+		std::lock_guard<std::mutex>	guard(exit_lock);
+		if(!pchmcntrl || !list || !is_exited){
+			return false;
+		}
+		is_exited = false;
+	}
+	notifier	= notify;
+	threadlist	= list;
+	tsfn		= NotifyTsfn::New(env, "ChmpxMsgStream", 0, 1, this, &ChmpxMsgStream::Finalize, new std::shared_ptr<ChmpxMsgStream>(shared_from_this()));
+
+	stop_request	= false;
+	is_running		= true;
+	list->Add(shared_from_this());
+	try{
+		std::thread(&ChmpxMsgStream::Run, this).detach();
+	}catch(const std::system_error& err){
+		list->Remove(shared_from_this());
+		is_running = false;
+		{
+			std::lock_guard<std::mutex>	guard(exit_lock);
+			is_exited = true;
+		}
+		tsfn.Release();
+		return false;
+	}
+	return true;
+}
+
+//
+// Run on JS thread
+//
+size_t ChmpxMsgStream::Pop(chmpxrcvlist_t& rcvlist, size_t maxcount)
+{
+	size_t	count = 0;
+	{
+		std::lock_guard<std::mutex>	guard(queue_lock);
+		for(; count < maxcount && !queue.empty(); ++count){
+			rcvlist.push_back(std::move(queue.front()));
+			queue.pop_front();
+		}
+	}
+	if(0 < count){
+		queue_cond.notify_all();				// resume receiving
+	}
+	return count;
+}
+
+//
+// Run on JS thread
+//
+bool ChmpxMsgStream::IsEnded(std::string& lasterror)
+{
+	std::lock_guard<std::mutex>	guard(queue_lock);
+	if(!is_ended || !queue.empty()){
+		return false;
+	}
+	lasterror = error;
+	return true;
+}
+
+//
+// [NOTE]
+// The thread notices the stop request at the latest after
+// ABORT_SLICE_MS.
+//
+void ChmpxMsgStream::RequestStop(void)
+{
+	{
+		std::lock_guard<std::mutex>	guard(queue_lock);
+		stop_request = true;
+	}
+	queue_cond.notify_all();
+}
+
+bool ChmpxMsgStream::Stop(void)
+{
+	bool	was_running = IsRunning();
+
+	RequestStop();
+
+	std::unique_lock<std::mutex>	guard(exit_lock);
+	exit_cond.wait(guard, [this]{ return is_exited; });
+	return was_running;
+}
+
+//
+// Run on receiving thread
+//
+void ChmpxMsgStream::Notify(void)
+{
+	if(!is_notified.exchange(true)){
+		if(napi_ok != tsfn.NonBlockingCall()){
+			is_notified = false;
+		}
+	}
+}
+
+//
+// Run on receiving thread
+//
+void ChmpxMsgStream::Run(void)
+{
+	string	lasterror;
+	int		timeout_ms = (0 <= idle_timeout_ms ? idle_timeout_ms : ChmpxMsgStream::POLLING_TIMEOUT_MS);
+
+	while(!stop_request.load()){
+		// wait for free space in queue
+		{
+			std::unique_lock<std::mutex>	lock(queue_lock);
+			queue_cond.wait(lock, [this]{ return (stop_request.load() || queue.size() < high_water_mark); });
+		}
+		if(stop_request.load()){
+			break;
+		}
+
+		ChmpxRcvData*	pdata	= NULL;
+		bool			result	= ChmpxReceiveData(pchmcntrl, is_server, rcv_msgid, timeout_ms, no_giveup_rejoin, &pdata, &stop_request);
+		if(!result){
+			if(!stop_request.load()){
+				lasterror = "Failed to receive data.";
+			}
+			break;
+		}
+		if(!pdata){
+			if(0 <= idle_timeout_ms){
+				break;					// no data in idle timeout
+			}
+			continue;
+		}
+		{
+			std::lock_guard<std::mutex>	guard(queue_lock);
+			queue.emplace_back(pdata);
+		}
+		Notify();
+	}
+
+	{
+		std::lock_guard<std::mutex>	guard(queue_lock);
+		error		= lasterror;
+		is_ended	= true;
+	}
+	is_running = false;
+	Notify();
+
+	// [NOTE]
+	// The thread list and ThreadSafeFunction keep this object, and
+	// the ThreadSafeFunction is released at last.
+	//
+	std::shared_ptr<ChmpxThreadList>	list = threadlist.lock();
+	if(list){
+		list->Remove(shared_from_this());
+	}
+	{
+		std::lock_guard<std::mutex>	guard(exit_lock);
+		is_exited = true;
+	}
+	exit_cond.notify_all();
+	tsfn.Release();
+}
+
+//---------------------------------------------------------
+// ChmpxMsgIterator Methods
+//---------------------------------------------------------
+//
+// [NOTE]
+// The parameters are passed by External which is used only in the
+// constructor.
+//
+struct ChmpxMsgIterParam
+{
+	ChmpxMsgStreamPtr						stream;
+	std::shared_ptr<ChmpxThreadList>		threadlist;
+	size_t									batch;
+	CHMPXBODYTYPE							bodytype;
+};
+
+Napi::Function ChmpxMsgIterator::Init(Napi::Env env)
+{
+	return DefineClass(env, "ChmpxMsgIterator", {
+		ChmpxMsgIterator::InstanceMethod("next",										&ChmpxMsgIterator::Next),
+		ChmpxMsgIterator::InstanceMethod("return",										&ChmpxMsgIterator::Return),
+		ChmpxMsgIterator::InstanceMethod(Napi::Symbol::WellKnown(env, "asyncIterator"),	&ChmpxMsgIterator::GetIterator)
+	});
+}
+
+Napi::Object ChmpxMsgIterator::NewInstance(Napi::Env env, const Napi::Object& nodeobj, const ChmpxMsgStreamPtr& stream, const std::shared_ptr<ChmpxThreadList>& threadlist, size_t batch, CHMPXBODYTYPE bodytype)
+{
+	Napi::EscapableHandleScope	scope(env);
+	ChmpxAddonData*				pdata	= env.GetInstanceData<ChmpxAddonData>();
+	ChmpxMsgIterParam			param	= { stream, threadlist, batch, bodytype };
+
+	Napi::Object obj = pdata->msgiter_constructor.Value().New({nodeobj, Napi::External<ChmpxMsgIterParam>::New(env, &param)});
+	return scope.Escape(napi_value(obj)).ToObject();
+}
+
+ChmpxMsgIterator::ChmpxMsgIterator(const Napi::CallbackInfo& info) : Napi::ObjectWrap<ChmpxMsgIterator>(info), _batch(0), _bodytype(CHMPX_BODY_COPY), _done(true)
+{
+	Napi::Env env = info.Env();
+
+	if(info.Length() < 2 || !info[0].IsObject() || !info[0].As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env)) || !info[1].IsExternal()){
+		Napi::TypeError::New(env, "ChmpxMsgIterator can not be created directly, use ChmpxNode::messages().").ThrowAsJavaScriptException();
+		return;
+	}
+	const ChmpxMsgIterParam*	pparam = info[1].As<Napi::External<ChmpxMsgIterParam>>().Data();
+
+	_nodeRef	= Napi::Persistent(info[0].As<Napi::Object>());
+	_batch		= pparam->batch;
+	_bodytype	= pparam->bodytype;
+
+	// start receiving(the stream is registered to the thread list while running)
+	if(!pparam->stream || !pparam->stream->Start(env, [this](){ Dispatch(); }, pparam->threadlist)){
+		Napi::Error::New(env, "Failed to start receiving.").ThrowAsJavaScriptException();
+		return;
+	}
+	_stream	= pparam->stream;
+	_done	= false;
+}
+
+ChmpxMsgIterator::~ChmpxMsgIterator()
+{
+	Finish();
+}
+
+//
+// Request to stop the stream
+//
+// [NOTE]
+// This is called from the destructor, so it does not touch the
+// node object which may have been finalized in the same GC.
+// This does not wait for the thread, it exits after the polling
+// slice and removes the stream from the thread list of ChmpxNode.
+//
+void ChmpxMsgIterator::Finish(void)
+{
+	_done = true;
+	if(!_stream){
+		return;
+	}
+	_stream->ResetNotifier();
+	_stream->RequestStop();
+	_stream.reset();
+}
+
+//
+// Resolve the pending Promises of next()
+//
+// [NOTE]
+// This is called from next() and the notification of the stream.
+// When the stream ended with an error, the first pending Promise is
+// rejected and the others are resolved as done.
+//
+void ChmpxMsgIterator::Dispatch(void)
+{
+	Napi::Env			env = Env();
+	Napi::HandleScope	scope(env);
+
+	while(!_pending.empty()){
+		Napi::Promise::Deferred	deferred = _pending.front();
+
+		if(_done){
+			_pending.pop_front();
+			deferred.Resolve(ChmpxCreateIterResult(env, env.Undefined(), true));
+			continue;
+		}
+
+		chmpxrcvlist_t	rcvlist;
+		if(0 < _stream->Pop(rcvlist, (0 == _batch ? 1 : _batch))){
+			_pending.pop_front();
+			if(0 == _batch){
+				Napi::Array	pair = Napi::Array::New(env, 2);
+				pair.Set(static_cast<uint32_t>(0), ChmpxRcvDataToPktBuffer(env, *rcvlist[0]));
+				pair.Set(static_cast<uint32_t>(1), ChmpxRcvDataToBodyBuffer(env, *rcvlist[0], _bodytype));
+				deferred.Resolve(ChmpxCreateIterResult(env, pair, false));
+			}else{
+				deferred.Resolve(ChmpxCreateIterResult(env, ChmpxRcvDataListToArray(env, rcvlist, _bodytype), false));
+			}
+			continue;
+		}
+
+		string	error;
+		if(!_stream->IsEnded(error)){
+			break;						// wait for the notification
+		}
+		Finish();
+		if(!error.empty()){
+			_pending.pop_front();
+			deferred.Reject(Napi::Error::New(env, error).Value());
+		}
+	}
+}
+
+/// \defgroup nodejs_methods	the methods for using from node.js
+//@{
+
+/**
+ * @memberof ChmpxMsgIterator
+ * @fn Promise Next()
+ * @brief	Get the next received data
+ *
+ * @return	Returns a Promise which is resolved with { value, done }.
+ *			The value is [compkt, body], or an array of them if the batch
+ *			option was specified. done is true after the receiving ended
+ *			(idle timeout, return() or the node was destroyed or drained).
+ *			The Promise is rejected if failed to receive.
+ */
+
+Napi::Value ChmpxMsgIterator::Next(const Napi::CallbackInfo& info)
+{
+	Napi::Env				env			= info.Env();
+	Napi::Promise::Deferred	deferred	= Napi::Promise::Deferred::New(env);
+
+	_pending.push_back(deferred);
+	Dispatch();
+	return deferred.Promise();
+}
+
+/**
+ * @memberof ChmpxMsgIterator
+ * @fn Promise Return()
+ * @brief	Stop receiving(called by break in for await...of)
+ *
+ *	The data which were received and not taken are freed, they are lost.
+ *
+ * @return	Returns a Promise which is resolved with { value: undefined, done: true }.
+ */
+
+Napi::Value ChmpxMsgIterator::Return(const Napi::CallbackInfo& info)
+{
+	Napi::Env				env			= info.Env();
+	Napi::Promise::Deferred	deferred	= Napi::Promise::Deferred::New(env);
+
+	Finish();
+	Dispatch();
+	deferred.Resolve(ChmpxCreateIterResult(env, (0 < info.Length() ? info[0] : env.Undefined()), true));
+	return deferred.Promise();
+}
+
+/**
+ * @memberof ChmpxMsgIterator
+ * @fn ChmpxMsgIterator [Symbol.asyncIterator]()
+ * @brief	Returns this object for for await...of
+ */
+
+Napi::Value ChmpxMsgIterator::GetIterator(const Napi::CallbackInfo& info)
+{
+	return info.This();
+}
+
+//@}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,173 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_MSGITER_H
+#define CHMPX_MSGITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "chmpx_common.h"
+#include "chmpx_cntrl.h"
+#include "chmpx_rcvdata.h"
+#include "chmpx_thrlist.h"
+
+//---------------------------------------------------------
+// ChmpxMsgStream Class
+//---------------------------------------------------------
+// [NOTE]
+// This class runs one dedicated thread which loops on receiving
+// and puts the received data into the bounded queue. When the
+// queue has high_water_mark data, the thread waits until JS takes
+// them(Pop), so the receiving is paused while JS falls behind and
+// the data are left in the MQ of chmpx.
+// JS is notified through the ThreadSafeFunction without data, and
+// the notifications are coalesced until JS takes the data.
+//
+// The receiving is done in slices with the stop flag, so Stop
+// returns after ABORT_SLICE_MS at most.
+// If idle_timeout_ms is not negative, the loop ends when no data
+// arrives within it.
+//
+// The thread is detached, and this object is kept alive by the
+// ThreadSafeFunction until the thread exits, so the notification
+// never refers to the freed object.
+// This object is in the thread list of ChmpxNode while the thread
+// is running, and the thread removes it from the list when exiting.
+// So that JS thread(ex. return() and GC of the iterator) only
+// requests to stop by RequestStop and does not wait for the thread,
+// and the node still waits for the thread by the thread list before
+// its ChmpxCntrl is freed.
+//
+class ChmpxMsgStream : public ChmpxThreadTask, public std::enable_shared_from_this<ChmpxMsgStream>
+{
+	public:
+		static const size_t	DEFAULT_HIGH_WATER_MARK	= 16;
+		static const int	POLLING_TIMEOUT_MS		= 100;
+
+		typedef std::function<void(void)>	notifier_t;
+
+	protected:
+		static void CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxMsgStream* context, void* pdata);
+		static void Finalize(Napi::Env env, std::shared_ptr<ChmpxMsgStream>* pholder, ChmpxMsgStream* context);
+
+	public:
+		typedef Napi::TypedThreadSafeFunction<ChmpxMsgStream, void, ChmpxMsgStream::CallJs>	NotifyTsfn;
+
+		ChmpxMsgStream(ChmpxCntrl* pobj, bool is_server, msgid_t msgid, int idle_timeout_ms, size_t high_water_mark, bool no_giveup);
+		virtual ~ChmpxMsgStream();
+
+		// Run on JS thread
+		bool Start(Napi::Env env, const notifier_t& notifier, const std::shared_ptr<ChmpxThreadList>& threadlist);
+		void ResetNotifier(void) { notifier = nullptr; }
+		size_t Pop(chmpxrcvlist_t& rcvlist, size_t maxcount);		// returns the count of taken data
+		bool IsEnded(std::string& error);							// true if the loop ended and no data is left
+
+		// Run on any thread
+		void RequestStop(void);										// does not wait for the thread
+		bool Stop(void) override;									// waits for the thread
+		bool IsRunning(void) const { return is_running.load(); }
+
+	protected:
+		void Run(void);
+		void Notify(void);
+
+	protected:
+		ChmpxCntrl*							pchmcntrl;
+		bool								is_server;
+		msgid_t								rcv_msgid;
+		int									idle_timeout_ms;
+		size_t								high_water_mark;
+		bool								no_giveup_rejoin;
+
+		notifier_t							notifier;				// only on JS thread
+		NotifyTsfn							tsfn;
+		std::weak_ptr<ChmpxThreadList>		threadlist;
+		std::mutex							exit_lock;
+		std::condition_variable				exit_cond;
+		bool								is_exited;				// under exit_lock
+		std::mutex							queue_lock;
+		std::condition_variable				queue_cond;
+		std::deque<std::unique_ptr<ChmpxRcvData>>	queue;
+		std::string							error;
+		bool								is_ended;
+		std::atomic<bool>					is_notified;
+		std::atomic<bool>					is_running;
+		std::atomic<bool>					stop_request;
+};
+
+typedef std::shared_ptr<ChmpxMsgStream>	ChmpxMsgStreamPtr;
+
+//---------------------------------------------------------
+// ChmpxMsgIterator Class
+//---------------------------------------------------------
+// [NOTE]
+// This class is the async iterator which is returned by
+// ChmpxNode::Messages, and takes the data from ChmpxMsgStream.
+// The stream is started by the constructor and registered to the
+// thread list of ChmpxNode.
+// The Promises of next() are resolved in the called order.
+// This object references ChmpxNode object, so ChmpxNode is not
+// freed while this object is alive.
+//
+class ChmpxMsgIterator : public Napi::ObjectWrap<ChmpxMsgIterator>
+{
+	public:
+		static Napi::Function Init(Napi::Env env);
+		static Napi::Object NewInstance(Napi::Env env, const Napi::Object& nodeobj, const ChmpxMsgStreamPtr& stream, const std::shared_ptr<ChmpxThreadList>& threadlist, size_t batch, CHMPXBODYTYPE bodytype);
+
+		// Constructor / Destructor
+		explicit ChmpxMsgIterator(const Napi::CallbackInfo& info);
+		~ChmpxMsgIterator();
+
+	private:
+		Napi::Value Next(const Napi::CallbackInfo& info);
+		Napi::Value Return(const Napi::CallbackInfo& info);
+		Napi::Value GetIterator(const Napi::CallbackInfo& info);
+
+		void Dispatch(void);
+		void Finish(void);
+
+	private:
+		Napi::ObjectReference					_nodeRef;
+		ChmpxMsgStreamPtr						_stream;
+		size_t									_batch;			// 0 means one data for each next()
+		CHMPXBODYTYPE							_bodytype;
+		bool									_done;
+		std::deque<Napi::Promise::Deferred>		_pending;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
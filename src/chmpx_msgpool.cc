@@ -0,0 +1,458 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include "chmpx_msgpool.h"
+#include "chmpx_node.h"
+#include "chmpx_node_async.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// Utility functions
+//---------------------------------------------------------
+//
+// Run func(0) ... func(count - 1) on up to CHMPX_PARALLEL_MAX threads
+//
+// [NOTE]
+// Each thread(and this thread) takes the next position until all
+// are run, so the count of threads does not depend on the count
+// of msgids(up to 256). If the thread could not be created, the
+// rest are run by the threads which are already created and this
+// thread.
+//
+#define	CHMPX_PARALLEL_MAX		4
+
+static void ChmpxRunParallel(size_t count, const std::function<void(size_t)>& func)
+{
+	std::atomic<size_t>	next(0);
+	auto				runner = [&](){
+		for(size_t pos = next++; pos < count; pos = next++){
+			func(pos);
+		}
+	};
+
+	vector<thread>	threads;
+	try{
+		for(size_t cnt = 1; cnt < std::min(count, static_cast<size_t>(CHMPX_PARALLEL_MAX)); ++cnt){
+			threads.emplace_back(runner);
+		}
+	}catch(const std::system_error&){
+		// run the rest on the created threads and this thread
+	}
+	runner();
+
+	for(vector<thread>::iterator iter = threads.begin(); iter != threads.end(); ++iter){
+		iter->join();
+	}
+}
+
+bool ChmpxOpenMsgIds(ChmpxCntrl* pchmcntrl, size_t count, bool no_giveup_rejoin, vector<msgid_t>& msgids)
+{
+	msgids.assign(count, CHM_INVALID_MSGID);
+	if(!pchmcntrl || 0 == count){
+		msgids.clear();
+		return false;
+	}
+
+	ChmpxRunParallel(count, [&](size_t pos){
+		msgids[pos] = pchmcntrl->Open(no_giveup_rejoin);
+	});
+
+	vector<msgid_t>	opened;
+	for(vector<msgid_t>::const_iterator iter = msgids.begin(); iter != msgids.end(); ++iter){
+		if(CHM_INVALID_MSGID != *iter){
+			opened.push_back(*iter);
+		}
+	}
+	if(opened.size() != count){
+		ChmpxCloseMsgIds(pchmcntrl, opened);
+		msgids.clear();
+		return false;
+	}
+	return true;
+}
+
+bool ChmpxCloseMsgIds(ChmpxCntrl* pchmcntrl, const vector<msgid_t>& msgids)
+{
+	if(!pchmcntrl){
+		return false;
+	}
+
+	vector<char>	results(msgids.size(), 0);		// not vector<bool> for writing from each thread
+	ChmpxRunParallel(msgids.size(), [&](size_t pos){
+		results[pos] = (pchmcntrl->Close(msgids[pos]) ? 1 : 0);
+	});
+
+	for(vector<char>::const_iterator iter = results.begin(); iter != results.end(); ++iter){
+		if(0 == *iter){
+			return false;
+		}
+	}
+	return true;
+}
+
+//---------------------------------------------------------
+// ChmpxMsgPool Methods
+//---------------------------------------------------------
+Napi::Function ChmpxMsgPool::Init(Napi::Env env)
+{
+	return DefineClass(env, "ChmpxMsgPool", {
+		ChmpxMsgPool::InstanceMethod("send",		&ChmpxMsgPool::Send),
+		ChmpxMsgPool::InstanceMethod("request",		&ChmpxMsgPool::Request),
+		ChmpxMsgPool::InstanceMethod("close",		&ChmpxMsgPool::Close),
+		ChmpxMsgPool::InstanceMethod("msgids",		&ChmpxMsgPool::GetMsgIds)
+	});
+}
+
+Napi::Object ChmpxMsgPool::NewInstance(Napi::Env env, const Napi::Object& nodeobj, const vector<msgid_t>& msgids)
+{
+	Napi::EscapableHandleScope	scope(env);
+	ChmpxAddonData*				pdata	= env.GetInstanceData<ChmpxAddonData>();
+	vector<msgid_t>				tmpids(msgids);
+
+	// [NOTE]
+	// The msgids are passed by External which is used only in the constructor.
+	//
+	Napi::Object obj = pdata->msgpool_constructor.Value().New({nodeobj, Napi::External<vector<msgid_t>>::New(env, &tmpids)});
+	return scope.Escape(napi_value(obj)).ToObject();
+}
+
+ChmpxMsgPool::ChmpxMsgPool(const Napi::CallbackInfo& info) : Napi::ObjectWrap<ChmpxMsgPool>(info), _busy(new busylist_t), _next(0), _closed(true)
+{
+	Napi::Env env = info.Env();
+
+	if(info.Length() < 2 || !info[0].IsObject() || !info[0].As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env)) || !info[1].IsExternal()){
+		Napi::TypeError::New(env, "ChmpxMsgPool can not be created directly, use ChmpxNode::openPool().").ThrowAsJavaScriptException();
+		return;
+	}
+	_nodeRef	= Napi::Persistent(info[0].As<Napi::Object>());
+	_msgids		= *(info[1].As<Napi::External<vector<msgid_t>>>().Data());
+	_busy->assign(_msgids.size(), 0);
+	_closed		= _msgids.empty();
+}
+
+ChmpxMsgPool::~ChmpxMsgPool()
+{
+}
+
+//
+// [NOTE]
+// This throws Error and returns false if the pool is closed.
+//
+bool ChmpxMsgPool::CheckOpened(Napi::Env env)
+{
+	if(_closed || _nodeRef.IsEmpty()){
+		Napi::Error::New(env, "The pool is already closed.").ThrowAsJavaScriptException();
+		return false;
+	}
+	return true;
+}
+
+size_t ChmpxMsgPool::SelectMsgId(const ChmpxRequester* prequester)
+{
+	size_t	count	= _msgids.size();
+	size_t	selpos	= _next;
+	size_t	selbusy	= 0;
+	for(size_t cnt = 0; cnt < count; ++cnt){
+		size_t	pos		= (_next + cnt) % count;
+		size_t	busy	= (*_busy)[pos] + (prequester ? prequester->GetPendingCount(_msgids[pos]) : 0);
+		if(0 == cnt || busy < selbusy){
+			selpos	= pos;
+			selbusy	= busy;
+			if(0 == busy){
+				break;
+			}
+		}
+	}
+	_next = (selpos + 1) % count;
+	return selpos;
+}
+
+/// \defgroup nodejs_methods	the methods for using from node.js
+//@{
+
+/**
+ * @memberof ChmpxMsgPool
+ * @fn int\
+ * Send(\
+ * 	Buffer		body\
+ *	, bool		is_routing=true\
+ * 	, Callback	cbfunc=null\
+ * )
+ * @brief	Send the data on the least busy msgid in the pool
+ *
+ *	If the callback function is specified, this method works asynchronization
+ *	and calls callback function at finishing.
+ *
+ * @param[in] body			Specify send data(Buffer, string or array of them)
+ * @param[in] is_routing	Specify routing mode
+ * @param[in] cbfunc		callback function.
+ *
+ * @return	If a callback is set, always return true.
+ *			Otherwise, returns the count of receivers, or -1 if something error occurred.
+ */
+
+Napi::Value ChmpxMsgPool::Send(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No send data is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if(!CheckOpened(env)){
+		return env.Undefined();
+	}
+	ChmpxNode*	node = Napi::ObjectWrap<ChmpxNode>::Unwrap(_nodeRef.Value());
+
+	// info[0] : data Required
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[0])){
+		return env.Undefined();
+	}
+
+	// info[1]
+	Napi::Function	maybeCallback;
+	bool			hasCallback	= false;
+	bool			is_routing	= true;
+	if(1 < info.Length()){
+		if(info[1].IsFunction()){
+			if(2 < info.Length()){
+				Napi::TypeError::New(env, "Last parameter is not callback function.").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+			maybeCallback	= info[1].As<Napi::Function>();
+			hasCallback		= true;
+		}else{
+			is_routing	= info[1].ToBoolean();
+		}
+	}
+
+	// info[2]
+	if(2 < info.Length()){
+		if(3 < info.Length() || !info[2].IsFunction()){
+			Napi::TypeError::New(env, "Last parameter is not callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		maybeCallback	= info[2].As<Napi::Function>();
+		hasCallback		= true;
+	}
+
+	// select msgid
+	size_t	pos		= SelectMsgId(node->_requester.get());
+	msgid_t	msgid	= _msgids[pos];
+
+	// Execute
+	if(hasCallback){
+		// Create worker and Queue it
+		SendWorker*					worker	= new SendWorker(env, maybeCallback, node->_chmcntrl.get(), msgid, body.Owner(), body.Data(), body.Length(), body.GetHash(), is_routing);
+		worker->DetachBody(body);
+		std::shared_ptr<busylist_t>	busy	= _busy;
+		++(*busy)[pos];
+		worker->AddCompleteHook([busy, pos](){
+			--(*busy)[pos];
+		});
+		node->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid));
+		return Napi::Boolean::New(env, true);
+	}else{
+		long	recievercnt	= 0;
+		if(!node->_chmcntrl->Send(msgid, body.Data(), body.Length(), body.GetHash(), &recievercnt, is_routing)){
+			recievercnt = -1;
+		}
+		return Napi::Number::New(env, static_cast<int32_t>(recievercnt));
+	}
+}
+
+/**
+ * @memberof ChmpxMsgPool
+ * @fn Promise\
+ * Request(\
+ * 	Buffer		body\
+ * 	, int		timeout_ms=0\
+ *	, bool		is_routing=true\
+ * )
+ * @brief	Send the request data on the least busy msgid in the pool and wait for the reply
+ *
+ *	This works as same as ChmpxNode::Request on the selected msgid.
+ *
+ * @param[in] body			Specify request data(Buffer, string or array of them)
+ * @param[in] timeout_ms	Specify timeout ms for waiting the reply, 0 or less means no timeout
+ * @param[in] is_routing	Specify routing mode
+ *
+ * @return	Returns the Promise which is resolved with the reply body Buffer, or rejected with Error.
+ */
+
+Napi::Value ChmpxMsgPool::Request(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No send data is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(3 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if(!CheckOpened(env)){
+		return env.Undefined();
+	}
+	ChmpxNode*	node = Napi::ObjectWrap<ChmpxNode>::Unwrap(_nodeRef.Value());
+
+	// info[0] : data Required(gathered after the headroom for request header)
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[0], CHMPX_REQHDR_SIZE)){
+		return env.Undefined();
+	}
+
+	// info[1]
+	int	timeout_ms = (1 < info.Length() ? info[1].ToNumber().Int32Value() : 0);
+
+	// info[2]
+	bool	is_routing = (2 < info.Length() ? info[2].ToBoolean().Value() : true);
+
+	// register the request, and send it on the worker pool
+	msgid_t					msgid	= _msgids[SelectMsgId(node->_requester.get())];
+	ChmpxRequestChannelPtr	channel;
+	uint64_t				reqid	= 0;
+	Napi::Value				promise	= node->_requester->Request(env, node->_chmcntrl.get(), msgid, timeout_ms, channel, reqid);
+	if(channel){
+		ChmpxSetReqHeader(body.Data(), reqid);
+
+		RequestWorker*	worker = new RequestWorker(env, node->_chmcntrl.get(), channel, reqid, msgid, body.Data(), body.Length(), is_routing);
+		worker->DetachBody(body);
+		node->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid));
+	}
+	return promise;
+}
+
+/**
+ * @memberof ChmpxMsgPool
+ * @fn bool\
+ * Close(\
+ * 	Callback cbfunc=null\
+ * )
+ * @brief	Close all msgids in the pool
+ *
+ *	The requests in flight are rejected, and the msgids are closed
+ *	concurrently. The pool can not be used after this.
+ *	If the callback function is specified, this method works asynchronization
+ *	and calls callback function at finishing. Then each msgid is closed
+ *	after the sends which are already queued on it.
+ *
+ * @param[in] cbfunc		callback function.
+ *
+ * @return	If a callback is set, always return true.
+ *			Otherwise, returns true for success, false for failure.
+ */
+
+Napi::Value ChmpxMsgPool::Close(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// info[0]
+	Napi::Function	maybeCallback;
+	bool			hasCallback	= false;
+	if(0 < info.Length()){
+		if(1 < info.Length()){
+			Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if(!info[0].IsFunction()){
+			Napi::TypeError::New(env, "Last parameter is not callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		maybeCallback	= info[0].As<Napi::Function>();
+		hasCallback		= true;
+	}
+	if(!CheckOpened(env)){
+		return env.Undefined();
+	}
+	ChmpxNode*	node = Napi::ObjectWrap<ChmpxNode>::Unwrap(_nodeRef.Value());
+
+	// stop receiving replies for requests on the msgids
+	chmpxreqchannels_t	channels;
+	for(vector<msgid_t>::const_iterator iter = _msgids.begin(); iter != _msgids.end(); ++iter){
+		channels.push_back(node->_requester->Remove(env, *iter));
+	}
+	_closed = true;
+
+	// Execute
+	if(hasCallback){
+		// Create worker for each msgid and Queue it in the send lane of the msgid
+		ChmpxPoolCloseStatePtr	state = std::make_shared<ChmpxPoolCloseState>(maybeCallback, _msgids.size());
+		for(size_t pos = 0; pos < _msgids.size(); ++pos){
+			ClosePoolWorker* worker = new ClosePoolWorker(env, state, node->_chmcntrl.get(), _msgids[pos], channels[pos]);
+			node->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, _msgids[pos]));
+		}
+		return Napi::Boolean::New(env, true);
+	}else{
+		// wait for the threads receiving replies on the msgids
+		for(chmpxreqchannels_t::const_iterator iter = channels.begin(); iter != channels.end(); ++iter){
+			if(*iter){
+				(*iter)->Wait();
+			}
+		}
+		bool result = ChmpxCloseMsgIds(node->_chmcntrl.get(), _msgids);
+		return Napi::Boolean::New(env, result);
+	}
+}
+
+/**
+ * @memberof ChmpxMsgPool
+ * @fn Array\
+ * GetMsgIds()
+ * @brief	Get msgids in the pool
+ *
+ *	The replies for the data sent by Send are received on the msgid
+ *	which sent it, so these msgids are used for receiving them.
+ *
+ * @return	Returns the array of msgid Buffers.
+ */
+
+Napi::Value ChmpxMsgPool::GetMsgIds(const Napi::CallbackInfo& info)
+{
+	Napi::Env	env		= info.Env();
+	Napi::Array	result	= Napi::Array::New(env, _msgids.size());
+	for(size_t pos = 0; pos < _msgids.size(); ++pos){
+		msgid_t	msgid = _msgids[pos];
+		result.Set(static_cast<uint32_t>(pos), Napi::Buffer<uint8_t>::Copy(env, reinterpret_cast<uint8_t*>(&msgid), static_cast<size_t>(sizeof(msgid_t))));
+	}
+	return result;
+}
+
+//@}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
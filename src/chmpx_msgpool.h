@@ -0,0 +1,109 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_MSGPOOL_H
+#define CHMPX_MSGPOOL_H
+
+#include <memory>
+#include <vector>
+#include "chmpx_common.h"
+#include "chmpx_cntrl.h"
+
+class ChmpxRequester;
+
+//---------------------------------------------------------
+// Utility functions for msgid pool
+//---------------------------------------------------------
+//
+// Open count msgids concurrently(on up to CHMPX_PARALLEL_MAX threads)
+//
+// [NOTE]
+// If some of them failed, the opened msgids are closed and
+// returns false.
+//
+bool ChmpxOpenMsgIds(ChmpxCntrl* pchmcntrl, size_t count, bool no_giveup_rejoin, std::vector<msgid_t>& msgids);
+
+//
+// Close all msgids concurrently(on up to CHMPX_PARALLEL_MAX threads),
+// returns false if some of them failed
+//
+bool ChmpxCloseMsgIds(ChmpxCntrl* pchmcntrl, const std::vector<msgid_t>& msgids);
+
+//---------------------------------------------------------
+// ChmpxMsgPool Class
+//---------------------------------------------------------
+// [NOTE]
+// This class has the msgids opened by ChmpxNode::OpenPool, and
+// each send or request is done on the least busy msgid.
+// The busy count of a msgid is the count of async sends in
+// flight by this pool and the count of requests in flight on
+// it, and the msgids which have the same count are selected
+// by round-robin.
+// All methods run on JS thread, and the busy counts are shared
+// with the workers(decremented at completion on JS thread).
+//
+// This object references ChmpxNode object, so ChmpxNode is not
+// freed while this object is alive. If this object is freed
+// without closing, the msgids are closed when ChmpxNode is
+// cleaned up.
+//
+class ChmpxMsgPool : public Napi::ObjectWrap<ChmpxMsgPool>
+{
+	public:
+		static const size_t	MAX_COUNT = 256;
+
+		static Napi::Function Init(Napi::Env env);
+		static Napi::Object NewInstance(Napi::Env env, const Napi::Object& nodeobj, const std::vector<msgid_t>& msgids);
+
+		// Constructor / Destructor
+		explicit ChmpxMsgPool(const Napi::CallbackInfo& info);
+		~ChmpxMsgPool();
+
+	private:
+		Napi::Value Send(const Napi::CallbackInfo& info);
+		Napi::Value Request(const Napi::CallbackInfo& info);
+		Napi::Value Close(const Napi::CallbackInfo& info);
+		Napi::Value GetMsgIds(const Napi::CallbackInfo& info);
+
+		bool CheckOpened(Napi::Env env);
+		size_t SelectMsgId(const ChmpxRequester* prequester);
+
+	private:
+		typedef std::vector<size_t>		busylist_t;
+
+		Napi::ObjectReference			_nodeRef;
+		std::vector<msgid_t>			_msgids;
+		std::shared_ptr<busylist_t>		_busy;			// async sends in flight for each msgid
+		size_t							_next;			// start position of round-robin
+		bool							_closed;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -21,6 +21,8 @@
  *
  */
 
+#include <system_error>
+#include <thread>
 #include "chmpx_node.h"
 #include "chmpx_node_async.h"
 
@@ -29,15 +31,6 @@ using namespace std;
 //---------------------------------------------------------
 // Emitter
 //---------------------------------------------------------
-#define	EMITTER_POS_INITIALIZEONSERVER			(0)
-#define	EMITTER_POS_INITIALIZEONSLAVE			(EMITTER_POS_INITIALIZEONSERVER	+ 1)
-#define	EMITTER_POS_OPEN						(EMITTER_POS_INITIALIZEONSLAVE	+ 1)
-#define	EMITTER_POS_CLOSE						(EMITTER_POS_OPEN				+ 1)
-#define	EMITTER_POS_SEND						(EMITTER_POS_CLOSE				+ 1)
-#define	EMITTER_POS_BROADCAST					(EMITTER_POS_SEND				+ 1)
-#define	EMITTER_POS_REPLY						(EMITTER_POS_BROADCAST			+ 1)
-#define	EMITTER_POS_RECEIVE						(EMITTER_POS_REPLY				+ 1)
-
 const char*	stc_emitters[] = {
 	"initializeOnServer",
 	"initializeOnSlave",
@@ -47,31 +40,32 @@ const char*	stc_emitters[] = {
 	"broadcast",
 	"reply",
 	"receive",
+	"drain",
 	NULL
 };
 
-inline const char* GetNormalizationEmitter(const char* emitter)
+inline int GetEmitterPosition(const char* emitter)
 {
 	if(!emitter){
-		return nullptr;
+		return -1;
 	}
-	for(const char** ptmp = &stc_emitters[0]; ptmp && *ptmp; ++ptmp){
-		if(0 == strcasecmp(*ptmp, emitter)){
-			return *ptmp;
+	for(int pos = 0; stc_emitters[pos]; ++pos){
+		if(0 == strcasecmp(stc_emitters[pos], emitter)){
+			return pos;
 		}
 	}
-	return nullptr;
+	return -1;
 }
 
 //---------------------------------------------------------
 // Utility (using StackEmitCB Class)
 //---------------------------------------------------------
-static Napi::Value SetChmpxNodeCallback(const Napi::CallbackInfo& info, size_t pos, const char* pemitter)
+static Napi::Value SetChmpxNodeCallback(const Napi::CallbackInfo& info, size_t pos, int emitpos)
 {
 	Napi::Env env = info.Env();
 
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
@@ -88,36 +82,247 @@ static Napi::Value SetChmpxNodeCallback(const Napi::CallbackInfo& info, size_t p
 	}
 	Napi::Function cb = info[pos].As<Napi::Function>();
 
-	// set
-	bool result = obj->_cbs.Set(std::string(pemitter), cb);
+	// add
+	bool result = obj->_cbs.Add(env, emitpos, cb);
 	return Napi::Boolean::New(env, result);
 }
 
-static Napi::Value UnsetChmpxNodeCallback(const Napi::CallbackInfo& info, const char* pemitter)
+//
+// [NOTE]
+// If the callback is specified at pos, only it is removed,
+// otherwise all callbacks for the emitter are removed.
+//
+static Napi::Value UnsetChmpxNodeCallback(const Napi::CallbackInfo& info, size_t pos, int emitpos)
 {
 	Napi::Env env = info.Env();
 
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
 	ChmpxNode* obj = Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
 
-	// unset
-	bool result = obj->_cbs.Unset(std::string(pemitter));
+	// check parameter
+	Napi::Function cb;
+	if(pos < info.Length() && !info[pos].IsUndefined()){
+		if(!info[pos].IsFunction()){
+			Napi::TypeError::New(env, "The parameter is not callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		cb = info[pos].As<Napi::Function>();
+	}
+
+	// remove
+	bool result = obj->_cbs.Remove(env, emitpos, cb);
 	return Napi::Boolean::New(env, result);
 }
 
 //---------------------------------------------------------
-// ChmpxNode Class
+// Utility (parameters)
+//---------------------------------------------------------
+// [NOTE]
+// These functions throw TypeError and return false if the
+// parameter is wrong.
+//
+//
+// [NOTE]
+// The msgid is ChmpxMsgId handle, BigInt or Buffer. The handle is
+// checked first, because it does not need validating and copying.
+// If ppmsgidobj is not NULL, the handle(or NULL) is set to it.
+//
+static bool GetChmpxMsgIdParam(Napi::Env env, const Napi::Value& value, msgid_t& msgid, ChmpxMsgId** ppmsgidobj = NULL)
+{
+	if(ppmsgidobj){
+		*ppmsgidobj = NULL;
+	}
+
+	ChmpxMsgId*	pmsgidobj = ChmpxMsgId::Get(value);
+	if(pmsgidobj){
+		if(pmsgidobj->IsClosed()){
+			Napi::Error::New(env, "The msgid is already closed.").ThrowAsJavaScriptException();
+			return false;
+		}
+		msgid = pmsgidobj->GetMsgId();
+		if(ppmsgidobj){
+			*ppmsgidobj = pmsgidobj;
+		}
+		return true;
+	}
+
+	if(value.IsBigInt()){
+		bool	lossless = false;
+		msgid			 = static_cast<msgid_t>(value.As<Napi::BigInt>().Uint64Value(&lossless));
+		if(!lossless){
+			Napi::RangeError::New(env, "The msgid is out of range.").ThrowAsJavaScriptException();
+			return false;
+		}
+		return true;
+	}
+
+	if(!value.IsBuffer()){
+		Napi::TypeError::New(env, "Wrong msgid is specified.").ThrowAsJavaScriptException();
+		return false;
+	}
+	Napi::Buffer<uint8_t>	msgidbuf	= value.As<Napi::Buffer<uint8_t>>();
+	size_t					msgidLen	= std::min(msgidbuf.Length(), static_cast<size_t>(sizeof(msgid_t)));
+	msgid								= CHM_INVALID_MSGID;
+	memcpy(&msgid, msgidbuf.Data(), msgidLen);
+	return true;
+}
+
+//
+// [NOTE]
+// The key is a Buffer or a string, and the hash value is calculated
+// from the key as same as the body in Send.
+//
+static bool GetChmpxKeyHashParam(Napi::Env env, const Napi::Value& value, chmhash_t& hash)
+{
+	ChmBinData	bindata;
+	if(value.IsBuffer()){
+		Napi::Buffer<unsigned char>	keybuf	= value.As<Napi::Buffer<unsigned char>>();
+		if(!keybuf.Data() && 0 < keybuf.Length()){
+			Napi::TypeError::New(env, "Could not access key buffer.").ThrowAsJavaScriptException();
+			return false;
+		}
+		bindata.Set(keybuf.Data(), static_cast<ssize_t>(keybuf.Length()));
+	}else if(value.IsString()){
+		std::string	strkey = value.As<Napi::String>().Utf8Value();
+		bindata.Set(reinterpret_cast<const unsigned char*>(strkey.c_str()), static_cast<ssize_t>(strkey.length()));
+	}else{
+		Napi::TypeError::New(env, "Wrong key is specified.").ThrowAsJavaScriptException();
+		return false;
+	}
+	hash = bindata.GetHash();
+	return true;
+}
+
+//
+// [NOTE]
+// The hash value is a Number(integer up to 2^53) or a BigInt.
+//
+static bool GetChmpxHashParam(Napi::Env env, const Napi::Value& value, chmhash_t& hash)
+{
+	if(value.IsBigInt()){
+		bool		lossless	= true;
+		uint64_t	u64value	= value.As<Napi::BigInt>().Uint64Value(&lossless);
+		if(!lossless){
+			Napi::RangeError::New(env, "The hash value is out of range.").ThrowAsJavaScriptException();
+			return false;
+		}
+		hash = static_cast<chmhash_t>(u64value);
+	}else if(value.IsNumber()){
+		double	dvalue = value.As<Napi::Number>().DoubleValue();
+		if(dvalue < 0 || 9007199254740991.0 < dvalue || dvalue != static_cast<double>(static_cast<uint64_t>(dvalue))){
+			Napi::RangeError::New(env, "The hash value must be an integer from 0 to Number.MAX_SAFE_INTEGER.").ThrowAsJavaScriptException();
+			return false;
+		}
+		hash = static_cast<chmhash_t>(dvalue);
+	}else{
+		Napi::TypeError::New(env, "Wrong hash value is specified.").ThrowAsJavaScriptException();
+		return false;
+	}
+	return true;
+}
+
+//
+// [NOTE]
+// bodies is set the new array which has the same Buffers as value,
+// it is used for keeping the Buffers while async sending.
+// Each element is parsed as same as the body of Send, and the body
+// which is gathered(string or array of pieces) is moved into
+// gathered, so sndlist points to it.
+//
+static bool GetChmpxBodyListParam(Napi::Env env, const Napi::Value& value, chmpxsndlist_t& sndlist, Napi::Array& bodies, chmpxsndbufs_t& gathered)
+{
+	if(!value.IsArray()){
+		Napi::TypeError::New(env, "Wrong send data array is specified.").ThrowAsJavaScriptException();
+		return false;
+	}
+	Napi::Array	bodyarr	= value.As<Napi::Array>();
+	uint32_t	count	= bodyarr.Length();
+
+	sndlist.clear();
+	sndlist.reserve(count);
+	gathered.clear();
+	bodies = Napi::Array::New(env, count);
+	for(uint32_t pos = 0; pos < count; ++pos){
+		Napi::Value		element	= bodyarr.Get(pos);
+		ChmpxSndBody	body;
+		if(!body.Set(env, element)){
+			return false;
+		}
+		sndlist.push_back(ChmpxSndData(body.Data(), body.Length()));
+		if(body.IsGathered()){
+			gathered.emplace_back();
+			body.Detach(gathered.back());				// the moved buffer keeps the pointer in sndlist
+		}
+		bodies.Set(pos, element);
+	}
+	return true;
+}
+
+//
+// [NOTE]
+// If the compkt Buffer is received by a request, has_reqid and reqid
+// are set from the request header after COMPKT.
+//
+static bool GetChmpxComPktParam(Napi::Env env, const Napi::Value& value, COMPKT& compkt, bool& has_reqid, uint64_t& reqid)
+{
+	if(!value.IsBuffer()){
+		Napi::TypeError::New(env, "Wrong compkt is specified.").ThrowAsJavaScriptException();
+		return false;
+	}
+	Napi::Buffer<unsigned char>	pktBuf	= value.As<Napi::Buffer<unsigned char>>();
+	size_t						pktLen	= pktBuf.Length();
+	const unsigned char*		pktptr	= pktBuf.Data();
+	size_t						copyLen	= std::min(pktLen, sizeof(COMPKT));
+
+	if(!pktptr && 0 < pktLen){
+		Napi::TypeError::New(env, "Could not access compkt.").ThrowAsJavaScriptException();
+		return false;
+	}
+	memset(&compkt, 0, sizeof(COMPKT));
+	if(0 < copyLen){
+		memcpy(reinterpret_cast<char*>(&compkt), pktptr, copyLen);
+	}
+	has_reqid = ChmpxGetPktReqHeader(pktptr, pktLen, reqid);
+	return true;
+}
+
+//---------------------------------------------------------
+// Utility (fast path)
+//---------------------------------------------------------
+// [NOTE]
+// ChmpxNode object is tagged in the constructor, and the fast path
+// methods check the tag instead of InstanceOf which walks the
+// prototype chain. This throws TypeError and returns NULL if this
+// is not ChmpxNode object.
+//
+static const napi_type_tag	stc_node_type_tag = { 0x63686d7078c4d5e6ULL, 0x6e6f64650a1b2c3dULL };
+
+static ChmpxNode* GetChmpxNodeFast(const Napi::CallbackInfo& info)
+{
+	Napi::Value	thisobj = info.This();
+	if(!thisobj.IsObject() || !thisobj.As<Napi::Object>().CheckTypeTag(&stc_node_type_tag)){
+		Napi::TypeError::New(info.Env(), "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return NULL;
+	}
+	return Napi::ObjectWrap<ChmpxNode>::Unwrap(thisobj.As<Napi::Object>());
+}
+
+//---------------------------------------------------------
+// Per-environment data
 //---------------------------------------------------------
-Napi::FunctionReference	ChmpxNode::constructor;
+ChmpxAddonData::~ChmpxAddonData()
+{
+	delete pool;
+}
 
 //---------------------------------------------------------
 // ChmpxNode Methods
 //---------------------------------------------------------
-ChmpxNode::ChmpxNode(const Napi::CallbackInfo& info) : Napi::ObjectWrap<ChmpxNode>(info), _cbs(), _chmcntrl()
+ChmpxNode::ChmpxNode(const Napi::CallbackInfo& info) : Napi::ObjectWrap<ChmpxNode>(info), _cbs(), _chmcntrl(new ChmpxCntrl), _rcvloop(), _requester(new ChmpxRequester), _threads(std::make_shared<ChmpxThreadList>()), _zerocopy_rcv(false), _utf8_rcv(false), _draining(false), _drain_running(false), _flow(std::make_shared<ChmpxFlowState>(this))
 {
 	// [NOTE]
 	// Perhaps due to an initialization order issue, these
@@ -141,11 +346,310 @@ ChmpxNode::ChmpxNode(const Napi::CallbackInfo& info) : Napi::ObjectWrap<ChmpxNod
 		}
 		chmpx_set_debug_file(chmpxdbgfile);		// Ignore any errors that occur.
 	}
+
+	// tag for fast path methods
+	info.This().As<Napi::Object>().TypeTag(&stc_node_type_tag);
+
+	// cleanup at tearing down the environment
+	napi_add_env_cleanup_hook(info.Env(), ChmpxNode::EnvCleanupHook, this);
 }
 
+//
+// [NOTE]
+// This runs in the finalizer on JS thread, so the resources are
+// handed to another thread and cleaned up on it. The cleanup
+// waits for the async workers which are running, then detaches
+// MQs(Clean), so it never blocks the event loop.
+// The requests in flight and the workers waiting for the flow
+// control are rejected first, because this object is dying(the
+// waiting workers are not submitted with this object as the
+// owner).
+// If the environment is tearing down, the resources are already
+// cleaned up by EnvCleanupHook.
+//
 ChmpxNode::~ChmpxNode()
 {
-	_chmcntrl.Clean();
+	napi_remove_env_cleanup_hook(Env(), ChmpxNode::EnvCleanupHook, this);
+	_flow->node = NULL;
+
+	if(!_chmcntrl){
+		return;
+	}
+	{
+		Napi::HandleScope	scope(Env());
+		_requester->CancelAll(Env(), "The object is destroyed.");
+	}
+	RejectWaitingWorkers("The object is destroyed.");
+
+	ChmpxNodeResources*	pres = DetachResources(false);
+	try{
+		std::thread([pres](){
+			if(pres->Cleanup()){
+				delete pres;
+			}
+		}).detach();
+	}catch(const std::system_error& err){
+		if(pres->Cleanup()){
+			delete pres;
+		}
+	}
+}
+
+//
+// Run on JS thread at tearing down the environment
+//
+// [NOTE]
+// The cleanup runs synchronously here, because the thread which is
+// detached at this time may not finish before the process exits,
+// and then MQs are not detached.
+// The waiting workers are never submitted, so they are deleted
+// without calling their callbacks(JS can not be called here).
+// The workers queued in the worker pool are still executed by the
+// pool threads, and the cleanup waits for them up to WAIT_WORKS_MS.
+//
+void ChmpxNode::EnvCleanupHook(void* arg)
+{
+	ChmpxNode*	obj = static_cast<ChmpxNode*>(arg);
+	if(!obj || !obj->_chmcntrl){
+		return;
+	}
+	while(!obj->_flow->waiting.empty()){
+		delete obj->_flow->waiting.front().first;
+		obj->_flow->waiting.pop_front();
+	}
+
+	ChmpxNodeResources*	pres = obj->DetachResources(false);
+	if(pres->Cleanup()){
+		delete pres;
+	}
+}
+
+//
+// Move the resources out of this object
+//
+// [NOTE]
+// If is_renew is true, this object gets new resources, so that it
+// can be initialized again.
+//
+ChmpxNodeResources* ChmpxNode::DetachResources(bool is_renew)
+{
+	ChmpxNodeResources*	pres = new ChmpxNodeResources;
+	_rcvloop.reset();										// the loop is stopped by the thread list
+	pres->chmcntrl	= std::move(_chmcntrl);
+	pres->requester	= std::move(_requester);
+	pres->threads	= std::move(_threads);
+
+	if(is_renew){
+		_chmcntrl.reset(new ChmpxCntrl);
+		_chmcntrl->SetReqHeader(pres->chmcntrl->IsReqHeader());			// receive option is kept
+		_requester.reset(new ChmpxRequester);
+		_threads	= std::make_shared<ChmpxThreadList>();
+	}
+	return pres;
+}
+
+//
+// [NOTE]
+// This blocks until the threads stop and the async workers are
+// executed, so it should run off JS thread.
+// If some workers are not executed in WAIT_WORKS_MS, MQs are not
+// detached here and this returns false. Then the resources are
+// handed to the last worker, which detaches MQs and deletes them
+// when it ends(on the thread which ends it), so the caller must
+// not delete them.
+//
+bool ChmpxNodeResources::Cleanup(void)
+{
+	if(threads){
+		threads->StopAll();
+	}
+	if(requester){
+		requester->Stop();
+	}
+	if(chmcntrl){
+		if(0 < chmcntrl->WaitWorks(ChmpxNodeResources::WAIT_WORKS_MS)){
+			ChmpxNodeResources*	pres = this;
+			if(chmcntrl->SetIdleHook([pres](){
+				pres->chmcntrl->Clean();
+				delete pres;
+			})){
+				return false;
+			}
+		}
+		chmcntrl->Clean();
+	}
+	return true;
+}
+
+//
+// [NOTE]
+// The async workers run on the worker thread pool of this module,
+// and the workers in the same lane run in the queued order on it.
+// If the pool is not available, the worker is queued to the libuv
+// thread pool and the order is not guaranteed.
+// If the msgid handle is specified, the worker is counted in it
+// until the completion.
+// While draining, the worker is rejected without executing, and
+// it is completed asynchronously(on the worker pool) as same as
+// the executed workers.
+//
+// The workers in the send lane(send, broadcast, batch and close)
+// are counted by the flow control until the completion. If the
+// count is over maxInFlight, the worker waits in the FIFO of this
+// object, and it is submitted when the other worker is completed.
+//
+void ChmpxNode::QueueWorker(ChmpxAsyncWorker* pworker, const ChmpxPoolLane& lane, ChmpxMsgId* pmsgidobj)
+{
+	if(_draining){
+		pworker->Reject("The object is draining, new operations are not accepted.");
+
+		ChmpxWorkerPool*	pool = ChmpxNode::GetPool(Env());
+		if(!pool || !pool->Complete(pworker)){
+			pworker->OnWorkComplete(Env(), napi_ok);
+		}
+		return;
+	}
+
+	pworker->SetWorkCntrl(_chmcntrl.get());
+
+	if(pmsgidobj){
+		ChmpxMsgId::msgidstate_t	state = pmsgidobj->GetState();
+		++(state->inflight);
+		pworker->AddCompleteHook([state](){
+			--(state->inflight);
+		});
+	}
+
+	if(CHMPX_LANE_SEND == lane.type){
+		std::shared_ptr<ChmpxFlowState>	flow = _flow;
+		++(flow->inflight);
+		pworker->AddCompleteHook([flow](){
+			ChmpxNode::CompleteFlow(flow);
+		});
+		if(0 < flow->max_inflight && flow->max_inflight < flow->inflight){
+			flow->waiting.emplace_back(pworker, lane);
+			return;
+		}
+	}
+	SubmitWorker(pworker, lane);
+}
+
+void ChmpxNode::SubmitWorker(ChmpxAsyncWorker* pworker, const ChmpxPoolLane& lane)
+{
+	ChmpxWorkerPool*	pool = ChmpxNode::GetPool(Env());
+	if(!pool || !pool->Queue(pworker, this, lane)){
+		pworker->Queue();
+	}
+}
+
+//
+// Submit the waiting workers up to maxInFlight
+//
+void ChmpxNode::SubmitWaitingWorkers(void)
+{
+	while(!_flow->waiting.empty() && (0 == _flow->max_inflight || (_flow->inflight - _flow->waiting.size()) < _flow->max_inflight)){
+		std::pair<ChmpxAsyncWorker*, ChmpxPoolLane>	waiting = _flow->waiting.front();
+		_flow->waiting.pop_front();
+		SubmitWorker(waiting.first, waiting.second);
+	}
+}
+
+//
+// [NOTE]
+// This submits all waiting workers regardless of maxInFlight, it is
+// called before the resources are detached, because the cleanup
+// waits for them.
+//
+void ChmpxNode::FlushWaitingWorkers(void)
+{
+	while(!_flow->waiting.empty()){
+		std::pair<ChmpxAsyncWorker*, ChmpxPoolLane>	waiting = _flow->waiting.front();
+		_flow->waiting.pop_front();
+		SubmitWorker(waiting.first, waiting.second);
+	}
+}
+
+//
+// [NOTE]
+// This rejects all waiting workers without executing them, and they
+// are completed on JS thread later by the worker pool. If the pool
+// is not available, they are deleted without calling callbacks,
+// because this may be called in the finalizer.
+//
+void ChmpxNode::RejectWaitingWorkers(const char* perror)
+{
+	ChmpxWorkerPool*	pool = ChmpxNode::GetPool(Env());
+	while(!_flow->waiting.empty()){
+		ChmpxAsyncWorker*	pworker = _flow->waiting.front().first;
+		_flow->waiting.pop_front();
+
+		pworker->Reject(perror);
+		if(!pool || !pool->Complete(pworker)){
+			delete pworker;
+		}
+	}
+}
+
+//
+// Returns false if the count of workers in flight reaches maxInFlight
+//
+// [NOTE]
+// This works like stream.write(), the drain event is emitted after
+// returning false and the count becomes less than maxInFlight.
+//
+bool ChmpxNode::CheckFlow(void)
+{
+	if(0 == _flow->max_inflight || _flow->inflight < _flow->max_inflight){
+		return true;
+	}
+	_flow->need_drain = true;
+	return false;
+}
+
+//
+// Returns false and throws if the object is draining
+//
+// [NOTE]
+// The asynchronous operations are rejected by QueueWorker while
+// draining, and the synchronous operations check this before
+// executing, so that no operation starts after drain().
+//
+bool ChmpxNode::CheckAccepting(Napi::Env env) const
+{
+	if(_draining){
+		Napi::Error::New(env, "The object is draining, new operations are not accepted.").ThrowAsJavaScriptException();
+		return false;
+	}
+	return true;
+}
+
+//
+// [NOTE]
+// This is called as the completion hook of the worker on JS thread.
+// The flow state is shared by the hooks, so it is alive after the
+// object is destroyed(then node is NULL).
+//
+void ChmpxNode::CompleteFlow(const std::shared_ptr<ChmpxFlowState>& flow)
+{
+	if(0 < flow->inflight){
+		--(flow->inflight);
+	}
+	if(!flow->node){
+		return;
+	}
+
+	// submit waiting workers
+	flow->node->SubmitWaitingWorkers();
+
+	// drain event
+	if(flow->need_drain && (0 == flow->max_inflight || flow->inflight < flow->max_inflight)){
+		flow->need_drain = false;
+
+		Napi::Function	emitterCb = flow->node->_cbs.Find(EMITTER_POS_DRAIN);
+		if(!emitterCb.IsEmpty()){
+			emitterCb.Call({ flow->node->Env().Null() });
+		}
+	}
 }
 
 void ChmpxNode::Init(Napi::Env env, Napi::Object exports)
@@ -169,6 +673,7 @@ void ChmpxNode::Init(Napi::Env env, Napi::Object exports)
 		ChmpxNode::InstanceMethod("onBroadcast",			&ChmpxNode::OnBroadcast),
 		ChmpxNode::InstanceMethod("onReply",				&ChmpxNode::OnReply),
 		ChmpxNode::InstanceMethod("onReceive",				&ChmpxNode::OnReceive),
+		ChmpxNode::InstanceMethod("onDrain",				&ChmpxNode::OnDrain),
 		ChmpxNode::InstanceMethod("off",					&ChmpxNode::Off),
 		ChmpxNode::InstanceMethod("offInitializeOnServer",	&ChmpxNode::OffInitializeOnServer),
 		ChmpxNode::InstanceMethod("offInitializeOnSlave",	&ChmpxNode::OffInitializeOnSlave),
@@ -178,21 +683,73 @@ void ChmpxNode::Init(Napi::Env env, Napi::Object exports)
 		ChmpxNode::InstanceMethod("offBroadcast",			&ChmpxNode::OffBroadcast),
 		ChmpxNode::InstanceMethod("offReply",				&ChmpxNode::OffReply),
 		ChmpxNode::InstanceMethod("offReceive",				&ChmpxNode::OffReceive),
+		ChmpxNode::InstanceMethod("offDrain",				&ChmpxNode::OffDrain),
 
 		// Prototype
 		ChmpxNode::InstanceMethod("initializeOnServer",		&ChmpxNode::InitializeOnServer),
 		ChmpxNode::InstanceMethod("initializeOnSlave",		&ChmpxNode::InitializeOnSlave),
 		ChmpxNode::InstanceMethod("send",					&ChmpxNode::Send),
 		ChmpxNode::InstanceMethod("broadcast",				&ChmpxNode::Broadcast),
+		ChmpxNode::InstanceMethod("sendByKey",				&ChmpxNode::SendByKey),
+		ChmpxNode::InstanceMethod("sendWithHash",			&ChmpxNode::SendWithHash),
+		ChmpxNode::InstanceMethod("sendBatch",				&ChmpxNode::SendBatch),
+		ChmpxNode::InstanceMethod("broadcastBatch",			&ChmpxNode::BroadcastBatch),
 		ChmpxNode::InstanceMethod("receive",				&ChmpxNode::Receive),
+		ChmpxNode::InstanceMethod("receiveBatch",			&ChmpxNode::ReceiveBatch),
 		ChmpxNode::InstanceMethod("reply",					&ChmpxNode::Reply),
 		ChmpxNode::InstanceMethod("open",					&ChmpxNode::Open),
 		ChmpxNode::InstanceMethod("close",					&ChmpxNode::Close),
-		ChmpxNode::InstanceMethod("isChmpxExit",			&ChmpxNode::IsChmpxExit)
+		ChmpxNode::InstanceMethod("openMsgId",				&ChmpxNode::OpenMsgId),
+		ChmpxNode::InstanceMethod("openPool",				&ChmpxNode::OpenPool),
+		ChmpxNode::InstanceMethod("openSendRing",			&ChmpxNode::OpenSendRing),
+		ChmpxNode::InstanceMethod("isChmpxExit",			&ChmpxNode::IsChmpxExit),
+		ChmpxNode::InstanceMethod("destroy",				&ChmpxNode::Destroy),
+		ChmpxNode::InstanceMethod("startReceiving",			&ChmpxNode::StartReceiving),
+		ChmpxNode::InstanceMethod("stopReceiving",			&ChmpxNode::StopReceiving),
+		ChmpxNode::InstanceMethod("messages",				&ChmpxNode::Messages),
+		ChmpxNode::InstanceMethod("setReceiveOptions",		&ChmpxNode::SetReceiveOptions),
+		ChmpxNode::InstanceMethod("setFlowOptions",			&ChmpxNode::SetFlowOptions),
+		ChmpxNode::InstanceMethod("getStats",				&ChmpxNode::GetStats),
+		ChmpxNode::InstanceMethod("resetStats",				&ChmpxNode::ResetStats),
+		ChmpxNode::InstanceMethod("drain",					&ChmpxNode::Drain),
+
+		// Fast path(fixed signature, no emitter)
+		ChmpxNode::InstanceMethod("sendFast",				&ChmpxNode::SendFast),
+		ChmpxNode::InstanceMethod("receiveFast",			&ChmpxNode::ReceiveFast),
+		ChmpxNode::InstanceMethod("replyFast",				&ChmpxNode::ReplyFast),
+
+		// Promise
+		ChmpxNode::InstanceMethod("initializeOnServerAsync",	&ChmpxNode::InitializeOnServerAsync),
+		ChmpxNode::InstanceMethod("initializeOnSlaveAsync",		&ChmpxNode::InitializeOnSlaveAsync),
+		ChmpxNode::InstanceMethod("sendAsync",					&ChmpxNode::SendAsync),
+		ChmpxNode::InstanceMethod("broadcastAsync",				&ChmpxNode::BroadcastAsync),
+		ChmpxNode::InstanceMethod("receiveAsync",				&ChmpxNode::ReceiveAsync),
+		ChmpxNode::InstanceMethod("receiveBatchAsync",			&ChmpxNode::ReceiveBatchAsync),
+		ChmpxNode::InstanceMethod("replyAsync",					&ChmpxNode::ReplyAsync),
+		ChmpxNode::InstanceMethod("openAsync",					&ChmpxNode::OpenAsync),
+		ChmpxNode::InstanceMethod("closeAsync",					&ChmpxNode::CloseAsync),
+		ChmpxNode::InstanceMethod("openMsgIdAsync",				&ChmpxNode::OpenMsgIdAsync),
+		ChmpxNode::InstanceMethod("openPoolAsync",				&ChmpxNode::OpenPoolAsync),
+		ChmpxNode::InstanceMethod("destroyAsync",				&ChmpxNode::DestroyAsync),
+		ChmpxNode::InstanceMethod("drainAsync",					&ChmpxNode::DrainAsync),
+		ChmpxNode::InstanceMethod("request",					&ChmpxNode::Request),
+
+		// Static
+		ChmpxNode::StaticMethod("configurePool",				&ChmpxNode::ConfigurePool)
 	});
 
-	constructor = Napi::Persistent(funcs);
-	constructor.SuppressDestruct();
+	// [NOTE]
+	// The constructor and the worker thread pool for async workers
+	// are kept in the instance data of this environment.
+	//
+	ChmpxAddonData*	pdata		= new ChmpxAddonData;
+	pdata->constructor			= Napi::Persistent(funcs);
+	pdata->msgid_constructor	= Napi::Persistent(ChmpxMsgId::Init(env));
+	pdata->msgpool_constructor	= Napi::Persistent(ChmpxMsgPool::Init(env));
+	pdata->msgiter_constructor	= Napi::Persistent(ChmpxMsgIterator::Init(env));
+	pdata->sendring_constructor	= Napi::Persistent(ChmpxSendRing::Init(env));
+	pdata->pool					= new ChmpxWorkerPool(env);
+	env.SetInstanceData<ChmpxAddonData>(pdata);
 
 	// [NOTE]
 	// do NOT do exports.Set("ChmpxNode", func) here if InitAll will return createFn.
@@ -208,7 +765,7 @@ Napi::Value ChmpxNode::New(const Napi::CallbackInfo& info)
 		return info.This();
 	}else{
 		// Invoked as plain function ChmpxNode(), turn into construct call.
-		return constructor.New({});		// always no arguments
+		return ChmpxNode::GetConstructor(info.Env()).New({});		// always no arguments
 	}
 }
 
@@ -221,19 +778,31 @@ Napi::Value ChmpxNode::New(const Napi::CallbackInfo& info)
 Napi::Object ChmpxNode::NewInstance(Napi::Env env)
 {
 	Napi::EscapableHandleScope scope(env);
-	Napi::Object obj = constructor.New({}).As<Napi::Object>();
+	Napi::Object obj = ChmpxNode::GetConstructor(env).New({}).As<Napi::Object>();
 	return scope.Escape(napi_value(obj)).ToObject();
 }
 
 Napi::Object ChmpxNode::GetInstance(const Napi::CallbackInfo& info)
 {
 	if(0 < info.Length()){
-		return ChmpxNode::constructor.New({info[0]});
+		return ChmpxNode::GetConstructor(info.Env()).New({info[0]});
 	}else{
-		return ChmpxNode::constructor.New({});
+		return ChmpxNode::GetConstructor(info.Env()).New({});
 	}
 }
 
+Napi::Function ChmpxNode::GetConstructor(Napi::Env env)
+{
+	ChmpxAddonData*	pdata = env.GetInstanceData<ChmpxAddonData>();
+	return pdata->constructor.Value();
+}
+
+ChmpxWorkerPool* ChmpxNode::GetPool(Napi::Env env)
+{
+	ChmpxAddonData*	pdata = env.GetInstanceData<ChmpxAddonData>();
+	return (pdata ? pdata->pool : NULL);
+}
+
 /**
  * @mainpage chmpx_nodejs
  */
@@ -248,7 +817,7 @@ Napi::Object ChmpxNode::GetInstance(const Napi::CallbackInfo& info)
  * 	String	emitter\
  * 	, Callback cbfunc\
  * )
- * @brief	set callback handling
+ * @brief	add callback handling(an emitter can have multiple callbacks)
  *
  * @param[in] emitter			Specify emitter name
  * @param[in] cbfunc			callback function.
@@ -271,8 +840,8 @@ Napi::Value ChmpxNode::On(const Napi::CallbackInfo& info)
 
 	// check emitter name
 	std::string emitter  = info[0].ToString().Utf8Value();
-	const char* pemitter = GetNormalizationEmitter(emitter.c_str());
-	if(!pemitter){
+	int         emitpos  = GetEmitterPosition(emitter.c_str());
+	if(emitpos < 0){
 		std::string	msg	= "Unknown ";
 		msg				+= emitter;
 		msg				+= " emitter";
@@ -281,7 +850,7 @@ Napi::Value ChmpxNode::On(const Napi::CallbackInfo& info)
 	}
 
 	// add callback
-	return SetChmpxNodeCallback(info, 1, pemitter);
+	return SetChmpxNodeCallback(info, 1, emitpos);
 }
 
 /**
@@ -299,7 +868,7 @@ Napi::Value ChmpxNode::On(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OnInitializeOnServer(const Napi::CallbackInfo& info)
 {
-	return SetChmpxNodeCallback(info, 0, stc_emitters[EMITTER_POS_INITIALIZEONSERVER]);
+	return SetChmpxNodeCallback(info, 0, EMITTER_POS_INITIALIZEONSERVER);
 }
 
 /**
@@ -317,7 +886,7 @@ Napi::Value ChmpxNode::OnInitializeOnServer(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OnInitializeOnSlave(const Napi::CallbackInfo& info)
 {
-	return SetChmpxNodeCallback(info, 0, stc_emitters[EMITTER_POS_INITIALIZEONSLAVE]);
+	return SetChmpxNodeCallback(info, 0, EMITTER_POS_INITIALIZEONSLAVE);
 }
 
 /**
@@ -335,7 +904,7 @@ Napi::Value ChmpxNode::OnInitializeOnSlave(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OnOpen(const Napi::CallbackInfo& info)
 {
-	return SetChmpxNodeCallback(info, 0, stc_emitters[EMITTER_POS_OPEN]);
+	return SetChmpxNodeCallback(info, 0, EMITTER_POS_OPEN);
 }
 
 /**
@@ -353,7 +922,7 @@ Napi::Value ChmpxNode::OnOpen(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OnClose(const Napi::CallbackInfo& info)
 {
-	return SetChmpxNodeCallback(info, 0, stc_emitters[EMITTER_POS_CLOSE]);
+	return SetChmpxNodeCallback(info, 0, EMITTER_POS_CLOSE);
 }
 
 /**
@@ -371,7 +940,7 @@ Napi::Value ChmpxNode::OnClose(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OnSend(const Napi::CallbackInfo& info)
 {
-	return SetChmpxNodeCallback(info, 0, stc_emitters[EMITTER_POS_SEND]);
+	return SetChmpxNodeCallback(info, 0, EMITTER_POS_SEND);
 }
 
 /**
@@ -389,7 +958,7 @@ Napi::Value ChmpxNode::OnSend(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OnBroadcast(const Napi::CallbackInfo& info)
 {
-	return SetChmpxNodeCallback(info, 0, stc_emitters[EMITTER_POS_BROADCAST]);
+	return SetChmpxNodeCallback(info, 0, EMITTER_POS_BROADCAST);
 }
 
 /**
@@ -407,7 +976,7 @@ Napi::Value ChmpxNode::OnBroadcast(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OnReply(const Napi::CallbackInfo& info)
 {
-	return SetChmpxNodeCallback(info, 0, stc_emitters[EMITTER_POS_REPLY]);
+	return SetChmpxNodeCallback(info, 0, EMITTER_POS_REPLY);
 }
 
 /**
@@ -425,7 +994,25 @@ Napi::Value ChmpxNode::OnReply(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OnReceive(const Napi::CallbackInfo& info)
 {
-	return SetChmpxNodeCallback(info, 0, stc_emitters[EMITTER_POS_RECEIVE]);
+	return SetChmpxNodeCallback(info, 0, EMITTER_POS_RECEIVE);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn void\
+ * OnDrain(\
+ * 	Callback cbfunc\
+ * )
+ * @brief	set callback handling for the drain event of the flow control
+ *
+ * @param[in] cbfunc			callback function.
+ *
+ * @return return true for success, false for failure
+ */
+
+Napi::Value ChmpxNode::OnDrain(const Napi::CallbackInfo& info)
+{
+	return SetChmpxNodeCallback(info, 0, EMITTER_POS_DRAIN);
 }
 
 /**
@@ -433,10 +1020,13 @@ Napi::Value ChmpxNode::OnReceive(const Napi::CallbackInfo& info)
  * @fn void\
  * Off(\
  * 	String	emitter\
+ * 	, Callback cbfunc\
  * )
- * @brief	set callback handling
+ * @brief	unset callback handling
  *
  * @param[in] emitter			Specify emitter name
+ * @param[in] cbfunc			Specify the callback function to remove(optional).
+ *								If it is not specified, all callbacks are removed.
  *
  * @return return true for success, false for failure
  */
@@ -452,8 +1042,8 @@ Napi::Value ChmpxNode::Off(const Napi::CallbackInfo& info)
 
 	// check emitter name
 	std::string	emitter  = info[0].ToString().Utf8Value();
-	const char*	pemitter = GetNormalizationEmitter(emitter.c_str());
-	if (nullptr == pemitter) {
+	int			emitpos  = GetEmitterPosition(emitter.c_str());
+	if(emitpos < 0){
 		std::string msg	= "Unknown ";
 		msg				+= emitter;
 		msg				+= " emitter";
@@ -461,7 +1051,7 @@ Napi::Value ChmpxNode::Off(const Napi::CallbackInfo& info)
 		return env.Undefined();
 	}
 	// unset callback
-	return UnsetChmpxNodeCallback(info, pemitter);
+	return UnsetChmpxNodeCallback(info, 1, emitpos);
 }
 
 /**
@@ -476,7 +1066,7 @@ Napi::Value ChmpxNode::Off(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OffInitializeOnServer(const Napi::CallbackInfo& info)
 {
-	return UnsetChmpxNodeCallback(info, stc_emitters[EMITTER_POS_INITIALIZEONSERVER]);
+	return UnsetChmpxNodeCallback(info, 0, EMITTER_POS_INITIALIZEONSERVER);
 }
 
 /**
@@ -491,7 +1081,7 @@ Napi::Value ChmpxNode::OffInitializeOnServer(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OffInitializeOnSlave(const Napi::CallbackInfo& info)
 {
-	return UnsetChmpxNodeCallback(info, stc_emitters[EMITTER_POS_INITIALIZEONSLAVE]);
+	return UnsetChmpxNodeCallback(info, 0, EMITTER_POS_INITIALIZEONSLAVE);
 }
 
 /**
@@ -506,7 +1096,7 @@ Napi::Value ChmpxNode::OffInitializeOnSlave(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OffOpen(const Napi::CallbackInfo& info)
 {
-	return UnsetChmpxNodeCallback(info, stc_emitters[EMITTER_POS_OPEN]);
+	return UnsetChmpxNodeCallback(info, 0, EMITTER_POS_OPEN);
 }
 
 /**
@@ -521,7 +1111,7 @@ Napi::Value ChmpxNode::OffOpen(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OffClose(const Napi::CallbackInfo& info)
 {
-	return UnsetChmpxNodeCallback(info, stc_emitters[EMITTER_POS_CLOSE]);
+	return UnsetChmpxNodeCallback(info, 0, EMITTER_POS_CLOSE);
 }
 
 /**
@@ -536,7 +1126,7 @@ Napi::Value ChmpxNode::OffClose(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OffSend(const Napi::CallbackInfo& info)
 {
-	return UnsetChmpxNodeCallback(info, stc_emitters[EMITTER_POS_SEND]);
+	return UnsetChmpxNodeCallback(info, 0, EMITTER_POS_SEND);
 }
 
 /**
@@ -551,7 +1141,7 @@ Napi::Value ChmpxNode::OffSend(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OffBroadcast(const Napi::CallbackInfo& info)
 {
-	return UnsetChmpxNodeCallback(info, stc_emitters[EMITTER_POS_BROADCAST]);
+	return UnsetChmpxNodeCallback(info, 0, EMITTER_POS_BROADCAST);
 }
 
 /**
@@ -566,7 +1156,7 @@ Napi::Value ChmpxNode::OffBroadcast(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OffReply(const Napi::CallbackInfo& info)
 {
-	return UnsetChmpxNodeCallback(info, stc_emitters[EMITTER_POS_REPLY]);
+	return UnsetChmpxNodeCallback(info, 0, EMITTER_POS_REPLY);
 }
 
 /**
@@ -581,7 +1171,22 @@ Napi::Value ChmpxNode::OffReply(const Napi::CallbackInfo& info)
 
 Napi::Value ChmpxNode::OffReceive(const Napi::CallbackInfo& info)
 {
-	return UnsetChmpxNodeCallback(info, stc_emitters[EMITTER_POS_RECEIVE]);
+	return UnsetChmpxNodeCallback(info, 0, EMITTER_POS_RECEIVE);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn void\
+ * OffDrain(\
+ * )
+ * @brief	unset callback handling for the drain event of the flow control
+ *
+ * @return return true for success, false for failure
+ */
+
+Napi::Value ChmpxNode::OffDrain(const Napi::CallbackInfo& info)
+{
+	return UnsetChmpxNodeCallback(info, 0, EMITTER_POS_DRAIN);
 }
 
 /**
@@ -620,7 +1225,7 @@ Napi::Value ChmpxNode::InitializeOnServer(const Napi::CallbackInfo& info)
 	}
 
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
@@ -629,9 +1234,9 @@ Napi::Value ChmpxNode::InitializeOnServer(const Napi::CallbackInfo& info)
 	// initial callback comes from emitter map if set
 	Napi::Function				maybeCallback;
 	bool						hasCallback		= false;
-	Napi::FunctionReference*	emitterCbRef	= obj->_cbs.Find(stc_emitters[EMITTER_POS_INITIALIZEONSERVER]);
-	if(emitterCbRef){
-		maybeCallback	= emitterCbRef->Value();
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_INITIALIZEONSERVER);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
 		hasCallback		= true;
 	}
 
@@ -670,12 +1275,12 @@ Napi::Value ChmpxNode::InitializeOnServer(const Napi::CallbackInfo& info)
 	// Execute
 	if(hasCallback){
 		// Create worker and Queue it
-		InitializeOnWorker* worker = new InitializeOnWorker(maybeCallback, &(obj->_chmcntrl), filename, is_auto_rejoin, true);
-		worker->Queue();
+		InitializeOnWorker* worker = new InitializeOnWorker(env, maybeCallback, obj->_chmcntrl.get(), filename, is_auto_rejoin, true);
+		obj->QueueWorker(worker);
 		return Napi::Boolean::New(env, true);
 	}else{
-		obj->_chmcntrl.Clean();
-		bool result = obj->_chmcntrl.InitializeOnServer(filename.c_str(), is_auto_rejoin);
+		obj->_chmcntrl->Clean();
+		bool result = obj->_chmcntrl->InitializeOnServer(filename.c_str(), is_auto_rejoin);
 		return Napi::Boolean::New(env, result);
 	}
 }
@@ -716,7 +1321,7 @@ Napi::Value ChmpxNode::InitializeOnSlave(const Napi::CallbackInfo& info)
 	}
 
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
@@ -725,9 +1330,9 @@ Napi::Value ChmpxNode::InitializeOnSlave(const Napi::CallbackInfo& info)
 	// initial callback comes from emitter map if set
 	Napi::Function				maybeCallback;
 	bool						hasCallback		= false;
-	Napi::FunctionReference*	emitterCbRef	= obj->_cbs.Find(stc_emitters[EMITTER_POS_INITIALIZEONSLAVE]);
-	if(emitterCbRef){
-		maybeCallback	= emitterCbRef->Value();
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_INITIALIZEONSLAVE);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
 		hasCallback		= true;
 	}
 
@@ -766,12 +1371,12 @@ Napi::Value ChmpxNode::InitializeOnSlave(const Napi::CallbackInfo& info)
 	// Execute
 	if(hasCallback){
 		// Create worker and Queue it
-		InitializeOnWorker* worker = new InitializeOnWorker(maybeCallback, &(obj->_chmcntrl), filename, is_auto_rejoin, false);
-		worker->Queue();
+		InitializeOnWorker* worker = new InitializeOnWorker(env, maybeCallback, obj->_chmcntrl.get(), filename, is_auto_rejoin, false);
+		obj->QueueWorker(worker);
 		return Napi::Boolean::New(env, true);
 	}else{
-		obj->_chmcntrl.Clean();
-		bool result = obj->_chmcntrl.InitializeOnSlave(filename.c_str(), is_auto_rejoin);
+		obj->_chmcntrl->Clean();
+		bool result = obj->_chmcntrl->InitializeOnSlave(filename.c_str(), is_auto_rejoin);
 		return Napi::Boolean::New(env, result);
 	}
 }
@@ -781,7 +1386,7 @@ Napi::Value ChmpxNode::InitializeOnSlave(const Napi::CallbackInfo& info)
  * @fn int\
  * Send(\
  * 	Buffer		msgid\
- * 	, Buffer	body\
+ * 	, Buffer|String|Array	body\
  *	, bool		is_routing=true\
  * 	, Callback cbfunc=null\
  * )
@@ -792,13 +1397,15 @@ Napi::Value ChmpxNode::InitializeOnSlave(const Napi::CallbackInfo& info)
  *  this method works asynchronization and calls callback function at finishing.
  *
  * @param[in] msgid			Specify msgid which is returned by ChmpxNode::Open()
- * @param[in] body			Specify send data
+ * @param[in] body			Specify send data(Buffer, TypedArray, DataView, ArrayBuffer,
+ *							string encoded to UTF-8, or array of them which are
+ *							gathered into one message)
  * @param[in] is_routing	Specify true for sending data with routing automatically
  *							when chmpx type is HASH and replication count is over 1.
  *							Then the data sends multiple chmpx server node.
  * @param[in] cbfunc		callback function.
  *
- * @return	If a callback is set, always return true.
+ * @return	If a callback is set, returns true, or false if maxInFlight is reached(see SetFlowOptions).
  *			Otherwise, returns receiver count or -1 when something error occurred.
  *
  */
@@ -817,7 +1424,7 @@ Napi::Value ChmpxNode::Send(const Napi::CallbackInfo& info)
 	}
 
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
@@ -826,37 +1433,24 @@ Napi::Value ChmpxNode::Send(const Napi::CallbackInfo& info)
 	// initial callback comes from emitter map if set
 	Napi::Function				maybeCallback;
 	bool						hasCallback		= false;
-	Napi::FunctionReference*	emitterCbRef	= obj->_cbs.Find(stc_emitters[EMITTER_POS_SEND]);
-	if(emitterCbRef){
-		maybeCallback	= emitterCbRef->Value();
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_SEND);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
 		hasCallback		= true;
 	}
 
 	// info[0] : msgid Required
-	if(!info[0].IsBuffer()){
-		Napi::TypeError::New(env, "Wrong msgid is specified.").ThrowAsJavaScriptException();
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	ChmpxMsgId*	pmsgidobj	= NULL;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
 		return env.Undefined();
 	}
-	Napi::Buffer<uint8_t>	msgidbuf	= info[0].As<Napi::Buffer<uint8_t>>();
-	size_t					msgidLen	= std::min(msgidbuf.Length(), static_cast<size_t>(sizeof(msgid_t)));
-	msgid_t					msgid		= CHM_INVALID_MSGID;
-	memcpy(&msgid, msgidbuf.Data(), msgidLen);
 
-	// info[1] : data Required
-	if(!info[1].IsBuffer()){
-		Napi::TypeError::New(env, "Wrong send data is specified.").ThrowAsJavaScriptException();
-		return env.Undefined();
-	}
-	Napi::Buffer<unsigned char>	databuf	= info[1].As<Napi::Buffer<unsigned char>>();
-	size_t						dataLen	= databuf.Length();
-	ssize_t						binLen	= static_cast<ssize_t>(dataLen);		// adjust to size_t
-	unsigned char*				pbinptr	= databuf.Data();
-	ChmBinData					bindata;
-	if(!pbinptr && 0 < dataLen){
-		Napi::TypeError::New(env, "Could not access buffer data.").ThrowAsJavaScriptException();
+	// info[1] : data Required(Buffer or array of pieces)
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[1])){
 		return env.Undefined();
 	}
-	bindata.Set(pbinptr, binLen);
 
 	// info[2]
 	bool	is_routing	= true;
@@ -886,12 +1480,16 @@ Napi::Value ChmpxNode::Send(const Napi::CallbackInfo& info)
 	// Execute
 	if(hasCallback){
 		// Create worker and Queue it
-		SendWorker* worker = new SendWorker(maybeCallback, &(obj->_chmcntrl), msgid, pbinptr, binLen, bindata.GetHash(), is_routing);
-		worker->Queue();
-		return Napi::Boolean::New(env, true);
+		SendWorker* worker = new SendWorker(env, maybeCallback, obj->_chmcntrl.get(), msgid, body.Owner(), body.Data(), body.Length(), body.GetHash(), is_routing);
+		worker->DetachBody(body);
+		obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid), pmsgidobj);
+		return Napi::Boolean::New(env, obj->CheckFlow());
 	}else{
+		if(!obj->CheckAccepting(env)){
+			return env.Undefined();
+		}
 		long	recievercnt	= 0;
-		if(!obj->_chmcntrl.Send(msgid, pbinptr, binLen, bindata.GetHash(), &recievercnt, is_routing)){
+		if(!obj->_chmcntrl->Send(msgid, body.Data(), body.Length(), body.GetHash(), &recievercnt, is_routing)){
 			recievercnt = -1;
 		}
 		return Napi::Number::New(env, static_cast<int32_t>(recievercnt));
@@ -903,7 +1501,7 @@ Napi::Value ChmpxNode::Send(const Napi::CallbackInfo& info)
  * @fn int\
  * Broadcast(\
  * 	Buffer		msgid\
- * 	, Buffer	body\
+ * 	, Buffer|String|Array	body\
  * 	, Callback	cbfunc=null\
  * )
  * @brief	Broadcast data from slave node side to all server node side.
@@ -912,10 +1510,12 @@ Napi::Value ChmpxNode::Send(const Napi::CallbackInfo& info)
  *  this method works asynchronization and calls callback function at finishing.
  *
  * @param[in] msgid			Specify msgid which is returned by ChmpxNode::Open()
- * @param[in] body			Specify send data
+ * @param[in] body			Specify send data(Buffer, TypedArray, DataView, ArrayBuffer,
+ *							string encoded to UTF-8, or array of them which are
+ *							gathered into one message)
  * @param[in] cbfunc		callback function.
  *
- * @return	If a callback is set, always return true.
+ * @return	If a callback is set, returns true, or false if maxInFlight is reached(see SetFlowOptions).
  *			Otherwise, returns receiver count or -1 when something error occurred.
  *
  */
@@ -934,7 +1534,7 @@ Napi::Value ChmpxNode::Broadcast(const Napi::CallbackInfo& info)
 	}
 
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
@@ -943,37 +1543,24 @@ Napi::Value ChmpxNode::Broadcast(const Napi::CallbackInfo& info)
 	// initial callback comes from emitter map if set
 	Napi::Function				maybeCallback;
 	bool						hasCallback		= false;
-	Napi::FunctionReference*	emitterCbRef	= obj->_cbs.Find(stc_emitters[EMITTER_POS_BROADCAST]);
-	if(emitterCbRef){
-		maybeCallback	= emitterCbRef->Value();
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_BROADCAST);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
 		hasCallback		= true;
 	}
 
 	// info[0] : msgid Required
-	if(!info[0].IsBuffer()){
-		Napi::TypeError::New(env, "Wrong msgid is specified.").ThrowAsJavaScriptException();
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	ChmpxMsgId*	pmsgidobj	= NULL;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
 		return env.Undefined();
 	}
-	Napi::Buffer<uint8_t>	msgidbuf	= info[0].As<Napi::Buffer<uint8_t>>();
-	size_t					msgidLen	= std::min(msgidbuf.Length(), static_cast<size_t>(sizeof(msgid_t)));
-	msgid_t					msgid		= CHM_INVALID_MSGID;
-	memcpy(&msgid, msgidbuf.Data(), msgidLen);
 
-	// info[1] : data Required
-	if(!info[1].IsBuffer()){
-		Napi::TypeError::New(env, "Wrong send data is specified.").ThrowAsJavaScriptException();
-		return env.Undefined();
-	}
-	Napi::Buffer<unsigned char>	databuf	= info[1].As<Napi::Buffer<unsigned char>>();
-	size_t						dataLen	= databuf.Length();
-	ssize_t						binLen	= static_cast<ssize_t>(dataLen);		// adjust to size_t
-	unsigned char*				pbinptr	= databuf.Data();
-	ChmBinData					bindata;
-	if(!pbinptr && 0 < dataLen){
-		Napi::TypeError::New(env, "Could not access buffer data.").ThrowAsJavaScriptException();
+	// info[1] : data Required(Buffer or array of pieces)
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[1])){
 		return env.Undefined();
 	}
-	bindata.Set(pbinptr, binLen);
 
 	// info[2]
 	if(2 < info.Length()){
@@ -988,24 +1575,329 @@ Napi::Value ChmpxNode::Broadcast(const Napi::CallbackInfo& info)
 	// Execute
 	if(hasCallback){
 		// Create worker and Queue it
-		BroadcastWorker* worker = new BroadcastWorker(maybeCallback, &(obj->_chmcntrl), msgid, pbinptr, binLen, bindata.GetHash());
-		worker->Queue();
-		return Napi::Boolean::New(env, true);
+		BroadcastWorker* worker = new BroadcastWorker(env, maybeCallback, obj->_chmcntrl.get(), msgid, body.Owner(), body.Data(), body.Length(), body.GetHash());
+		worker->DetachBody(body);
+		obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid), pmsgidobj);
+		return Napi::Boolean::New(env, obj->CheckFlow());
+	}else{
+		if(!obj->CheckAccepting(env)){
+			return env.Undefined();
+		}
+		long	recievercnt	= 0;
+		if(!obj->_chmcntrl->Broadcast(msgid, body.Data(), body.Length(), body.GetHash(), &recievercnt)){
+			recievercnt = -1;
+		}
+		return Napi::Number::New(env, static_cast<int32_t>(recievercnt));
+	}
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn int\
+ * SendByKey(\
+ * 	Buffer			msgid\
+ * 	, Buffer|String	key\
+ * 	, Buffer|String|Array	body\
+ *	, bool			is_routing=true\
+ * 	, Callback		cbfunc=null\
+ * )
+ *
+ * @brief	Send data to the server node which is decided by the key.
+ *
+ *	The hash value for routing is calculated from the key instead of the body,
+ *	so the data which have the same key are sent to the same server node.
+ *	If the callback function is specified, or on callback handles for this,
+ *  this method works asynchronization and calls callback function at finishing.
+ *
+ * @param[in] msgid			Specify msgid which is returned by ChmpxNode::Open()
+ * @param[in] key			Specify the key for routing
+ * @param[in] body			Specify send data(same as Send)
+ * @param[in] is_routing	Same as Send
+ * @param[in] cbfunc		callback function.
+ *
+ * @return	If a callback is set, returns true, or false if maxInFlight is reached(see SetFlowOptions).
+ *			Otherwise, returns receiver count or -1 when something error occurred.
+ *
+ */
+
+Napi::Value ChmpxNode::SendByKey(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::SendWithHashCommon(info, true);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn int\
+ * SendWithHash(\
+ * 	Buffer			msgid\
+ * 	, Number|BigInt	hash\
+ * 	, Buffer|String|Array	body\
+ *	, bool			is_routing=true\
+ * 	, Callback		cbfunc=null\
+ * )
+ *
+ * @brief	Send data to the server node which is decided by the hash value.
+ *
+ *	If the callback function is specified, or on callback handles for this,
+ *  this method works asynchronization and calls callback function at finishing.
+ *
+ * @param[in] msgid			Specify msgid which is returned by ChmpxNode::Open()
+ * @param[in] hash			Specify the hash value for routing
+ * @param[in] body			Specify send data(same as Send)
+ * @param[in] is_routing	Same as Send
+ * @param[in] cbfunc		callback function.
+ *
+ * @return	If a callback is set, returns true, or false if maxInFlight is reached(see SetFlowOptions).
+ *			Otherwise, returns receiver count or -1 when something error occurred.
+ *
+ */
+
+Napi::Value ChmpxNode::SendWithHash(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::SendWithHashCommon(info, false);
+}
+
+Napi::Value ChmpxNode::SendWithHashCommon(const Napi::CallbackInfo& info, bool is_key)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No msgid is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(info.Length() < 2){
+		Napi::TypeError::New(env, (is_key ? "No key is specified." : "No hash value is specified.")).ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(info.Length() < 3){
+		Napi::TypeError::New(env, "No send data is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// initial callback comes from emitter map if set
+	Napi::Function				maybeCallback;
+	bool						hasCallback		= false;
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_SEND);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
+		hasCallback		= true;
+	}
+
+	// info[0] : msgid Required
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	ChmpxMsgId*	pmsgidobj	= NULL;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
+		return env.Undefined();
+	}
+
+	// info[1] : key or hash Required
+	chmhash_t	hash = 0;
+	if(is_key){
+		if(!GetChmpxKeyHashParam(env, info[1], hash)){
+			return env.Undefined();
+		}
+	}else{
+		if(!GetChmpxHashParam(env, info[1], hash)){
+			return env.Undefined();
+		}
+	}
+
+	// info[2] : data Required(Buffer or array of pieces)
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[2])){
+		return env.Undefined();
+	}
+
+	// info[3...]
+	bool	is_routing	= true;
+	size_t	pos			= 3;
+	if(pos < info.Length() && !info[pos].IsFunction()){
+		is_routing = info[pos].ToBoolean();
+		++pos;
+	}
+	if(pos < info.Length()){
+		if(!info[pos].IsFunction()){
+			Napi::TypeError::New(env, "Last parameter is not callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if((pos + 1) < info.Length()){
+			Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		maybeCallback	= info[pos].As<Napi::Function>();
+		hasCallback		= true;
+	}
+
+	// Execute
+	if(hasCallback){
+		// Create worker and Queue it
+		SendWorker* worker = new SendWorker(env, maybeCallback, obj->_chmcntrl.get(), msgid, body.Owner(), body.Data(), body.Length(), hash, is_routing);
+		worker->DetachBody(body);
+		obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid), pmsgidobj);
+		return Napi::Boolean::New(env, obj->CheckFlow());
 	}else{
+		if(!obj->CheckAccepting(env)){
+			return env.Undefined();
+		}
 		long	recievercnt	= 0;
-		if(!obj->_chmcntrl.Broadcast(msgid, pbinptr, binLen, bindata.GetHash(), &recievercnt)){
+		if(!obj->_chmcntrl->Send(msgid, body.Data(), body.Length(), hash, &recievercnt, is_routing)){
 			recievercnt = -1;
 		}
 		return Napi::Number::New(env, static_cast<int32_t>(recievercnt));
 	}
 }
 
+/**
+ * @memberof ChmpxNode
+ * @fn Int32Array\
+ * SendBatch(\
+ * 	Buffer		msgid\
+ * 	, Array		bodies\
+ *	, bool		is_routing=true\
+ * 	, Callback	cbfunc=null\
+ * )
+ *
+ * @brief	Send multiple data from slave node side to server node side.
+ *
+ *	Each data in bodies is sent by one call of this method, in order.
+ *	If the callback function is specified, this method works asynchronization
+ *	and calls callback function at finishing.
+ *	The emitter callback(on send) is not used for this method.
+ *
+ * @param[in] msgid			Specify msgid which is returned by ChmpxNode::Open()
+ * @param[in] bodies		Specify the array of send data(each of them is same as the body of Send)
+ * @param[in] is_routing	Specify true for sending data with routing automatically
+ *							when chmpx type is HASH and replication count is over 1.
+ * @param[in] cbfunc		callback function.
+ *
+ * @return	If a callback is set, returns true, or false if maxInFlight is reached(see SetFlowOptions).
+ *			Otherwise, returns Int32Array of receiver count for each data, -1
+ *			means that the data failed to send.
+ *
+ */
+
+Napi::Value ChmpxNode::SendBatch(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::SendBatchCommon(info, false);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Int32Array\
+ * BroadcastBatch(\
+ * 	Buffer		msgid\
+ * 	, Array		bodies\
+ * 	, Callback	cbfunc=null\
+ * )
+ *
+ * @brief	Broadcast multiple data from slave node side to all server node side.
+ *
+ *	Each data in bodies is broadcasted by one call of this method, in order.
+ *	If the callback function is specified, this method works asynchronization
+ *	and calls callback function at finishing.
+ *	The emitter callback(on broadcast) is not used for this method.
+ *
+ * @param[in] msgid			Specify msgid which is returned by ChmpxNode::Open()
+ * @param[in] bodies		Specify the array of send data(each of them is same as the body of Send)
+ * @param[in] cbfunc		callback function.
+ *
+ * @return	If a callback is set, returns true, or false if maxInFlight is reached(see SetFlowOptions).
+ *			Otherwise, returns Int32Array of receiver count for each data, -1
+ *			means that the data failed to broadcast.
+ *
+ */
+
+Napi::Value ChmpxNode::BroadcastBatch(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::SendBatchCommon(info, true);
+}
+
+Napi::Value ChmpxNode::SendBatchCommon(const Napi::CallbackInfo& info, bool is_broadcast)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No msgid is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(info.Length() < 2){
+		Napi::TypeError::New(env, "No send data array is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0] : msgid Required
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	ChmpxMsgId*	pmsgidobj	= NULL;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
+		return env.Undefined();
+	}
+
+	// info[1] : data array Required
+	chmpxsndlist_t	sndlist;
+	Napi::Array		bodies;
+	chmpxsndbufs_t	gathered;
+	if(!GetChmpxBodyListParam(env, info[1], sndlist, bodies, gathered)){
+		return env.Undefined();
+	}
+
+	// info[2...]
+	Napi::Function	maybeCallback;
+	bool			hasCallback	= false;
+	bool			is_routing	= true;
+	size_t			pos			= 2;
+	if(!is_broadcast && pos < info.Length() && !info[pos].IsFunction()){
+		is_routing = info[pos].ToBoolean();
+		++pos;
+	}
+	if(pos < info.Length()){
+		if(!info[pos].IsFunction()){
+			Napi::TypeError::New(env, "Last parameter is not callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if((pos + 1) < info.Length()){
+			Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		maybeCallback	= info[pos].As<Napi::Function>();
+		hasCallback		= true;
+	}
+
+	// Execute
+	if(hasCallback){
+		// Create worker and Queue it
+		SendBatchWorker* worker = new SendBatchWorker(env, maybeCallback, obj->_chmcntrl.get(), msgid, sndlist, bodies, is_broadcast, is_routing);
+		worker->DetachBodies(gathered);
+		obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid), pmsgidobj);
+		return Napi::Boolean::New(env, obj->CheckFlow());
+	}else{
+		if(!obj->CheckAccepting(env)){
+			return env.Undefined();
+		}
+		chmpxsndcnts_t	counts;
+		ChmpxSendDataList(obj->_chmcntrl.get(), msgid, sndlist, is_broadcast, is_routing, counts);
+		return ChmpxSendCountsToArray(env, counts);
+	}
+}
+
 /**
  * @memberof ChmpxNode
  * @fn bool\
  * Reply(\
  * 	Buffer		ComPkt\
- * 	, Buffer	body\
+ * 	, Buffer|String|Array	body\
  * 	, Callback cbfunc=null\
  * )
  * @brief	Reply data from server node side to slave node side.
@@ -1014,7 +1906,9 @@ Napi::Value ChmpxNode::Broadcast(const Napi::CallbackInfo& info)
  *  this method works asynchronization and calls callback function at finishing.
  *
  * @param[in] ComPkt		Specify ComPkt which is received at ChmpxNode::Receive()
- * @param[in] body			Specify reply data
+ * @param[in] body			Specify reply data(Buffer, TypedArray, DataView, ArrayBuffer,
+ *							string encoded to UTF-8, or array of them which are
+ *							gathered into one message)
  * @param[in] cbfunc		callback function.
  *
  * @return	Return true for success, false for failure
@@ -1034,7 +1928,7 @@ Napi::Value ChmpxNode::Reply(const Napi::CallbackInfo& info)
 	}
 
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
@@ -1043,48 +1937,33 @@ Napi::Value ChmpxNode::Reply(const Napi::CallbackInfo& info)
 	// initial callback comes from emitter map if set
 	Napi::Function				maybeCallback;
 	bool						hasCallback		= false;
-	Napi::FunctionReference*	emitterCbRef	= obj->_cbs.Find(stc_emitters[EMITTER_POS_REPLY]);
-	if(emitterCbRef){
-		maybeCallback	= emitterCbRef->Value();
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_REPLY);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
 		hasCallback		= true;
 	}
 
-	// info[0] : compkt Required
-	if(!info[0].IsBuffer()){
-		Napi::TypeError::New(env, "Wrong compkt is specified.").ThrowAsJavaScriptException();
-		return env.Undefined();
-	}
-	Napi::Buffer<unsigned char>	pktBuf	= info[0].As<Napi::Buffer<unsigned char>>();
-	size_t						pktLen	= pktBuf.Length();
-	const unsigned char*		pktptr	= pktBuf.Data();
-	size_t						pktSize	= sizeof(COMPKT);
-	size_t						copyLen	= std::min(pktLen, pktSize);
-	COMPKT						compkt;
-
-	if(!pktptr && 0 < pktLen){
-		Napi::TypeError::New(env, "Could not access compkt.").ThrowAsJavaScriptException();
+	// info[0] : compkt Required(compkt of a request has request header)
+	COMPKT		compkt;
+	bool		has_reqid	= false;
+	uint64_t	reqid		= 0;
+	if(!GetChmpxComPktParam(env, info[0], compkt, has_reqid, reqid)){
 		return env.Undefined();
 	}
-	memset(&compkt, 0, pktSize);
-	if(0 < copyLen){
-		memcpy(reinterpret_cast<char*>(&compkt), pktptr, copyLen);
-	}
 
-	// info[1] : data Required
-	if(!info[1].IsBuffer()){
-		Napi::TypeError::New(env, "Wrong send data is specified.").ThrowAsJavaScriptException();
+	// info[1] : data Required(Buffer or array of pieces)
+	//
+	// [NOTE]
+	// The reply for the request has the request header in front of the
+	// body, so the body is gathered after the headroom for it.
+	//
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[1], (has_reqid ? CHMPX_REQHDR_SIZE : 0))){
 		return env.Undefined();
 	}
-	Napi::Buffer<unsigned char>	databuf	= info[1].As<Napi::Buffer<unsigned char>>();
-	size_t						dataLen	= databuf.Length();
-	ssize_t						binLen	= static_cast<ssize_t>(dataLen);		// adjust to size_t
-	unsigned char*				pbinptr	= databuf.Data();
-	ChmBinData					bindata;
-	if(!pbinptr && 0 < dataLen){
-		Napi::TypeError::New(env, "Could not access buffer data.").ThrowAsJavaScriptException();
-		return env.Undefined();
+	if(has_reqid){
+		ChmpxSetReqHeader(body.Data(), reqid);
 	}
-	bindata.Set(pbinptr, binLen);
 
 	// info[2]
 	if(2 < info.Length()){
@@ -1099,12 +1978,15 @@ Napi::Value ChmpxNode::Reply(const Napi::CallbackInfo& info)
 	// Execute
 	if(hasCallback){
 		// Create worker and Queue it
-		ReplyWorker* worker = new ReplyWorker(maybeCallback, &(obj->_chmcntrl), &compkt, pbinptr, binLen);
-		worker->Queue();
+		ReplyWorker* worker = new ReplyWorker(env, maybeCallback, obj->_chmcntrl.get(), &compkt, body.Owner(), body.Data(), body.Length());
+		worker->DetachBody(body);
+		obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_REPLY, CHM_INVALID_MSGID));
 		return Napi::Boolean::New(env, true);
 	}else{
-		bool result = obj->_chmcntrl.Reply(&compkt, pbinptr, binLen);
-		return Napi::Boolean::New(env, result);
+		if(!obj->CheckAccepting(env)){
+			return env.Undefined();
+		}
+		return Napi::Boolean::New(env, obj->_chmcntrl->Reply(&compkt, body.Data(), body.Length()));
 	}
 }
 
@@ -1113,6 +1995,10 @@ Napi::Value ChmpxNode::Reply(const Napi::CallbackInfo& info)
  * One of type is for joining on server, the other type is for joining on slave.
  * Each type has two pattern for without callback and with callback
  *
+ * The asynchronous pattern allows AbortSignal as the last parameter.
+ * If the signal is aborted, the waiting is stopped(in ABORT_SLICE_MS)
+ * and the callback is called with the abort error.
+ *
  *****************************************************************
  * On server node
  *****************************************************************
@@ -1206,28 +2092,40 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 	Napi::Env env = info.Env();
 
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
 	ChmpxNode*	obj = Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
 
+	// [NOTE]
+	// AbortSignal is allowed as the last parameter, and it is taken
+	// out before parsing the other parameters.
+	//
+	size_t		argc			= info.Length();
+	Napi::Value	signal;
+	if(0 < argc && ChmpxAbortWatcher::IsSignal(info[argc - 1])){
+		signal = info[argc - 1];
+		--argc;
+	}
+
 	// [NOTE]
 	// Here the Emitter is detected, but it is not yet determined whether
 	// to invoke the Callback.
 	//
 	Napi::Function				maybeCallback;
 	bool						hasCallback		= false;
-	Napi::FunctionReference*	emitterCbRef	= obj->_cbs.Find(stc_emitters[EMITTER_POS_RECEIVE]);
-	if(emitterCbRef){
-		maybeCallback	= emitterCbRef->Value();
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_RECEIVE);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
 		hasCallback		= true;
 	}
 
 	// common variables
-	bool			is_on_server	= obj->_chmcntrl.IsClientOnSvrType();
+	bool			is_on_server	= obj->_chmcntrl->IsClientOnSvrType();
 	Napi::Array		rcvarr;
 	msgid_t			msgid			= CHM_INVALID_MSGID;			// only on slave type
+	ChmpxMsgId*		pmsgidobj		= NULL;							// only on slave type
 	int				timeout_ms		= 0;
 	bool			no_giveup_rejoin= false;						// only on server type
 
@@ -1239,7 +2137,7 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 		// on server type
 		//---------------------------------------------
 		bool	precheck_callback = false;
-		if(info.Length() < 1){
+		if(argc < 1){
 			precheck_callback = true;
 		}else{
 			if(!info[0].IsArray()){
@@ -1255,14 +2153,14 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 			rcvarr = info[0].As<Napi::Array>();
 
 			// info[1]
-			if(1 < info.Length()){
+			if(1 < argc){
 				if(!info[1].IsBoolean()){
 					// info[1] = timeout ms
 					timeout_ms = info[1].ToNumber().Int32Value();
 
-					if(2 < info.Length()){
+					if(2 < argc){
 						// info[2] = no giveup flag
-						if(3 < info.Length()){
+						if(3 < argc){
 							Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
 							return env.Undefined();
 						}
@@ -1274,7 +2172,7 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 					}
 				}else{
 					// info[1] = no giveup flag
-					if(2 < info.Length()){
+					if(2 < argc){
 						Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
 						return env.Undefined();
 					}
@@ -1284,14 +2182,14 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 
 		}else{
 			// Asynchronous (allow callback)
-			if(0 < info.Length()){
+			if(0 < argc){
 				if(info[0].IsBoolean()){
 					// info[0] = no giveup flag
 					no_giveup_rejoin = info[0].ToBoolean();
 
-					if(1 < info.Length()){
+					if(1 < argc){
 						// info[1] = callback function
-						if(2 < info.Length()){
+						if(2 < argc){
 							Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
 							return env.Undefined();
 						}
@@ -1305,7 +2203,7 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 
 				}else if(info[0].IsFunction()){
 					// info[0] = callback function
-					if(1 < info.Length()){
+					if(1 < argc){
 						Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
 						return env.Undefined();
 					}
@@ -1316,14 +2214,14 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 					// info[0] = timeout ms
 					timeout_ms = info[0].ToNumber().Int32Value();
 
-					if(1 < info.Length()){
+					if(1 < argc){
 						if(info[1].IsBoolean()){
 							// info[1] = no giveup flag
 							no_giveup_rejoin = info[1].ToBoolean();
 
-							if(2 < info.Length()){
+							if(2 < argc){
 								// info[2] = callback function
-								if(3 < info.Length()){
+								if(3 < argc){
 									Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
 									return env.Undefined();
 								}
@@ -1337,7 +2235,7 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 
 						}else if(info[1].IsFunction()){
 							// info[1] = callback function
-							if(2 < info.Length()){
+							if(2 < argc){
 								Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
 								return env.Undefined();
 							}
@@ -1361,17 +2259,17 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 		// on slave type
 		//---------------------------------------------
 		// info[0] : msgid Required
-		if(info.Length() < 1 || !info[0].IsBuffer()){
+		if(argc < 1){
 			Napi::TypeError::New(env, "Wrong msgid is specified.").ThrowAsJavaScriptException();
 			return env.Undefined();
 		}
-		Napi::Buffer<uint8_t>	msgidbuf = info[0].As<Napi::Buffer<uint8_t>>();
-		size_t					msgidLen = std::min(msgidbuf.Length(), static_cast<size_t>(sizeof(msgid_t)));
-		memcpy(&msgid, msgidbuf.Data(), msgidLen);
+		if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
+			return env.Undefined();
+		}
 
 		// precheck parameter whichever callback
 		bool	precheck_callback = false;
-		if(info.Length() < 2){
+		if(argc < 2){
 			precheck_callback = true;
 		}else{
 			if(!info[1].IsArray()){
@@ -1386,9 +2284,9 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 			// info[1] = receive data array
 			rcvarr = info[1].As<Napi::Array>();
 
-			if(2 < info.Length()){
+			if(2 < argc){
 				// info[2] = timeout ms
-				if(3 < info.Length()){
+				if(3 < argc){
 					Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
 					return env.Undefined();
 				}
@@ -1397,14 +2295,14 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 
 		}else{
 			// Asynchronous (allow callback)
-			if(1 < info.Length()){
+			if(1 < argc){
 				if(!info[1].IsFunction()){
 					// info[1] = timeout ms
 					timeout_ms = info[1].ToNumber().Int32Value();
 
-					if(2 < info.Length()){
+					if(2 < argc){
 						// info[2] = callback function
-						if(3 < info.Length()){
+						if(3 < argc){
 							Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
 							return env.Undefined();
 						}
@@ -1417,7 +2315,7 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 					}
 				}else{
 					// info[1] = callback function
-					if(2 < info.Length()){
+					if(2 < argc){
 						Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
 						return env.Undefined();
 					}
@@ -1435,15 +2333,25 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 	// Execute
 	if(hasCallback){
 		// Create worker and Queue it
+		ReceiveWorker*	worker;
 		if(is_on_server){
-			ReceiveWorker* worker = new ReceiveWorker(maybeCallback, &(obj->_chmcntrl), timeout_ms, no_giveup_rejoin);
-			worker->Queue();
+			worker = new ReceiveWorker(env, maybeCallback, obj->_chmcntrl.get(), timeout_ms, no_giveup_rejoin, obj->RcvBodyType());
 		}else{
-			ReceiveWorker* worker = new ReceiveWorker(maybeCallback, &(obj->_chmcntrl), msgid, timeout_ms);
-			worker->Queue();
+			worker = new ReceiveWorker(env, maybeCallback, obj->_chmcntrl.get(), msgid, timeout_ms, obj->RcvBodyType());
+		}
+		if(!signal.IsEmpty()){
+			worker->SetAbortSignal(signal);
 		}
+		obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_RECEIVE, (is_on_server ? CHM_INVALID_MSGID : msgid)), pmsgidobj);
 		return Napi::Boolean::New(env, true);
 	}else{
+		if(!obj->CheckAccepting(env)){
+			return env.Undefined();
+		}
+		if(!signal.IsEmpty()){
+			Napi::TypeError::New(env, "AbortSignal is allowed only for asynchronous receiving.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
 		PCOMPKT			pComPkt	= nullptr;
 		unsigned char*	pBody	= nullptr;
 		size_t			Length	= 0;
@@ -1451,26 +2359,25 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 
 		// receive
 		if(is_on_server){
-			result = obj->_chmcntrl.Receive(&pComPkt, &pBody, &Length, timeout_ms, no_giveup_rejoin);
+			result = obj->_chmcntrl->Receive(&pComPkt, &pBody, &Length, timeout_ms, no_giveup_rejoin);
 		}else{
-			result = obj->_chmcntrl.Receive(msgid, &pComPkt, &pBody, &Length, timeout_ms);
+			result = obj->_chmcntrl->Receive(msgid, &pComPkt, &pBody, &Length, timeout_ms);
 		}
 		// set result data to array
 		if(!pComPkt && result){
 			result = false;			// maybe timeouted
 		}
 		if(result){
+			// strip request header from body
+			uint64_t	reqid		= 0;
+			bool		has_reqid	= (is_on_server && obj->_chmcntrl->IsReqHeader() && ChmpxStripReqHeader(pBody, Length, reqid));
+
 			// set COMPKT to array[0]
-			Napi::Value	pktBuf = Napi::Buffer<char>::Copy(env, reinterpret_cast<char*>(pComPkt), static_cast<size_t>(sizeof(COMPKT)));
+			Napi::Value	pktBuf = ChmpxCreatePktBuffer(env, pComPkt, has_reqid, reqid);
 			rcvarr.Set(static_cast<uint32_t>(0), pktBuf);
 
 			// set body to array[1]
-			Napi::Value bodyBuf;
-			if(pBody && 0 < Length){
-				bodyBuf = Napi::Buffer<unsigned char>::Copy(env, reinterpret_cast<unsigned char*>(pBody), static_cast<size_t>(Length));
-			}else{
-				bodyBuf = Napi::Buffer<unsigned char>::New(env, 0);
-			}
+			Napi::Value bodyBuf = ChmpxCreateBodyBuffer(env, pBody, Length, obj->RcvBodyType());		// pBody is set null if the ownership is moved
 			rcvarr.Set(static_cast<uint32_t>(1), bodyBuf);
 		}
 		CHM_Free(pComPkt);
@@ -1481,44 +2388,257 @@ Napi::Value ChmpxNode::Receive(const Napi::CallbackInfo& info)
 }
 
 /**
+ * This ReceiveBatch method allows two type arguments.
+ * One of type is for joining on server, the other type is for joining on slave.
+ * Each type has two pattern for without callback and with callback
+ *
+ * The asynchronous pattern allows AbortSignal as the last parameter.
+ * If the signal is aborted, the waiting is stopped(in ABORT_SLICE_MS)
+ * and the callback is called with the abort error.
+ *
+ *****************************************************************
+ * On server node
+ *****************************************************************
  * @memberof ChmpxNode
- * @fn Buffer\
- * Open(\
- * 	bool no_giveup_rejoin=false\
+ * @fn Array\
+ * ReceiveBatch(\
+ * 	int maxcount\
+ * 	, int timeout_ms=0\
+ * 	, bool no_giveup_rejoin=false\
  * 	, Callback cbfunc=null\
  * )
- * @brief	Open the message handle(msgid) on slave node.
+ * @brief	Receive multiple data on server node
  *
- *	You can specify the flag whichever it waits for up coming chmpx process
- *	after chmpx process is down.
- *	If the callback function is specified, or on callback handles for this,
- *  this method works asynchronization and calls callback function at finishing.
+ *	Receive data up to maxcount at once, only the first receiving waits for
+ *	timeout_ms and the following receiving returns only the data which have
+ *	already been queued.
+ *	The received data is returned as Array, each element is Array which has
+ *	ComPkt structure(Buffer) and received data(Buffer).
+ *	If the callback function is specified, this method works asynchronization
+ *	and calls callback function at finishing.
  *
+ * @param[in] maxcount			Specify maximum count of receiving data.
+ * @param[in] timeout_ms		Specify timeout ms for receiving.
  * @param[in] no_giveup_rejoin	Specify true for that upper limit for rejoin chmpx when
  *								chmpx is down is ignored.
  * @param[in] cbfunc			callback function.
  *
  * @return	If a callback is set, always return true.
- *			Otherwise, returns msgid which is opened but if something error occurred, returns null.
- */
-
-Napi::Value ChmpxNode::Open(const Napi::CallbackInfo& info)
-{
-	Napi::Env env = info.Env();
-
-	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
-		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
-		return env.Undefined();
-	}
-	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
-
-	// initial callback comes from emitter map if set
+ *			Otherwise, returns Array of received data(it is empty when timeouted),
+ *			or null when failed to receive before getting any data.
+ *
+ *****************************************************************
+ * On slave node
+ *****************************************************************
+ * @memberof ChmpxNode
+ * @fn Array\
+ * ReceiveBatch(\
+ * 	Buffer	msgid\
+ * 	, int	maxcount\
+ * 	, int	timeout_ms=0\
+ * 	, Callback cbfunc=null\
+ * )
+ * @brief	Receive multiple data on slave node
+ *
+ *	Receive data up to maxcount at once, only the first receiving waits for
+ *	timeout_ms and the following receiving returns only the data which have
+ *	already been queued.
+ *	If the callback function is specified, this method works asynchronization
+ *	and calls callback function at finishing.
+ *
+ * @param[in] msgid				Specify msgid which is received from ChmpxNode::Open()
+ * @param[in] maxcount			Specify maximum count of receiving data.
+ * @param[in] timeout_ms		Specify timeout ms for receiving.
+ * @param[in] cbfunc			callback function.
+ *
+ * @return	If a callback is set, always return true.
+ *			Otherwise, returns Array of received data(it is empty when timeouted),
+ *			or null when failed to receive before getting any data.
+ *
+ */
+
+Napi::Value ChmpxNode::ReceiveBatch(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj = Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// [NOTE]
+	// AbortSignal is allowed as the last parameter, and it is taken
+	// out before parsing the other parameters.
+	//
+	size_t		argc			= info.Length();
+	Napi::Value	signal;
+	if(0 < argc && ChmpxAbortWatcher::IsSignal(info[argc - 1])){
+		signal = info[argc - 1];
+		--argc;
+	}
+
+	// common variables
+	Napi::Function	maybeCallback;
+	bool			hasCallback		= false;
+	bool			is_on_server	= obj->_chmcntrl->IsClientOnSvrType();
+	msgid_t			msgid			= CHM_INVALID_MSGID;			// only on slave type
+	ChmpxMsgId*		pmsgidobj		= NULL;							// only on slave type
+	int				timeout_ms		= 0;
+	bool			no_giveup_rejoin= false;						// only on server type
+	size_t			pos				= 0;
+
+	if(!is_on_server){
+		// info[0] : msgid Required
+		if(argc < 1){
+			Napi::TypeError::New(env, "Wrong msgid is specified.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
+			return env.Undefined();
+		}
+		++pos;
+	}
+
+	// max count : Required
+	if(argc <= pos || !info[pos].IsNumber()){
+		Napi::TypeError::New(env, "No maximum count is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	int32_t	maxcount = info[pos].ToNumber().Int32Value();
+	if(maxcount <= 0){
+		Napi::RangeError::New(env, "Maximum count must be greater than 0.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	++pos;
+
+	// timeout ms
+	if(pos < argc && !info[pos].IsFunction() && !info[pos].IsBoolean()){
+		timeout_ms = info[pos].ToNumber().Int32Value();
+		++pos;
+	}
+
+	// no giveup flag(only on server type)
+	if(is_on_server && pos < argc && info[pos].IsBoolean()){
+		no_giveup_rejoin = info[pos].ToBoolean();
+		++pos;
+	}
+
+	// callback function
+	if(pos < argc){
+		if(!info[pos].IsFunction()){
+			Napi::TypeError::New(env, "Unknown parameter is specified for callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if((pos + 1) < argc){
+			Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		maybeCallback	= info[pos].As<Napi::Function>();
+		hasCallback		= true;
+	}
+
+	// Execute
+	if(hasCallback){
+		// Create worker and Queue it
+		ReceiveBatchWorker*	worker;
+		if(is_on_server){
+			worker = new ReceiveBatchWorker(env, maybeCallback, obj->_chmcntrl.get(), static_cast<size_t>(maxcount), timeout_ms, no_giveup_rejoin, obj->RcvBodyType());
+		}else{
+			worker = new ReceiveBatchWorker(env, maybeCallback, obj->_chmcntrl.get(), msgid, static_cast<size_t>(maxcount), timeout_ms, obj->RcvBodyType());
+		}
+		if(!signal.IsEmpty()){
+			worker->SetAbortSignal(signal);
+		}
+		obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_RECEIVE, (is_on_server ? CHM_INVALID_MSGID : msgid)), pmsgidobj);
+		return Napi::Boolean::New(env, true);
+	}else{
+		if(!obj->CheckAccepting(env)){
+			return env.Undefined();
+		}
+		if(!signal.IsEmpty()){
+			Napi::TypeError::New(env, "AbortSignal is allowed only for asynchronous receiving.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		chmpxrcvlist_t	rcvlist;
+		if(!ChmpxReceiveDataList(obj->_chmcntrl.get(), is_on_server, msgid, static_cast<size_t>(maxcount), timeout_ms, no_giveup_rejoin, rcvlist)){
+			return env.Null();
+		}
+		return ChmpxRcvDataListToArray(env, rcvlist, obj->RcvBodyType());
+	}
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Buffer\
+ * Open(\
+ * 	bool no_giveup_rejoin=false\
+ * 	, Callback cbfunc=null\
+ * )
+ * @brief	Open the message handle(msgid) on slave node.
+ *
+ *	You can specify the flag whichever it waits for up coming chmpx process
+ *	after chmpx process is down.
+ *	If the callback function is specified, or on callback handles for this,
+ *  this method works asynchronization and calls callback function at finishing.
+ *
+ * @param[in] no_giveup_rejoin	Specify true for that upper limit for rejoin chmpx when
+ *								chmpx is down is ignored.
+ * @param[in] cbfunc			callback function.
+ *
+ * @return	If a callback is set, always return true.
+ *			Otherwise, returns msgid which is opened but if something error occurred, returns null.
+ */
+
+Napi::Value ChmpxNode::Open(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::OpenCommon(info, false);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn ChmpxMsgId\
+ * OpenMsgId(\
+ * 	bool no_giveup_rejoin=false\
+ * 	, Callback cbfunc=null\
+ * )
+ * @brief	Open the message handle(msgid) on slave node, and return it as ChmpxMsgId.
+ *
+ *	This works as same as Open, but returns ChmpxMsgId handle instead of
+ *	msgid Buffer. The methods which take msgid accept the handle without
+ *	validating and copying the Buffer on each call.
+ *
+ * @param[in] no_giveup_rejoin	Specify true for that upper limit for rejoin chmpx when
+ *								chmpx is down is ignored.
+ * @param[in] cbfunc			callback function.
+ *
+ * @return	If a callback is set, always return true.
+ *			Otherwise, returns ChmpxMsgId which is opened but if something error occurred, returns null.
+ */
+
+Napi::Value ChmpxNode::OpenMsgId(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::OpenCommon(info, true);
+}
+
+Napi::Value ChmpxNode::OpenCommon(const Napi::CallbackInfo& info, bool is_handle)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// initial callback comes from emitter map if set
 	Napi::Function				maybeCallback;
 	bool						hasCallback		= false;
-	Napi::FunctionReference*	emitterCbRef	= obj->_cbs.Find(stc_emitters[EMITTER_POS_OPEN]);
-	if(emitterCbRef){
-		maybeCallback	= emitterCbRef->Value();
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_OPEN);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
 		hasCallback		= true;
 	}
 
@@ -1547,21 +2667,24 @@ Napi::Value ChmpxNode::Open(const Napi::CallbackInfo& info)
 			Napi::TypeError::New(env, "Last parameter is not callback function.").ThrowAsJavaScriptException();
 			return env.Undefined();
 		}
-		maybeCallback	= info[0].As<Napi::Function>();
+		maybeCallback	= info[1].As<Napi::Function>();
 		hasCallback		= true;
 	}
 
 	// Execute
 	if(hasCallback){
 		// Create worker and Queue it
-		OpenWorker* worker = new OpenWorker(maybeCallback, &(obj->_chmcntrl), no_giveup_rejoin);
-		worker->Queue();
+		OpenWorker* worker = new OpenWorker(env, maybeCallback, obj->_chmcntrl.get(), no_giveup_rejoin, is_handle);
+		obj->QueueWorker(worker);
 		return Napi::Boolean::New(env, true);
 	}else{
-		msgid_t	msgid = obj->_chmcntrl.Open(no_giveup_rejoin);
+		msgid_t	msgid = obj->_chmcntrl->Open(no_giveup_rejoin);
 		if(CHM_INVALID_MSGID == msgid){
 			return env.Null();
 		}
+		if(is_handle){
+			return ChmpxMsgId::NewInstance(env, msgid, obj->_chmcntrl.get());
+		}
 	    return Napi::Buffer<uint8_t>::Copy(env, reinterpret_cast<uint8_t*>(&msgid), static_cast<size_t>(sizeof(msgid_t)));
 	}
 }
@@ -1581,7 +2704,7 @@ Napi::Value ChmpxNode::Open(const Napi::CallbackInfo& info)
  * @param[in] msgid		Specify msgid which is returned ChmpxNode::Open()
  * @param[in] cbfunc			callback function.
  *
- * @return	If a callback is set, always return true.
+ * @return	If a callback is set, returns true, or false if maxInFlight is reached(see SetFlowOptions).
  *			Otherwise, returns success(true) or failure(false).
  *
  */
@@ -1597,7 +2720,7 @@ Napi::Value ChmpxNode::Close(const Napi::CallbackInfo& info)
 	}
 
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
@@ -1606,21 +2729,18 @@ Napi::Value ChmpxNode::Close(const Napi::CallbackInfo& info)
 	// initial callback comes from emitter map if set
 	Napi::Function				maybeCallback;
 	bool						hasCallback		= false;
-	Napi::FunctionReference*	emitterCbRef	= obj->_cbs.Find(stc_emitters[EMITTER_POS_CLOSE]);
-	if(emitterCbRef){
-		maybeCallback	= emitterCbRef->Value();
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_CLOSE);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
 		hasCallback		= true;
 	}
 
 	// info[0] : msgid Required
-	if(!info[0].IsBuffer()){
-		Napi::TypeError::New(env, "Wrong msgid is specified.").ThrowAsJavaScriptException();
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	ChmpxMsgId*	pmsgidobj	= NULL;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
 		return env.Undefined();
 	}
-	Napi::Buffer<uint8_t>	msgidbuf	= info[0].As<Napi::Buffer<uint8_t>>();
-	size_t					msgidLen	= std::min(msgidbuf.Length(), static_cast<size_t>(sizeof(msgid_t)));
-	msgid_t					msgid		= CHM_INVALID_MSGID;
-	memcpy(&msgid, msgidbuf.Data(), msgidLen);
 
 	// info[1]
 	if(1 < info.Length()){
@@ -1636,39 +2756,1923 @@ Napi::Value ChmpxNode::Close(const Napi::CallbackInfo& info)
 		hasCallback		= true;
 	}
 
+	// stop receiving replies for requests on the msgid
+	// [NOTE]
+	// The thread must exit before closing the msgid, otherwise it may
+	// take the replies of the next opener when chmpx reuses the msgid.
+	// The async close waits for it off JS thread. The sync close waits
+	// for it here, the receiving is aborted by the stop request, so it
+	// is ABORT_SLICE_MS at most.
+	//
+	ChmpxRequestChannelPtr	channel = obj->_requester->Remove(env, msgid);
+	if(pmsgidobj){
+		pmsgidobj->SetClosed();
+	}
+
 	// Execute
 	if(hasCallback){
 		// Create worker and Queue it
-		CloseWorker* worker = new CloseWorker(maybeCallback, &(obj->_chmcntrl), msgid);
-		worker->Queue();
-		return Napi::Boolean::New(env, true);
+		CloseWorker* worker = new CloseWorker(env, maybeCallback, obj->_chmcntrl.get(), msgid, channel);
+		obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid), pmsgidobj);
+		return Napi::Boolean::New(env, obj->CheckFlow());
 	}else{
-		bool result = obj->_chmcntrl.Close(msgid);
+		if(channel){
+			channel->Wait();
+		}
+		bool result = obj->_chmcntrl->Close(msgid);
 		return Napi::Boolean::New(env, result);
 	}
 }
 
 /**
  * @memberof ChmpxNode
- * @fn bool isChmpxExit()
- * @brief	Check the chmpx process's status(running or exit)
+ * @fn ChmpxSendRing\
+ * OpenSendRing(\
+ * 	Buffer	msgid\
+ * 	, Object options=null\
+ * )
+ * @brief	Open the send ring for msgid on slave node.
+ *
+ *	The send ring is the single producer/single consumer ring buffer in a
+ *	SharedArrayBuffer. push() of the ring writes the body(and the hash) into
+ *	it in JS without calling this module, and one dedicated thread sends
+ *	them to msgid in the written order. The thread is woken by notify()
+ *	only when it is waiting for the data.
+ *	The options object can have the following keys.
+ *		size		: The byte size of the data area, it is rounded up to the
+ *					  power of 2 in 4KB to 1GB(default 1MB).
+ *		routing		: Specify routing mode of Send(default true).
+ *
+ * @param[in] msgid				Specify msgid which is received from ChmpxNode::Open()
+ * @param[in] options			Specify the options object
+ *
+ * @return	Returns the ChmpxSendRing object.
+ *
+ * [NOTE]
+ * The results of each send are not reported, the ring counts the sent and
+ * failed records. The ring is closed by close(), or when this object is
+ * destroyed or drained.
  *
- * @return	Returns true as chmpx process is running, false means chmpx process does not exist.
  */
 
-Napi::Value ChmpxNode::IsChmpxExit(const Napi::CallbackInfo& info)
+Napi::Value ChmpxNode::OpenSendRing(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj = Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0] : msgid Required
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	size_t		size		= ChmpxSendRingSender::DEFAULT_CAPACITY;
+	bool		is_routing	= true;
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "Wrong msgid is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	if(!GetChmpxMsgIdParam(env, info[0], msgid)){
+		return env.Undefined();
+	}
+
+	// info[1] : options
+	if(1 < info.Length() && !info[1].IsUndefined() && !info[1].IsNull()){
+		if(!info[1].IsObject()){
+			Napi::TypeError::New(env, "The options parameter must be an object.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		Napi::Object	options = info[1].As<Napi::Object>();
+
+		if(options.Has("size")){
+			Napi::Value	value = options.Get("size");
+			if(!value.IsNumber() || value.As<Napi::Number>().Int64Value() < 1 || static_cast<int64_t>(ChmpxSendRingSender::MAX_CAPACITY) < value.As<Napi::Number>().Int64Value()){
+				Napi::TypeError::New(env, "The size option must be a number(1 to 1GB).").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+			size = static_cast<size_t>(value.As<Napi::Number>().Int64Value());
+		}
+		if(options.Has("routing")){
+			is_routing = options.Get("routing").ToBoolean();
+		}
+	}
+	if(2 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// not open while draining
+	if(obj->_draining){
+		Napi::Error::New(env, "The object is draining, new operations are not accepted.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	return ChmpxSendRing::NewInstance(env, info.This().As<Napi::Object>(), obj->_chmcntrl.get(), obj->_threads, msgid, is_routing, ChmpxSendRingSender::GetCapacity(size));
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn ChmpxMsgPool\
+ * OpenPool(\
+ * 	int		count\
+ * 	, bool	no_giveup_rejoin=false\
+ * 	, Callback cbfunc=null\
+ * )
+ * @brief	Open the msgids concurrently and return the pool of them on slave node.
+ *
+ *	The pool sends the data or the request on the least busy msgid, so
+ *	one slave client can use some MQs(up to MAXMQPERCLIENT) in parallel.
+ *	If the callback function is specified, this method works asynchronization
+ *	and calls callback function at finishing.
+ *
+ * @param[in] count				Specify the count of msgids(1 to 256)
+ * @param[in] no_giveup_rejoin	Specify true for that upper limit for rejoin chmpx when
+ *								chmpx is down is ignored.
+ * @param[in] cbfunc			callback function.
+ *
+ * @return	If a callback is set, always return true.
+ *			Otherwise, returns the ChmpxMsgPool object, but if something error occurred(all
+ *			msgids which are opened are closed), returns null.
+ */
+
+Napi::Value ChmpxNode::OpenPool(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No count is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
 	// Unwrap
-	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::constructor.Value())){
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
 		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
 		return env.Undefined();
 	}
 	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
 
-	bool result = obj->_chmcntrl.IsChmpxExit();
-	return Napi::Boolean::New(env, result);
+	// info[0] : count Required
+	if(!info[0].IsNumber()){
+		Napi::TypeError::New(env, "Wrong count is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	int64_t	count = info[0].ToNumber().Int64Value();
+	if(count < 1 || static_cast<int64_t>(ChmpxMsgPool::MAX_COUNT) < count){
+		Napi::RangeError::New(env, "The count is out of range.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// info[1]
+	Napi::Function	maybeCallback;
+	bool			hasCallback		= false;
+	bool			no_giveup_rejoin= false;
+	if(1 < info.Length()){
+		if(info[1].IsFunction()){
+			if(2 < info.Length()){
+				Napi::TypeError::New(env, "Last parameter is not callback function.").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+			maybeCallback	= info[1].As<Napi::Function>();
+			hasCallback		= true;
+		}else{
+			no_giveup_rejoin= info[1].ToBoolean();
+		}
+	}
+
+	// info[2]
+	if(2 < info.Length()){
+		if(3 < info.Length() || !info[2].IsFunction()){
+			Napi::TypeError::New(env, "Last parameter is not callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		maybeCallback	= info[2].As<Napi::Function>();
+		hasCallback		= true;
+	}
+
+	// Execute
+	if(hasCallback){
+		// Create worker and Queue it
+		OpenPoolWorker* worker = new OpenPoolWorker(env, maybeCallback, obj->_chmcntrl.get(), info.This().As<Napi::Object>(), static_cast<size_t>(count), no_giveup_rejoin);
+		obj->QueueWorker(worker);
+		return Napi::Boolean::New(env, true);
+	}else{
+		vector<msgid_t>	msgids;
+		if(!ChmpxOpenMsgIds(obj->_chmcntrl.get(), static_cast<size_t>(count), no_giveup_rejoin, msgids)){
+			return env.Null();
+		}
+		return ChmpxMsgPool::NewInstance(env, info.This().As<Napi::Object>(), msgids);
+	}
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn bool isChmpxExit()
+ * @brief	Check the chmpx process's status(running or exit)
+ *
+ * @return	Returns true as chmpx process is running, false means chmpx process does not exist.
+ */
+
+Napi::Value ChmpxNode::IsChmpxExit(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	bool result = obj->_chmcntrl->IsChmpxExit();
+	return Napi::Boolean::New(env, result);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn bool\
+ * Destroy(\
+ * 	Callback cbfunc=null\
+ * )
+ * @brief	Destroy the chmpx resources of this object.
+ *
+ *	The requests in flight are rejected, and the receiving threads are stopped.
+ *	Then this method waits for the async workers which are running on this
+ *	object, and detaches from chmpx(MQs).
+ *	If the async workers are not finished in 10 seconds, this does not detach
+ *	from chmpx here, because those workers still use it. Then the last one
+ *	of them detaches from chmpx when it is finished.
+ *	If the callback function is specified, this method works asynchronization
+ *	(the cleanup runs off JS thread) and calls callback function at finishing.
+ *	This object can be initialized again after calling this method.
+ *
+ * @param[in] cbfunc		callback function.
+ *
+ * @return	Returns true if the callback function is specified or the cleanup
+ *			is finished, false if the waiting for the async workers timed out.
+ *
+ */
+
+Napi::Value ChmpxNode::Destroy(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::DestroyCommon(info, false);
+}
+
+Napi::Value ChmpxNode::DestroyCommon(const Napi::CallbackInfo& info, bool is_promise)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0]
+	Napi::Function	maybeCallback;
+	bool			hasCallback = false;
+	if(is_promise){
+		if(0 < info.Length()){
+			Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+	}else if(0 < info.Length()){
+		if(1 < info.Length()){
+			Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if(!info[0].IsFunction()){
+			Napi::TypeError::New(env, "Last parameter is not callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		maybeCallback	= info[0].As<Napi::Function>();
+		hasCallback		= true;
+	}
+
+	// can not destroy while draining(the drain worker uses the resources)
+	if(obj->_drain_running){
+		Napi::Error::New(env, "The object is draining, wait for the completion of drain.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// reject requests in flight, and take the resources out of this object
+	obj->_requester->CancelAll(env, "The object is destroyed.");
+	obj->FlushWaitingWorkers();
+	ChmpxNodeResources*	pres = obj->DetachResources(true);
+	obj->_draining = false;
+
+	// Execute
+	if(is_promise || hasCallback){
+		// [NOTE]
+		// The cleanup waits for the workers on the worker thread pool,
+		// so this worker is queued to the libuv thread pool.
+		//
+		CleanupWorker*	worker	= new CleanupWorker(env, maybeCallback, [pres](){
+			if(!pres->Cleanup()){
+				return false;
+			}
+			delete pres;
+			return true;
+		});
+		Napi::Value		promise	= worker->GetPromise();
+		worker->Queue();
+		return (is_promise ? promise : Napi::Boolean::New(env, true));
+	}else{
+		bool	result = pres->Cleanup();
+		if(result){
+			delete pres;
+		}
+		return Napi::Boolean::New(env, result);
+	}
+}
+
+/**
+ * This StartReceiving method allows two type arguments.
+ * One of type is for joining on server, the other type is for joining on slave.
+ *
+ *****************************************************************
+ * On server node
+ *****************************************************************
+ * @memberof ChmpxNode
+ * @fn bool\
+ * StartReceiving(\
+ * 	int timeout_ms=100\
+ * 	, bool no_giveup_rejoin=false\
+ * 	, Callback cbfunc=null\
+ * )
+ * @brief	Start receiving loop on server node
+ *
+ *	This method starts one dedicated thread which continues to receive data,
+ *	and calls callback function for each received data until StopReceiving
+ *	is called.
+ *	If the callback function is not specified, the callback handles for
+ *	receive emitter is used.
+ *
+ * @param[in] timeout_ms		Specify timeout ms for each receiving, this is the
+ *								interval for checking the stop request.
+ *								If it is 0 or negative, 100ms is used.
+ * @param[in] no_giveup_rejoin	Specify true for that upper limit for rejoin chmpx when
+ *								chmpx is down is ignored.
+ * @param[in] cbfunc			callback function.
+ *
+ * @return	Returns true for success, false for failure(ex. already started).
+ *
+ *****************************************************************
+ * On slave node
+ *****************************************************************
+ * @memberof ChmpxNode
+ * @fn bool\
+ * StartReceiving(\
+ * 	Buffer	msgid\
+ * 	, int	timeout_ms=100\
+ * 	, Callback cbfunc=null\
+ * )
+ * @brief	Start receiving loop on slave node
+ *
+ *	This method starts one dedicated thread which continues to receive data
+ *	for msgid, and calls callback function for each received data until
+ *	StopReceiving is called.
+ *	If the callback function is not specified, the callback handles for
+ *	receive emitter is used.
+ *
+ * @param[in] msgid				Specify msgid which is received from ChmpxNode::Open()
+ * @param[in] timeout_ms		Specify timeout ms for each receiving, this is the
+ *								interval for checking the stop request.
+ *								If it is 0 or negative, 100ms is used.
+ * @param[in] cbfunc			callback function.
+ *
+ * @return	Returns true for success, false for failure(ex. already started).
+ *
+ * [NOTE]
+ * The callback function is the same as Receive method, and it is called with
+ * an error when the receiving failed, then the receiving loop is stopped.
+ *
+ */
+
+Napi::Value ChmpxNode::StartReceiving(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj = Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// initial callback comes from emitter map if set
+	Napi::Function				maybeCallback;
+	bool						hasCallback		= false;
+	Napi::Function				emitterCb		= obj->_cbs.Find(EMITTER_POS_RECEIVE);
+	if(!emitterCb.IsEmpty()){
+		maybeCallback	= emitterCb;
+		hasCallback		= true;
+	}
+
+	// common variables
+	bool		is_on_server	= obj->_chmcntrl->IsClientOnSvrType();
+	msgid_t		msgid			= CHM_INVALID_MSGID;			// only on slave type
+	int			timeout_ms		= ChmpxReceiveLoop::DEFAULT_TIMEOUT_MS;
+	bool		no_giveup_rejoin= false;						// only on server type
+	size_t		pos				= 0;
+
+	if(!is_on_server){
+		// info[0] : msgid Required
+		if(info.Length() < 1){
+			Napi::TypeError::New(env, "Wrong msgid is specified.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if(!GetChmpxMsgIdParam(env, info[0], msgid)){
+			return env.Undefined();
+		}
+		++pos;
+	}
+
+	// timeout ms
+	if(pos < info.Length() && !info[pos].IsFunction() && !info[pos].IsBoolean()){
+		timeout_ms = info[pos].ToNumber().Int32Value();
+		++pos;
+	}
+
+	// no giveup flag(only on server type)
+	if(is_on_server && pos < info.Length() && info[pos].IsBoolean()){
+		no_giveup_rejoin = info[pos].ToBoolean();
+		++pos;
+	}
+
+	// callback function
+	if(pos < info.Length()){
+		if(!info[pos].IsFunction()){
+			Napi::TypeError::New(env, "Unknown parameter is specified for callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if((pos + 1) < info.Length()){
+			Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		maybeCallback	= info[pos].As<Napi::Function>();
+		hasCallback		= true;
+	}
+	if(!hasCallback){
+		Napi::TypeError::New(env, "Called startReceiving method without callback function.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// not start while draining
+	if(obj->_draining){
+		return Napi::Boolean::New(env, false);
+	}
+
+	// Start(new loop for each)
+	if(obj->_rcvloop && obj->_rcvloop->IsRunning()){
+		return Napi::Boolean::New(env, false);
+	}
+	ChmpxReceiveLoopPtr	rcvloop = std::make_shared<ChmpxReceiveLoop>(obj->_chmcntrl.get(), is_on_server, msgid, timeout_ms, no_giveup_rejoin, obj->RcvBodyType());
+	if(!rcvloop->Start(env, maybeCallback, obj->_threads)){
+		return Napi::Boolean::New(env, false);
+	}
+	obj->_rcvloop = rcvloop;
+	return Napi::Boolean::New(env, true);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn bool StopReceiving()
+ * @brief	Stop receiving loop which is started by StartReceiving
+ *
+ *	This method only requests the receiving thread to stop, and does not
+ *	wait for it. The thread exits after the receiving slice at most, and
+ *	StartReceiving can be called again at once.
+ *	The data which has already been received is passed to the callback
+ *	function even after this method returns.
+ *
+ * @return	Returns true if the receiving loop was running, otherwise false.
+ */
+
+Napi::Value ChmpxNode::StopReceiving(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	bool	result = false;
+	if(obj->_rcvloop){
+		result = obj->_rcvloop->IsRunning();
+		obj->_rcvloop->RequestStop();
+		obj->_rcvloop.reset();
+	}
+	return Napi::Boolean::New(env, result);
+}
+
+/**
+ * This Messages method allows two type arguments.
+ * One of type is for joining on server, the other type is for joining on slave.
+ *
+ *****************************************************************
+ * On server node
+ *****************************************************************
+ * @memberof ChmpxNode
+ * @fn ChmpxMsgIterator\
+ * Messages(\
+ * 	Object options=null\
+ * )
+ * @brief	Get the async iterator of received data on server node
+ *
+ *****************************************************************
+ * On slave node
+ *****************************************************************
+ * @memberof ChmpxNode
+ * @fn ChmpxMsgIterator\
+ * Messages(\
+ * 	Buffer	msgid\
+ * 	, Object options=null\
+ * )
+ * @brief	Get the async iterator of received data for msgid on slave node
+ *
+ *	This method starts one dedicated thread which continues to receive data
+ *	into the bounded queue, and returns the async iterator(for await...of)
+ *	which takes the data from it. When the queue has highWaterMark data,
+ *	the receiving is paused until the iterator takes them, so the data are
+ *	left in chmpx while JS falls behind.
+ *	The options object can have the following keys.
+ *		timeout			: The iteration ends when no data arrives within this
+ *						  ms. Negative value means waiting forever(default -1).
+ *		batch			: If more than 0, each value is the array of up to
+ *						  batch [compkt, body] pairs which have been received.
+ *						  Otherwise each value is one [compkt, body](default 0).
+ *		highWaterMark	: The maximum count of data in the queue(default 16).
+ *		noGiveupRejoin	: Only on server node, specify true for that upper limit
+ *						  for rejoin chmpx when chmpx is down is ignored.
+ *	The zeroCopy option of SetReceiveOptions is applied to the body.
+ *
+ * @param[in] msgid				Specify msgid which is received from ChmpxNode::Open()
+ * @param[in] options			Specify the options object
+ *
+ * @return	Returns the ChmpxMsgIterator object.
+ *
+ * [NOTE]
+ * The receiving stops when the iteration is finished by break(return()),
+ * the object is destroyed or drained, or failed to receive(the Promise of
+ * next() is rejected).
+ *
+ */
+
+Napi::Value ChmpxNode::Messages(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj = Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// common variables
+	bool		is_on_server	= obj->_chmcntrl->IsClientOnSvrType();
+	msgid_t		msgid			= CHM_INVALID_MSGID;			// only on slave type
+	int			timeout_ms		= -1;
+	size_t		batch			= 0;
+	size_t		highwatermark	= ChmpxMsgStream::DEFAULT_HIGH_WATER_MARK;
+	bool		no_giveup_rejoin= false;						// only on server type
+	size_t		pos				= 0;
+
+	if(!is_on_server){
+		// info[0] : msgid Required
+		if(info.Length() < 1){
+			Napi::TypeError::New(env, "Wrong msgid is specified.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if(!GetChmpxMsgIdParam(env, info[0], msgid)){
+			return env.Undefined();
+		}
+		++pos;
+	}
+
+	// options
+	if(pos < info.Length() && !info[pos].IsUndefined() && !info[pos].IsNull()){
+		if(!info[pos].IsObject()){
+			Napi::TypeError::New(env, "The options parameter must be an object.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		Napi::Object	options = info[pos].As<Napi::Object>();
+
+		if(options.Has("timeout")){
+			Napi::Value	timeout = options.Get("timeout");
+			if(!timeout.IsNumber()){
+				Napi::TypeError::New(env, "The timeout option must be a number.").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+			timeout_ms = timeout.As<Napi::Number>().Int32Value();
+		}
+		if(options.Has("batch")){
+			Napi::Value	batchval = options.Get("batch");
+			if(!batchval.IsNumber() || batchval.As<Napi::Number>().Int64Value() < 0){
+				Napi::TypeError::New(env, "The batch option must be a number(0 or more).").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+			batch = static_cast<size_t>(batchval.As<Napi::Number>().Int64Value());
+		}
+		if(options.Has("highWaterMark")){
+			Napi::Value	hwm = options.Get("highWaterMark");
+			if(!hwm.IsNumber() || hwm.As<Napi::Number>().Int64Value() < 1){
+				Napi::TypeError::New(env, "The highWaterMark option must be a number(1 or more).").ThrowAsJavaScriptException();
+				return env.Undefined();
+			}
+			highwatermark = static_cast<size_t>(hwm.As<Napi::Number>().Int64Value());
+		}
+		if(is_on_server && options.Has("noGiveupRejoin")){
+			no_giveup_rejoin = options.Get("noGiveupRejoin").ToBoolean();
+		}
+		++pos;
+	}
+	if(pos < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// not start while draining
+	if(obj->_draining){
+		Napi::Error::New(env, "The object is draining, new operations are not accepted.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Create stream and iterator(the iterator starts the stream)
+	ChmpxMsgStreamPtr	stream = std::make_shared<ChmpxMsgStream>(obj->_chmcntrl.get(), is_on_server, msgid, timeout_ms, highwatermark, no_giveup_rejoin);
+	return ChmpxMsgIterator::NewInstance(env, info.This().As<Napi::Object>(), stream, obj->_threads, batch, obj->RcvBodyType());
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn bool SetReceiveOptions(Object options)
+ * @brief	Set options for the received data
+ *
+ *	The options object can have the following keys.
+ *		zeroCopy	: If true, the body Buffer of received data wraps the
+ *					  memory allocated by libchmpx without copying it, and
+ *					  the memory is freed when the Buffer is garbage
+ *					  collected. The default is false(the body is copied).
+ *		encoding	: If 'utf8', the body of received data is a string which
+ *					  is decoded natively from the received memory, and
+ *					  zeroCopy is ignored. 'buffer' is the default.
+ *		requestHeader: If true, the request header which is put by request()
+ *					  of the slave is stripped from the received body on
+ *					  server, and reply() puts it in front of the reply
+ *					  body. The default is false(the body is not changed),
+ *					  so the server which handles request() must enable it.
+ *	Options which are not specified are not changed.
+ *	The options are applied to the receive methods(and the receiving loop)
+ *	called after this method.
+ *
+ * @param[in] options	Specify the options object
+ *
+ * @return	Returns true for success, otherwise throws an exception.
+ */
+
+Napi::Value ChmpxNode::SetReceiveOptions(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// check parameter
+	if(1 != info.Length() || !info[0].IsObject()){
+		Napi::TypeError::New(env, "The options parameter must be an object.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	Napi::Object	options = info[0].As<Napi::Object>();
+
+	if(options.Has("zeroCopy")){
+		Napi::Value	zerocopy = options.Get("zeroCopy");
+		if(!zerocopy.IsBoolean()){
+			Napi::TypeError::New(env, "The zeroCopy option must be a boolean.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		obj->_zerocopy_rcv = zerocopy.As<Napi::Boolean>().Value();
+	}
+	if(options.Has("encoding")){
+		Napi::Value	encoding	= options.Get("encoding");
+		std::string	strenc		= encoding.IsString() ? encoding.As<Napi::String>().Utf8Value() : std::string("");
+		if(strenc == "utf8" || strenc == "utf-8"){
+			obj->_utf8_rcv = true;
+		}else if(strenc == "buffer"){
+			obj->_utf8_rcv = false;
+		}else{
+			Napi::TypeError::New(env, "The encoding option must be 'utf8' or 'buffer'.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+	}
+	if(options.Has("requestHeader")){
+		Napi::Value	reqheader = options.Get("requestHeader");
+		if(!reqheader.IsBoolean()){
+			Napi::TypeError::New(env, "The requestHeader option must be a boolean.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		obj->_chmcntrl->SetReqHeader(reqheader.As<Napi::Boolean>().Value());
+	}
+	return Napi::Boolean::New(env, true);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn bool SetFlowOptions(Object options)
+ * @brief	Set options for the flow control of async send operations
+ *
+ *	The options object can have the following keys.
+ *		maxInFlight	: The maximum count of async operations in the send lane
+ *					  (send, broadcast, batch and close) which are queued or
+ *					  running on this object. The operations over it wait in
+ *					  the FIFO of this object, and they are started when the
+ *					  others are completed. 0 means no limit(default).
+ *	The send methods with callback return false when the count reaches
+ *	maxInFlight(the operation is accepted), and the drain event is emitted
+ *	when the count becomes less than it, as same as stream.write().
+ *
+ * @param[in] options	Specify the options object
+ *
+ * @return	Returns true for success, otherwise throws an exception.
+ */
+
+Napi::Value ChmpxNode::SetFlowOptions(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// check parameter
+	if(1 != info.Length() || !info[0].IsObject()){
+		Napi::TypeError::New(env, "The options parameter must be an object.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	Napi::Object	options = info[0].As<Napi::Object>();
+
+	if(options.Has("maxInFlight")){
+		Napi::Value	maxinflight = options.Get("maxInFlight");
+		if(!maxinflight.IsNumber() || maxinflight.As<Napi::Number>().Int64Value() < 0){
+			Napi::TypeError::New(env, "The maxInFlight option must be a number(0 or more).").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		obj->_flow->max_inflight = static_cast<size_t>(maxinflight.As<Napi::Number>().Int64Value());
+
+		// if the limit is raised, the waiting workers can be started now
+		obj->SubmitWaitingWorkers();
+	}
+	return Napi::Boolean::New(env, true);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Object GetStats()
+ * @brief	Get the statistics of operations on this object
+ *
+ *	The result object has the following keys for each operation(send,
+ *	broadcast, receive, reply, open, close, request), and each value is
+ *	the object which has the following keys.
+ *		count		: The count of succeeded operations
+ *		errors		: The count of failed operations
+ *		timeouts	: The count of timeouted operations(receive which got no
+ *					  data including polling by receiving threads, and request)
+ *		bytes		: The total bytes of body in succeeded operations
+ *		latency		: The array of the latency histogram, the element N is
+ *					  the count of operations which took less than 2^(N+1)
+ *					  microseconds(and not less than 2^N except N=0), and the
+ *					  last element counts all operations over it.
+ *	The send/batch/request paths are counted as send for each message, and
+ *	the request also counts its round trip time as request.
+ *
+ * @return	Returns the statistics object.
+ */
+
+Napi::Value ChmpxNode::GetStats(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	return obj->_chmcntrl->GetStats().ToObject(env);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn bool ResetStats()
+ * @brief	Reset the statistics of operations on this object
+ *
+ * @return	Always returns true.
+ */
+
+Napi::Value ChmpxNode::ResetStats(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	obj->_chmcntrl->GetStats().Reset();
+	return Napi::Boolean::New(env, true);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn bool\
+ * Drain(\
+ * 	int			timeout_ms=-1\
+ * 	, Callback	cbfunc\
+ * )
+ * @brief	Drain the operations in flight for shutting down gracefully
+ *
+ *	After calling this method, this object does not accept new operations
+ *	(async operations fail with Error, and sync send, receive and reply throw
+ *	Error), requests and background receiving.
+ *	Then this method stops the background receiving, waits for the async workers
+ *	which are queued or running on this object up to timeout_ms, and closes the
+ *	msgids which are opened on this object if all workers are flushed.
+ *	The callback is called with the result object:
+ *	@li flushed
+ *		The count of the async workers which are completed while draining.
+ *	@li abandoned
+ *		The count of the async workers which are not completed at timeout, and
+ *		the requests in flight(they are rejected).
+ *	@li closed
+ *		The count of the closed msgids.
+ *	This object can be used again after calling Destroy(and initializing).
+ *
+ * @param[in] timeout_ms	Specify timeout ms for waiting, negative value means no timeout
+ * @param[in] cbfunc		callback function.
+ *
+ * @return	Returns true if the draining is started, or false if it is already running.
+ */
+
+Napi::Value ChmpxNode::Drain(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::DrainCommon(info, false);
+}
+
+Napi::Value ChmpxNode::DrainCommon(const Napi::CallbackInfo& info, bool is_promise)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// parse parameter
+	Napi::Function	maybeCallback;
+	int				timeout_ms	= -1;
+	size_t			pos			= 0;
+	if(pos < info.Length() && !info[pos].IsFunction()){
+		timeout_ms = info[pos].ToNumber().Int32Value();
+		++pos;
+	}
+	if(!is_promise){
+		// [NOTE]
+		// The workers are completed on JS thread, so the draining can
+		// not wait for them synchronously.
+		//
+		if(info.Length() <= pos || !info[pos].IsFunction()){
+			Napi::TypeError::New(env, "Called drain method without callback function.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		maybeCallback = info[pos].As<Napi::Function>();
+		++pos;
+	}
+	if(pos < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// already running
+	if(obj->_drain_running){
+		if(is_promise){
+			Napi::Promise::Deferred	deferred = Napi::Promise::Deferred::New(env);
+			deferred.Reject(Napi::Error::New(env, "The object is already draining.").Value());
+			return deferred.Promise();
+		}
+		return Napi::Boolean::New(env, false);
+	}
+	obj->_draining		= true;
+	obj->_drain_running	= true;
+
+	// Create worker and Queue it to the libuv thread pool
+	DrainWorker*	worker	= new DrainWorker(env, maybeCallback, obj->_chmcntrl.get(), obj->_threads.get(), obj->_requester.get(), info.This().As<Napi::Object>(), timeout_ms);
+	worker->AddCompleteHook([obj](){
+		obj->_drain_running = false;
+	});
+	Napi::Value		promise	= worker->GetPromise();
+	worker->Queue();
+	return (is_promise ? promise : Napi::Boolean::New(env, true));
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn bool ConfigurePool(Object options)
+ * @brief	Configure the worker thread pool(static method)
+ *
+ *	The async methods(with callback and Promise) of all ChmpxNode objects
+ *	run on the worker thread pool of this module instead of the libuv thread
+ *	pool, so the blocking chmpx calls do not affect fs, crypto and dns.
+ *	The pool is created for each environment(main thread and each of
+ *	worker_threads), and this method configures the pool of the caller's
+ *	environment.
+ *	The options object can have the following keys.
+ *		size		: The number of threads(default 4)
+ *		threadName	: The prefix of the thread names(default "chmpx-pool")
+ *		maxPerNode	: The maximum number of workers which run at the same
+ *					  time for one ChmpxNode object. 0 means no limit(default).
+ *		coalesce	: If true, the finished workers are gathered in the native
+ *					  queue and they are completed(the callbacks are called
+ *					  and the Promises are settled) together in one dispatch
+ *					  on JS thread, instead of one dispatch for each worker.
+ *					  This reduces the overhead when many operations finish
+ *					  in a loop turn. The default is false.
+ *	Options which are not specified are not changed.
+ *	If the threads are running, they are retired without waiting(each of
+ *	them exits after its running worker), and new threads are started with
+ *	new options.
+ *
+ * @param[in] options	Specify the options object
+ *
+ * @return	Returns true for success, otherwise false.
+ */
+
+Napi::Value ChmpxNode::ConfigurePool(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// check parameter
+	if(1 != info.Length() || !info[0].IsObject()){
+		Napi::TypeError::New(env, "The options parameter must be an object.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	Napi::Object		options	= info[0].As<Napi::Object>();
+
+	ChmpxWorkerPool*	pool	= ChmpxNode::GetPool(env);
+	if(!pool){
+		return Napi::Boolean::New(env, false);
+	}
+	size_t		size			= pool->GetSize();
+	std::string	thread_name		= pool->GetThreadName();
+	size_t		max_per_node	= pool->GetMaxPerOwner();
+	bool		is_coalesce		= pool->IsCoalesce();
+
+	if(options.Has("size")){
+		Napi::Value	value = options.Get("size");
+		if(!value.IsNumber() || value.As<Napi::Number>().Int64Value() < 1){
+			Napi::TypeError::New(env, "The size option must be a number greater than 0.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		size = static_cast<size_t>(value.As<Napi::Number>().Int64Value());
+	}
+	if(options.Has("threadName")){
+		Napi::Value	value = options.Get("threadName");
+		if(!value.IsString()){
+			Napi::TypeError::New(env, "The threadName option must be a string.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		thread_name = value.As<Napi::String>().Utf8Value();
+	}
+	if(options.Has("maxPerNode")){
+		Napi::Value	value = options.Get("maxPerNode");
+		if(!value.IsNumber() || value.As<Napi::Number>().Int64Value() < 0){
+			Napi::TypeError::New(env, "The maxPerNode option must be a number 0 or more.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		max_per_node = static_cast<size_t>(value.As<Napi::Number>().Int64Value());
+	}
+	if(options.Has("coalesce")){
+		Napi::Value	value = options.Get("coalesce");
+		if(!value.IsBoolean()){
+			Napi::TypeError::New(env, "The coalesce option must be a boolean.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		is_coalesce = value.As<Napi::Boolean>().Value();
+	}
+
+	bool result = pool->Configure(size, thread_name, max_per_node, is_coalesce);
+	return Napi::Boolean::New(env, result);
+}
+
+//---------------------------------------------------------
+// Methods (Promise)
+//---------------------------------------------------------
+// [NOTE]
+// These methods do not use the callback function(and the emitter),
+// and return the Promise which is resolved/rejected from the worker
+// directly.
+//
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * InitializeOnServerAsync(\
+ * 	String	filepath\
+ * 	, bool	is_auto_rejoin=false\
+ * )
+ * @brief	Promise version of InitializeOnServer
+ *
+ * @return	Returns the Promise which is resolved with undefined, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::InitializeOnServerAsync(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::InitializeOnAsync(info, true);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * InitializeOnSlaveAsync(\
+ * 	String	filepath\
+ * 	, bool	is_auto_rejoin=false\
+ * )
+ * @brief	Promise version of InitializeOnSlave
+ *
+ * @return	Returns the Promise which is resolved with undefined, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::InitializeOnSlaveAsync(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::InitializeOnAsync(info, false);
+}
+
+Napi::Value ChmpxNode::InitializeOnAsync(const Napi::CallbackInfo& info, bool is_on_server)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No configuration file name is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(2 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0] : Required
+	if(info[0].IsNull() || info[0].IsUndefined()){
+		Napi::TypeError::New(env, "file name is empty.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	std::string	filename		= info[0].ToString().Utf8Value();
+
+	// info[1]
+	bool		is_auto_rejoin	= (1 < info.Length() ? info[1].ToBoolean().Value() : false);
+
+	// Create worker and Queue it
+	InitializeOnWorker*	worker	= new InitializeOnWorker(env, Napi::Function(), obj->_chmcntrl.get(), filename, is_auto_rejoin, is_on_server);
+	Napi::Value			promise	= worker->GetPromise();
+	obj->QueueWorker(worker);
+	return promise;
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * SendAsync(\
+ * 	Buffer		msgid\
+ * 	, Buffer	body\
+ *	, bool		is_routing=true\
+ * )
+ * @brief	Promise version of Send
+ *
+ * @return	Returns the Promise which is resolved with receiver count, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::SendAsync(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No msgid is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(info.Length() < 2){
+		Napi::TypeError::New(env, "No send data is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(3 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0] : msgid Required
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	ChmpxMsgId*	pmsgidobj	= NULL;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
+		return env.Undefined();
+	}
+
+	// info[1] : data Required(Buffer or array of pieces)
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[1])){
+		return env.Undefined();
+	}
+
+	// info[2]
+	bool	is_routing = (2 < info.Length() ? info[2].ToBoolean().Value() : true);
+
+	// Create worker and Queue it
+	SendWorker*	worker	= new SendWorker(env, Napi::Function(), obj->_chmcntrl.get(), msgid, body.Owner(), body.Data(), body.Length(), body.GetHash(), is_routing);
+	Napi::Value	promise	= worker->GetPromise();
+	worker->DetachBody(body);
+	obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid), pmsgidobj);
+	return promise;
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * BroadcastAsync(\
+ * 	Buffer		msgid\
+ * 	, Buffer	body\
+ * )
+ * @brief	Promise version of Broadcast
+ *
+ * @return	Returns the Promise which is resolved with receiver count, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::BroadcastAsync(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No msgid is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(info.Length() < 2){
+		Napi::TypeError::New(env, "No send data is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(2 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0] : msgid Required
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	ChmpxMsgId*	pmsgidobj	= NULL;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
+		return env.Undefined();
+	}
+
+	// info[1] : data Required(Buffer or array of pieces)
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[1])){
+		return env.Undefined();
+	}
+
+	// Create worker and Queue it
+	BroadcastWorker*	worker	= new BroadcastWorker(env, Napi::Function(), obj->_chmcntrl.get(), msgid, body.Owner(), body.Data(), body.Length(), body.GetHash());
+	Napi::Value			promise	= worker->GetPromise();
+	worker->DetachBody(body);
+	obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid), pmsgidobj);
+	return promise;
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * ReplyAsync(\
+ * 	Buffer		ComPkt\
+ * 	, Buffer	body\
+ * )
+ * @brief	Promise version of Reply
+ *
+ * @return	Returns the Promise which is resolved with undefined, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::ReplyAsync(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No compkt is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(info.Length() < 2){
+		Napi::TypeError::New(env, "No reply data is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(2 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0] : compkt Required
+	COMPKT		compkt;
+	bool		has_reqid	= false;
+	uint64_t	reqid		= 0;
+	if(!GetChmpxComPktParam(env, info[0], compkt, has_reqid, reqid)){
+		return env.Undefined();
+	}
+
+	// info[1] : data Required(Buffer or array of pieces, after the headroom for request header)
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[1], (has_reqid ? CHMPX_REQHDR_SIZE : 0))){
+		return env.Undefined();
+	}
+	if(has_reqid){
+		ChmpxSetReqHeader(body.Data(), reqid);
+	}
+
+	// Create worker and Queue it
+	ReplyWorker*	worker	= new ReplyWorker(env, Napi::Function(), obj->_chmcntrl.get(), &compkt, body.Owner(), body.Data(), body.Length());
+	Napi::Value		promise	= worker->GetPromise();
+	worker->DetachBody(body);
+	obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_REPLY, CHM_INVALID_MSGID));
+	return promise;
+}
+
+/**
+ * This ReceiveAsync method allows two type arguments.
+ * One of type is for joining on server, the other type is for joining on slave.
+ *
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * ReceiveAsync(\
+ * 	int timeout_ms=0\
+ * 	, bool no_giveup_rejoin=false\
+ * )
+ * @fn Promise\
+ * ReceiveAsync(\
+ * 	Buffer msgid\
+ * 	, int timeout_ms=0\
+ * )
+ * @brief	Promise version of Receive
+ *
+ *	AbortSignal is allowed as the last parameter, and the Promise is
+ *	rejected with signal.reason(or AbortError) when it is aborted.
+ *
+ * @return	Returns the Promise which is resolved with [compkt, body], or rejected
+ *			with Error(include timeout).
+ */
+
+Napi::Value ChmpxNode::ReceiveAsync(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj = Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// [NOTE]
+	// AbortSignal is allowed as the last parameter, and it is taken
+	// out before parsing the other parameters.
+	//
+	size_t		argc			= info.Length();
+	Napi::Value	signal;
+	if(0 < argc && ChmpxAbortWatcher::IsSignal(info[argc - 1])){
+		signal = info[argc - 1];
+		--argc;
+	}
+
+	// common variables
+	bool		is_on_server	= obj->_chmcntrl->IsClientOnSvrType();
+	msgid_t		msgid			= CHM_INVALID_MSGID;			// only on slave type
+	ChmpxMsgId*	pmsgidobj		= NULL;							// only on slave type
+	int			timeout_ms		= 0;
+	bool		no_giveup_rejoin= false;						// only on server type
+	size_t		pos				= 0;
+
+	// parse parameter
+	if(!is_on_server){
+		// msgid : Required
+		if(argc <= pos){
+			Napi::TypeError::New(env, "No msgid is specified.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if(!GetChmpxMsgIdParam(env, info[pos], msgid, &pmsgidobj)){
+			return env.Undefined();
+		}
+		++pos;
+	}
+	if(pos < argc){
+		timeout_ms = info[pos].ToNumber().Int32Value();
+		++pos;
+	}
+	if(is_on_server && pos < argc){
+		no_giveup_rejoin = info[pos].ToBoolean();
+		++pos;
+	}
+	if(pos < argc){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Create worker and Queue it
+	ReceiveWorker*	worker;
+	if(is_on_server){
+		worker = new ReceiveWorker(env, Napi::Function(), obj->_chmcntrl.get(), timeout_ms, no_giveup_rejoin, obj->RcvBodyType());
+	}else{
+		worker = new ReceiveWorker(env, Napi::Function(), obj->_chmcntrl.get(), msgid, timeout_ms, obj->RcvBodyType());
+	}
+	if(!signal.IsEmpty()){
+		worker->SetAbortSignal(signal);
+	}
+	Napi::Value	promise	= worker->GetPromise();
+	obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_RECEIVE, (is_on_server ? CHM_INVALID_MSGID : msgid)), pmsgidobj);
+	return promise;
+}
+
+/**
+ * This ReceiveBatchAsync method allows two type arguments.
+ * One of type is for joining on server, the other type is for joining on slave.
+ *
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * ReceiveBatchAsync(\
+ * 	int maxcount\
+ * 	, int timeout_ms=0\
+ * 	, bool no_giveup_rejoin=false\
+ * )
+ * @fn Promise\
+ * ReceiveBatchAsync(\
+ * 	Buffer msgid\
+ * 	, int maxcount\
+ * 	, int timeout_ms=0\
+ * )
+ * @brief	Promise version of ReceiveBatch
+ *
+ *	AbortSignal is allowed as the last parameter, and the Promise is
+ *	rejected with signal.reason(or AbortError) when it is aborted.
+ *
+ * @return	Returns the Promise which is resolved with [[compkt, body], ...], or
+ *			rejected with Error.
+ */
+
+Napi::Value ChmpxNode::ReceiveBatchAsync(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj = Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// [NOTE]
+	// AbortSignal is allowed as the last parameter, and it is taken
+	// out before parsing the other parameters.
+	//
+	size_t		argc			= info.Length();
+	Napi::Value	signal;
+	if(0 < argc && ChmpxAbortWatcher::IsSignal(info[argc - 1])){
+		signal = info[argc - 1];
+		--argc;
+	}
+
+	// common variables
+	bool		is_on_server	= obj->_chmcntrl->IsClientOnSvrType();
+	msgid_t		msgid			= CHM_INVALID_MSGID;			// only on slave type
+	ChmpxMsgId*	pmsgidobj		= NULL;							// only on slave type
+	int32_t		maxcount		= 0;
+	int			timeout_ms		= 0;
+	bool		no_giveup_rejoin= false;						// only on server type
+	size_t		pos				= 0;
+
+	// parse parameter
+	if(!is_on_server){
+		// msgid : Required
+		if(argc <= pos){
+			Napi::TypeError::New(env, "No msgid is specified.").ThrowAsJavaScriptException();
+			return env.Undefined();
+		}
+		if(!GetChmpxMsgIdParam(env, info[pos], msgid, &pmsgidobj)){
+			return env.Undefined();
+		}
+		++pos;
+	}
+	// maxcount : Required
+	if(argc <= pos || !info[pos].IsNumber()){
+		Napi::TypeError::New(env, "No maximum count is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	maxcount = info[pos].As<Napi::Number>().Int32Value();
+	if(maxcount < 1){
+		Napi::RangeError::New(env, "Maximum count must be greater than 0.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	++pos;
+
+	if(pos < argc){
+		timeout_ms = info[pos].ToNumber().Int32Value();
+		++pos;
+	}
+	if(is_on_server && pos < argc){
+		no_giveup_rejoin = info[pos].ToBoolean();
+		++pos;
+	}
+	if(pos < argc){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Create worker and Queue it
+	ReceiveBatchWorker*	worker;
+	if(is_on_server){
+		worker = new ReceiveBatchWorker(env, Napi::Function(), obj->_chmcntrl.get(), static_cast<size_t>(maxcount), timeout_ms, no_giveup_rejoin, obj->RcvBodyType());
+	}else{
+		worker = new ReceiveBatchWorker(env, Napi::Function(), obj->_chmcntrl.get(), msgid, static_cast<size_t>(maxcount), timeout_ms, obj->RcvBodyType());
+	}
+	if(!signal.IsEmpty()){
+		worker->SetAbortSignal(signal);
+	}
+	Napi::Value	promise	= worker->GetPromise();
+	obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_RECEIVE, (is_on_server ? CHM_INVALID_MSGID : msgid)), pmsgidobj);
+	return promise;
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * OpenAsync(\
+ * 	bool no_giveup_rejoin=false\
+ * )
+ * @brief	Promise version of Open
+ *
+ * @return	Returns the Promise which is resolved with msgid, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::OpenAsync(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::OpenAsyncCommon(info, false);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * OpenMsgIdAsync(\
+ * 	bool no_giveup_rejoin=false\
+ * )
+ * @brief	Promise version of OpenMsgId
+ *
+ * @return	Returns the Promise which is resolved with ChmpxMsgId, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::OpenMsgIdAsync(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::OpenAsyncCommon(info, true);
+}
+
+Napi::Value ChmpxNode::OpenAsyncCommon(const Napi::CallbackInfo& info, bool is_handle)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(1 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0]
+	bool	no_giveup_rejoin = (0 < info.Length() ? info[0].ToBoolean().Value() : false);
+
+	// Create worker and Queue it
+	OpenWorker*	worker	= new OpenWorker(env, Napi::Function(), obj->_chmcntrl.get(), no_giveup_rejoin, is_handle);
+	Napi::Value	promise	= worker->GetPromise();
+	obj->QueueWorker(worker);
+	return promise;
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * CloseAsync(\
+ * 	Buffer msgid\
+ * )
+ * @brief	Promise version of Close
+ *
+ * @return	Returns the Promise which is resolved with undefined, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::CloseAsync(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No msgid is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(1 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0] : msgid Required
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	ChmpxMsgId*	pmsgidobj	= NULL;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
+		return env.Undefined();
+	}
+
+	// stop receiving replies for requests on the msgid
+	ChmpxRequestChannelPtr	channel = obj->_requester->Remove(env, msgid);
+	if(pmsgidobj){
+		pmsgidobj->SetClosed();
+	}
+
+	// Create worker and Queue it
+	CloseWorker*	worker	= new CloseWorker(env, Napi::Function(), obj->_chmcntrl.get(), msgid, channel);
+	Napi::Value		promise	= worker->GetPromise();
+	obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid), pmsgidobj);
+	return promise;
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * OpenPoolAsync(\
+ * 	int		count\
+ * 	, bool	no_giveup_rejoin=false\
+ * )
+ * @brief	Promise version of OpenPool
+ *
+ * @return	Returns the Promise which is resolved with the ChmpxMsgPool object, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::OpenPoolAsync(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No count is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(2 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0] : count Required
+	if(!info[0].IsNumber()){
+		Napi::TypeError::New(env, "Wrong count is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	int64_t	count = info[0].ToNumber().Int64Value();
+	if(count < 1 || static_cast<int64_t>(ChmpxMsgPool::MAX_COUNT) < count){
+		Napi::RangeError::New(env, "The count is out of range.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// info[1]
+	bool	no_giveup_rejoin = (1 < info.Length() ? info[1].ToBoolean().Value() : false);
+
+	// Create worker and Queue it
+	OpenPoolWorker*	worker	= new OpenPoolWorker(env, Napi::Function(), obj->_chmcntrl.get(), info.This().As<Napi::Object>(), static_cast<size_t>(count), no_giveup_rejoin);
+	Napi::Value		promise	= worker->GetPromise();
+	obj->QueueWorker(worker);
+	return promise;
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * DestroyAsync()
+ * @brief	Promise version of Destroy
+ *
+ * @return	Returns the Promise which is resolved with undefined after the cleanup,
+ *			or rejected if the waiting for the async workers timed out.
+ */
+
+Napi::Value ChmpxNode::DestroyAsync(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::DestroyCommon(info, true);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * DrainAsync(\
+ * 	int timeout_ms=-1\
+ * )
+ * @brief	Promise version of Drain
+ *
+ * @return	Returns the Promise which is resolved with { flushed, abandoned, closed }.
+ */
+
+Napi::Value ChmpxNode::DrainAsync(const Napi::CallbackInfo& info)
+{
+	return ChmpxNode::DrainCommon(info, true);
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Promise\
+ * Request(\
+ * 	Buffer		msgid\
+ * 	, Buffer	body\
+ * 	, int		timeout_ms=0\
+ *	, bool		is_routing=true\
+ * )
+ * @brief	Send the request data and wait for the reply on slave node
+ *
+ *	The request header which has the request id is put in front of the body,
+ *	and the request is sent on the worker thread pool as same as SendAsync.
+ *	The server node replies with the same request header by Reply. The
+ *	server node must enable the requestHeader option by SetReceiveOptions(),
+ *	then it does not need to care about the header. The replies on the msgid are
+ *	received by one dedicated thread and matched to the requests, so many
+ *	requests can be in flight on one msgid at the same time.
+ *	The msgid should be used only for requests, because the other data received
+ *	on it are discarded.
+ *
+ * @param[in] msgid			Specify msgid which is returned ChmpxNode::Open()
+ * @param[in] body			Specify request data(Buffer, string or array of them)
+ * @param[in] timeout_ms	Specify timeout ms for waiting the reply, 0 or less means no timeout
+ * @param[in] is_routing	Specify routing mode
+ *
+ * @return	Returns the Promise which is resolved with the reply body Buffer, or rejected with Error.
+ */
+
+Napi::Value ChmpxNode::Request(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// check
+	if(info.Length() < 1){
+		Napi::TypeError::New(env, "No msgid is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(info.Length() < 2){
+		Napi::TypeError::New(env, "No send data is specified.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}else if(4 < info.Length()){
+		Napi::TypeError::New(env, "Too many parameters.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// Unwrap
+	if(!info.This().IsObject() || !info.This().As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env))){
+		Napi::TypeError::New(env, "Invalid this object(ChmpxNode instance)").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+	ChmpxNode*	obj	= Napi::ObjectWrap<ChmpxNode>::Unwrap(info.This().As<Napi::Object>());
+
+	// info[0] : msgid Required
+	msgid_t		msgid		= CHM_INVALID_MSGID;
+	ChmpxMsgId*	pmsgidobj	= NULL;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid, &pmsgidobj)){
+		return env.Undefined();
+	}
+
+	// info[1] : data Required(gathered after the headroom for request header)
+	ChmpxSndBody	body;
+	if(!body.Set(env, info[1], CHMPX_REQHDR_SIZE)){
+		return env.Undefined();
+	}
+
+	// info[2]
+	int	timeout_ms = (2 < info.Length() ? info[2].ToNumber().Int32Value() : 0);
+
+	// info[3]
+	bool	is_routing = (3 < info.Length() ? info[3].ToBoolean().Value() : true);
+
+	// reject while draining
+	if(obj->_draining){
+		Napi::Promise::Deferred	deferred = Napi::Promise::Deferred::New(env);
+		deferred.Reject(Napi::Error::New(env, "The object is draining, new operations are not accepted.").Value());
+		return deferred.Promise();
+	}
+
+	// the request is pending on the msgid handle until it is settled
+	std::function<void(void)>	donehook;
+	if(pmsgidobj){
+		ChmpxMsgId::msgidstate_t	state = pmsgidobj->GetState();
+		++(state->pending);
+		donehook = [state](){
+			--(state->pending);
+		};
+	}
+
+	// register the request, and send it on the worker pool
+	ChmpxRequestChannelPtr	channel;
+	uint64_t				reqid	= 0;
+	Napi::Value				promise	= obj->_requester->Request(env, obj->_chmcntrl.get(), msgid, timeout_ms, channel, reqid, donehook);
+	if(channel){
+		ChmpxSetReqHeader(body.Data(), reqid);
+
+		RequestWorker*	worker = new RequestWorker(env, obj->_chmcntrl.get(), channel, reqid, msgid, body.Data(), body.Length(), is_routing);
+		worker->DetachBody(body);
+		obj->QueueWorker(worker, ChmpxPoolLane(CHMPX_LANE_SEND, msgid), pmsgidobj);
+	}else if(donehook){
+		donehook();				// the request is already rejected
+	}
+	return promise;
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn int\
+ * SendFast(\
+ * 	Buffer		msgid\
+ * 	, Buffer|String|Array	body\
+ * )
+ * @brief	Send the data synchronously with routing mode(fast path)
+ *
+ *	This is the fixed signature version of Send without callback. It does not
+ *	resolve the overloads and does not look up the emitter callback, so the
+ *	overhead of each call is less than Send.
+ *
+ * @param[in] msgid			Specify msgid(Buffer, BigInt or ChmpxMsgId)
+ * @param[in] body			Specify send data(same as Send)
+ *
+ * @return	Returns the count of receivers, or -1 if something error occurred.
+ */
+
+Napi::Value ChmpxNode::SendFast(const Napi::CallbackInfo& info)
+{
+	Napi::Env	env = info.Env();
+	ChmpxNode*	obj = GetChmpxNodeFast(info);
+	if(!obj || !obj->CheckAccepting(env)){
+		return env.Undefined();
+	}
+	if(2 != info.Length()){
+		Napi::TypeError::New(env, "sendFast needs msgid and body.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	msgid_t			msgid	= CHM_INVALID_MSGID;
+	ChmpxSndBody	body;
+	if(!GetChmpxMsgIdParam(env, info[0], msgid) || !body.Set(env, info[1])){
+		return env.Undefined();
+	}
+
+	long	recievercnt	= 0;
+	if(!obj->_chmcntrl->Send(msgid, body.Data(), body.Length(), body.GetHash(), &recievercnt, true)){
+		recievercnt = -1;
+	}
+	return Napi::Number::New(env, static_cast<int32_t>(recievercnt));
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn Array\
+ * ReceiveFast(\
+ * 	Buffer	msgid\
+ * 	, int	timeout_ms\
+ * )
+ * @brief	Receive one data synchronously(fast path)
+ *
+ *	This is the fixed signature version of Receive without callback. The
+ *	msgid is ignored on server node(specify null), and no_giveup_rejoin is
+ *	always false. It does not resolve the overloads and does not look up
+ *	the emitter callback.
+ *
+ * @param[in] msgid			Specify msgid(Buffer, BigInt or ChmpxMsgId) on slave, null on server
+ * @param[in] timeout_ms	Specify timeout ms for waiting
+ *
+ * @return	Returns the Array of [compkt, body], or null if timeouted or something error occurred.
+ */
+
+Napi::Value ChmpxNode::ReceiveFast(const Napi::CallbackInfo& info)
+{
+	Napi::Env	env = info.Env();
+	ChmpxNode*	obj = GetChmpxNodeFast(info);
+	if(!obj || !obj->CheckAccepting(env)){
+		return env.Undefined();
+	}
+	if(2 != info.Length()){
+		Napi::TypeError::New(env, "receiveFast needs msgid(or null) and timeout_ms.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	bool	is_on_server	= obj->_chmcntrl->IsClientOnSvrType();
+	msgid_t	msgid			= CHM_INVALID_MSGID;
+	if(!is_on_server && !GetChmpxMsgIdParam(env, info[0], msgid)){
+		return env.Undefined();
+	}
+	int		timeout_ms		= info[1].ToNumber().Int32Value();
+
+	ChmpxRcvData*	pdata = NULL;
+	if(!ChmpxReceiveData(obj->_chmcntrl.get(), is_on_server, msgid, timeout_ms, false, &pdata) || !pdata){
+		return env.Null();
+	}
+	std::unique_ptr<ChmpxRcvData>	data(pdata);
+	Napi::Array						result = Napi::Array::New(env, 2);
+	result.Set(static_cast<uint32_t>(0), ChmpxRcvDataToPktBuffer(env, *data));
+	result.Set(static_cast<uint32_t>(1), ChmpxRcvDataToBodyBuffer(env, *data, obj->RcvBodyType()));
+	return result;
+}
+
+/**
+ * @memberof ChmpxNode
+ * @fn bool\
+ * ReplyFast(\
+ * 	Buffer		compkt\
+ * 	, Buffer|String|Array	body\
+ * )
+ * @brief	Reply the data synchronously on server node(fast path)
+ *
+ *	This is the fixed signature version of Reply without callback.
+ *
+ * @param[in] compkt		Specify compkt which is received
+ * @param[in] body			Specify reply data
+ *
+ * @return	Returns true for success, false for failure.
+ */
+
+Napi::Value ChmpxNode::ReplyFast(const Napi::CallbackInfo& info)
+{
+	Napi::Env	env = info.Env();
+	ChmpxNode*	obj = GetChmpxNodeFast(info);
+	if(!obj || !obj->CheckAccepting(env)){
+		return env.Undefined();
+	}
+	if(2 != info.Length()){
+		Napi::TypeError::New(env, "replyFast needs compkt and body.").ThrowAsJavaScriptException();
+		return env.Undefined();
+	}
+
+	// the reply for the request is gathered after the headroom for request header
+	COMPKT			compkt;
+	bool			has_reqid	= false;
+	uint64_t		reqid		= 0;
+	ChmpxSndBody	body;
+	if(!GetChmpxComPktParam(env, info[0], compkt, has_reqid, reqid) || !body.Set(env, info[1], (has_reqid ? CHMPX_REQHDR_SIZE : 0))){
+		return env.Undefined();
+	}
+	if(has_reqid){
+		ChmpxSetReqHeader(body.Data(), reqid);
+	}
+	return Napi::Boolean::New(env, obj->_chmcntrl->Reply(&compkt, body.Data(), body.Length()));
 }
 
 //@}
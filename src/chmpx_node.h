@@ -24,20 +24,102 @@
 #ifndef CHMPX_NODE_H
 #define CHMPX_NODE_H
 
+#include <deque>
+#include <memory>
 #include "chmpx_common.h"
+#include "chmpx_cntrl.h"
 #include "chmpx_cbs.h"
+#include "chmpx_msgid.h"
+#include "chmpx_msgiter.h"
+#include "chmpx_msgpool.h"
+#include "chmpx_pool.h"
+#include "chmpx_rcvloop.h"
+#include "chmpx_request.h"
+#include "chmpx_sendring.h"
+
+class ChmpxAsyncWorker;
+class ChmpxNode;
+
+//---------------------------------------------------------
+// Per-environment data
+//---------------------------------------------------------
+// [NOTE]
+// This module can be loaded in several environments(main thread
+// and worker_threads), so the data which is shared by all objects
+// in an environment is kept in the instance data of it instead of
+// static variables. It is freed when the environment is torn down.
+//
+struct ChmpxAddonData
+{
+	Napi::FunctionReference	constructor;
+	Napi::FunctionReference	msgid_constructor;
+	Napi::FunctionReference	msgpool_constructor;
+	Napi::FunctionReference	msgiter_constructor;
+	Napi::FunctionReference	sendring_constructor;
+	ChmpxWorkerPool*		pool;
+
+	ChmpxAddonData() : pool(NULL) {}
+	~ChmpxAddonData();
+};
+
+//---------------------------------------------------------
+// Resources of ChmpxNode
+//---------------------------------------------------------
+// [NOTE]
+// ChmpxNode has these by pointers, so that they can be moved
+// to another thread and cleaned up on it, because Clean() of
+// ChmCntrl may block while detaching MQs.
+// Cleanup returns false if the async workers using them are not
+// executed in WAIT_WORKS_MS, then the resources are handed to the
+// last worker(it cleans up and deletes them when it ends), so the
+// caller must not delete them.
+//
+struct ChmpxNodeResources
+{
+	static const int	WAIT_WORKS_MS = 10000;
+
+	std::unique_ptr<ChmpxCntrl>			chmcntrl;
+	std::unique_ptr<ChmpxRequester>		requester;
+	std::shared_ptr<ChmpxThreadList>	threads;
+
+	bool Cleanup(void);
+};
+
+//---------------------------------------------------------
+// Flow control state of ChmpxNode
+//---------------------------------------------------------
+// [NOTE]
+// This is shared with the completion hooks of async workers, so
+// it is alive until all of them are completed. All members are
+// accessed only on JS thread. inflight counts the workers which
+// are submitted and waiting.
+//
+struct ChmpxFlowState
+{
+	ChmpxNode*													node;				// NULL after the object is destroyed
+	size_t														max_inflight;		// 0 means no limit
+	size_t														inflight;
+	bool														need_drain;
+	std::deque<std::pair<ChmpxAsyncWorker*, ChmpxPoolLane>>	waiting;
+
+	explicit ChmpxFlowState(ChmpxNode* pnode) : node(pnode), max_inflight(0), inflight(0), need_drain(false) {}
+};
 
 //---------------------------------------------------------
 // ChmpxNode Class
 //---------------------------------------------------------
 class ChmpxNode : public Napi::ObjectWrap<ChmpxNode>
 {
+	friend class ChmpxMsgPool;
+
 	public:
 		static void Init(Napi::Env env, Napi::Object exports);
 		static Napi::Object NewInstance(Napi::Env env);
 		static Napi::Object NewInstance(Napi::Env env, const Napi::Value& arg);
 
 		static Napi::Object GetInstance(const Napi::CallbackInfo& info);
+		static Napi::Function GetConstructor(Napi::Env env);
+		static ChmpxWorkerPool* GetPool(Napi::Env env);
 
 		// Constructor / Destructor
 		explicit ChmpxNode(const Napi::CallbackInfo& info);
@@ -55,6 +137,7 @@ class ChmpxNode : public Napi::ObjectWrap<ChmpxNode>
 		Napi::Value OnBroadcast(const Napi::CallbackInfo& info);
 		Napi::Value OnReply(const Napi::CallbackInfo& info);
 		Napi::Value OnReceive(const Napi::CallbackInfo& info);
+		Napi::Value OnDrain(const Napi::CallbackInfo& info);
 		Napi::Value Off(const Napi::CallbackInfo& info);
 		Napi::Value OffInitializeOnServer(const Napi::CallbackInfo& info);
 		Napi::Value OffInitializeOnSlave(const Napi::CallbackInfo& info);
@@ -64,25 +147,89 @@ class ChmpxNode : public Napi::ObjectWrap<ChmpxNode>
 		Napi::Value OffBroadcast(const Napi::CallbackInfo& info);
 		Napi::Value OffReply(const Napi::CallbackInfo& info);
 		Napi::Value OffReceive(const Napi::CallbackInfo& info);
+		Napi::Value OffDrain(const Napi::CallbackInfo& info);
 
 		Napi::Value InitializeOnServer(const Napi::CallbackInfo& info);
 		Napi::Value InitializeOnSlave(const Napi::CallbackInfo& info);
 		Napi::Value Send(const Napi::CallbackInfo& info);
 		Napi::Value Broadcast(const Napi::CallbackInfo& info);
+		Napi::Value SendByKey(const Napi::CallbackInfo& info);
+		Napi::Value SendWithHash(const Napi::CallbackInfo& info);
+		Napi::Value SendBatch(const Napi::CallbackInfo& info);
+		Napi::Value BroadcastBatch(const Napi::CallbackInfo& info);
 		Napi::Value Receive(const Napi::CallbackInfo& info);
+		Napi::Value ReceiveBatch(const Napi::CallbackInfo& info);
 		Napi::Value Reply(const Napi::CallbackInfo& info);
 		Napi::Value Open(const Napi::CallbackInfo& info);
 		Napi::Value Close(const Napi::CallbackInfo& info);
+		Napi::Value OpenMsgId(const Napi::CallbackInfo& info);
+		Napi::Value OpenPool(const Napi::CallbackInfo& info);
+		Napi::Value OpenSendRing(const Napi::CallbackInfo& info);
 		Napi::Value IsChmpxExit(const Napi::CallbackInfo& info);
+		Napi::Value StartReceiving(const Napi::CallbackInfo& info);
+		Napi::Value StopReceiving(const Napi::CallbackInfo& info);
+		Napi::Value Messages(const Napi::CallbackInfo& info);
+		Napi::Value SetReceiveOptions(const Napi::CallbackInfo& info);
+		Napi::Value SetFlowOptions(const Napi::CallbackInfo& info);
+		Napi::Value GetStats(const Napi::CallbackInfo& info);
+		Napi::Value ResetStats(const Napi::CallbackInfo& info);
+		Napi::Value Drain(const Napi::CallbackInfo& info);
 
-	public:
-		// constructor reference
-		static Napi::FunctionReference	constructor;
+		Napi::Value SendFast(const Napi::CallbackInfo& info);
+		Napi::Value ReceiveFast(const Napi::CallbackInfo& info);
+		Napi::Value ReplyFast(const Napi::CallbackInfo& info);
+
+		Napi::Value InitializeOnServerAsync(const Napi::CallbackInfo& info);
+		Napi::Value InitializeOnSlaveAsync(const Napi::CallbackInfo& info);
+		Napi::Value SendAsync(const Napi::CallbackInfo& info);
+		Napi::Value BroadcastAsync(const Napi::CallbackInfo& info);
+		Napi::Value ReceiveAsync(const Napi::CallbackInfo& info);
+		Napi::Value ReceiveBatchAsync(const Napi::CallbackInfo& info);
+		Napi::Value ReplyAsync(const Napi::CallbackInfo& info);
+		Napi::Value OpenAsync(const Napi::CallbackInfo& info);
+		Napi::Value CloseAsync(const Napi::CallbackInfo& info);
+		Napi::Value OpenMsgIdAsync(const Napi::CallbackInfo& info);
+		Napi::Value OpenPoolAsync(const Napi::CallbackInfo& info);
+		Napi::Value Request(const Napi::CallbackInfo& info);
+		Napi::Value Destroy(const Napi::CallbackInfo& info);
+		Napi::Value DestroyAsync(const Napi::CallbackInfo& info);
+		Napi::Value DrainAsync(const Napi::CallbackInfo& info);
+
+		Napi::Value InitializeOnAsync(const Napi::CallbackInfo& info, bool is_on_server);
+		Napi::Value SendWithHashCommon(const Napi::CallbackInfo& info, bool is_key);
+		Napi::Value SendBatchCommon(const Napi::CallbackInfo& info, bool is_broadcast);
 
+		static Napi::Value ConfigurePool(const Napi::CallbackInfo& info);
+		static void EnvCleanupHook(void* arg);
+
+		void QueueWorker(ChmpxAsyncWorker* pworker, const ChmpxPoolLane& lane = ChmpxPoolLane(), ChmpxMsgId* pmsgidobj = NULL);
+		void SubmitWorker(ChmpxAsyncWorker* pworker, const ChmpxPoolLane& lane);
+		void SubmitWaitingWorkers(void);
+		void FlushWaitingWorkers(void);
+		void RejectWaitingWorkers(const char* perror);
+		bool CheckFlow(void);
+		bool CheckAccepting(Napi::Env env) const;
+		static void CompleteFlow(const std::shared_ptr<ChmpxFlowState>& flow);
+		ChmpxNodeResources* DetachResources(bool is_renew);
+		Napi::Value DestroyCommon(const Napi::CallbackInfo& info, bool is_promise);
+		Napi::Value DrainCommon(const Napi::CallbackInfo& info, bool is_promise);
+		Napi::Value OpenCommon(const Napi::CallbackInfo& info, bool is_handle);
+		Napi::Value OpenAsyncCommon(const Napi::CallbackInfo& info, bool is_handle);
+		CHMPXBODYTYPE RcvBodyType(void) const { return (_utf8_rcv ? CHMPX_BODY_UTF8 : (_zerocopy_rcv ? CHMPX_BODY_ZEROCOPY : CHMPX_BODY_COPY)); }
+
+	public:
 		StackEmitCB	_cbs;
 
 	private:
-		ChmCntrl	_chmcntrl;
+		std::unique_ptr<ChmpxCntrl>			_chmcntrl;
+		ChmpxReceiveLoopPtr					_rcvloop;			// the last loop started by StartReceiving(it is also in _threads while running)
+		std::unique_ptr<ChmpxRequester>		_requester;
+		std::shared_ptr<ChmpxThreadList>	_threads;			// thread tasks(receiving loop, messages() and send rings) using _chmcntrl
+		bool								_zerocopy_rcv;		// receive option: body buffer wraps chmpx memory without copying
+		bool								_utf8_rcv;			// receive option: body is decoded to string(prior to _zerocopy_rcv)
+		bool								_draining;			// new async operations are rejected
+		bool								_drain_running;		// drain worker is running
+		std::shared_ptr<ChmpxFlowState>		_flow;				// flow control for the workers in send lane
 };
 
 #endif
@@ -24,67 +24,151 @@
 #ifndef CHMPX_NODE_AYNC_H
 #define CHMPX_NODE_AYNC_H
 
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
 #include "chmpx_common.h"
+#include "chmpx_abort.h"
+#include "chmpx_msgid.h"
+#include "chmpx_msgiter.h"
+#include "chmpx_msgpool.h"
+#include "chmpx_rcvdata.h"
+#include "chmpx_rcvloop.h"
+#include "chmpx_request.h"
+#include "chmpx_snddata.h"
 
 //
 // AsyncWorker classes for using ChmpxNode
 //
 
 //---------------------------------------------------------
-// InitializeOnWorker class
+// ChmpxAsyncWorker class
 //
-// Constructor:			constructor(const Napi::Function& callback, ChmCntrl* pobj, const std::string& filename, bool is_auto, bool is_on_server)
-// Callback function:	function(string error)
+// Base class of AsyncWorker classes for ChmpxNode.
+// If the callback function is empty, the worker works in promise
+// mode, and GetPromise() returns the promise for the result.
+//
+// Callback function:	function(string error[, result, ...])
+// Promise:				resolved with undefined(no result), the result or
+//						an array of the results, rejected with Error.
+//
+// Derived classes return the results by overriding GetResult().
+// SetWorkCntrl() makes the worker counted by ChmpxCntrl until it
+// is executed(or deleted without executing), because the worker
+// does not use ChmpxCntrl in the completion callback.
+// SetAbortSignal() attaches AbortSignal, and the derived classes
+// which support it check GetAbortFlag(). When aborted, the promise
+// is rejected with signal.reason(or AbortError).
 //
 //---------------------------------------------------------
-class InitializeOnWorker : public Napi::AsyncWorker
+class ChmpxAsyncWorker : public Napi::AsyncWorker
 {
 	public:
-		InitializeOnWorker(const Napi::Function& callback, ChmCntrl* pobj, const std::string& filename, bool is_auto, bool is_on_server) :
-			Napi::AsyncWorker(callback), _callbackRef(Napi::Persistent(callback)), _chmpxcntrl(pobj), _filename(filename), _is_auto_rejoin(is_auto), _is_server(is_on_server)
+		ChmpxAsyncWorker(Napi::Env env, const Napi::Function& callback) : Napi::AsyncWorker(env, "ChmpxAsyncWorker"), _workcntrl(NULL)
 		{
-			_callbackRef.Ref();
+			if(callback.IsEmpty()){
+				_deferred.emplace(env);
+			}else{
+				_callbackRef = Napi::Persistent(callback);
+				_callbackRef.Ref();
+			}
 		}
 
-		~InitializeOnWorker() override
+		~ChmpxAsyncWorker() override
 		{
 			if(_callbackRef){
 				_callbackRef.Unref();
 				_callbackRef.Reset();
 			}
+			EndWork();
 		}
 
-		// Run on worker thread
-		void Execute() override
+		// [NOTE]
+		// The work is ended on the worker thread just after executing,
+		// so that the cleanup waiting for it is not blocked while the
+		// completion is waiting for JS thread(or never comes when the
+		// environment is tearing down).
+		//
+		void OnExecute(Napi::Env env) override
 		{
-			if(!_chmpxcntrl){
-				SetError("No object is associated to async worker");
-				return;
+			Napi::AsyncWorker::OnExecute(env);
+			EndWork();
+		}
+
+		void SetWorkCntrl(ChmpxCntrl* pcntrl)
+		{
+			_workcntrl = pcntrl;
+			if(_workcntrl){
+				_workcntrl->BeginWork();
 			}
+		}
 
-			_chmpxcntrl->Clean();
-			if(_is_server){
-				if(!_chmpxcntrl->InitializeOnServer(_filename.c_str(), _is_auto_rejoin)){
-					SetError(std::string("Failed to initialize chmpx object on server: ") + _filename);	// call SetError method in Napi::AsyncWorker
-					return;
-				}
+		// The hooks are called on main thread in the added order before the result is passed
+		void AddCompleteHook(const std::function<void(void)>& hook)
+		{
+			if(!_completehook){
+				_completehook = hook;
 			}else{
-				if(!_chmpxcntrl->InitializeOnSlave(_filename.c_str(), _is_auto_rejoin)){
-					SetError(std::string("Failed to initialize chmpx object on slave: ") + _filename);	// call SetError method in Napi::AsyncWorker
-					return;
-				}
+				std::function<void(void)>	prevhook = _completehook;
+				_completehook = [prevhook, hook](){
+					prevhook();
+					hook();
+				};
 			}
 		}
 
+		// Sets the error before queuing, and the worker must be completed without executing
+		void Reject(const std::string& error)
+		{
+			SetError(error);
+		}
+
+		// The signal must be AbortSignal(see ChmpxAbortWatcher::IsSignal)
+		void SetAbortSignal(const Napi::Value& signal)
+		{
+			_abortwatcher.reset(new ChmpxAbortWatcher());
+			_abortwatcher->Attach(Env(), signal);
+		}
+
+		// Returns the promise in promise mode, otherwise undefined
+		Napi::Value GetPromise(void)
+		{
+			if(!_deferred){
+				return Env().Undefined();
+			}
+			return _deferred->Promise();
+		}
+
 		// handler for success
 		void OnOK() override
 		{
 			Napi::Env env = Env();
 			Napi::HandleScope scope(env);
 
-			// The first argument is null and the second argument is the result.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ env.Null() });
+			RunCompleteHook();
+			if(_abortwatcher){
+				_abortwatcher->Detach();
+			}
+			std::vector<napi_value>	results = GetResult(env);
+
+			if(_deferred){
+				// Resolve with the result
+				if(results.empty()){
+					_deferred->Resolve(env.Undefined());
+				}else if(1 == results.size()){
+					_deferred->Resolve(results[0]);
+				}else{
+					Napi::Array	resarr = Napi::Array::New(env, results.size());
+					for(size_t pos = 0; pos < results.size(); ++pos){
+						resarr.Set(static_cast<uint32_t>(pos), results[pos]);
+					}
+					_deferred->Resolve(resarr);
+				}
+			}else if(!_callbackRef.IsEmpty()){
+				// The first argument is null and the after arguments are the result.
+				results.insert(results.begin(), env.Null());
+				_callbackRef.Value().Call(results);
 			}else{
 				Napi::TypeError::New(env, "Internal error in async worker").ThrowAsJavaScriptException();
 			}
@@ -96,8 +180,19 @@ class InitializeOnWorker : public Napi::AsyncWorker
 			Napi::Env env = Env();
 			Napi::HandleScope scope(env);
 
-			// The first argument is the error message.
-			if(!_callbackRef.IsEmpty()){
+			RunCompleteHook();
+			Napi::Value	reason = err.Value();
+			if(_abortwatcher){
+				if(IsAborted()){
+					reason = _abortwatcher->GetReason(env);
+				}
+				_abortwatcher->Detach();
+			}
+			if(_deferred){
+				// Reject with the error object(or abort reason)
+				_deferred->Reject(reason);
+			}else if(!_callbackRef.IsEmpty()){
+				// The first argument is the error message.
 				_callbackRef.Value().Call({ Napi::String::New(env, err.Value().ToString().Utf8Value()) });
 			}else{
 				// Throw error
@@ -105,9 +200,86 @@ class InitializeOnWorker : public Napi::AsyncWorker
 			}
 		}
 
+	protected:
+		// For the derived classes which settle the result by themselves(no callback and no promise)
+		explicit ChmpxAsyncWorker(Napi::Env env) : Napi::AsyncWorker(env, "ChmpxAsyncWorker"), _workcntrl(NULL)
+		{
+		}
+
+		const std::atomic<bool>* GetAbortFlag(void) const
+		{
+			return (_abortwatcher ? _abortwatcher->GetFlag() : NULL);
+		}
+
+		bool IsAborted(void) const
+		{
+			return (_abortwatcher && _abortwatcher->IsAborted());
+		}
+
+		void RunCompleteHook(void)
+		{
+			if(_completehook){
+				_completehook();
+				_completehook = nullptr;
+			}
+		}
+
 	private:
-		Napi::FunctionReference	_callbackRef;
-		ChmCntrl*				_chmpxcntrl;
+		void EndWork(void)
+		{
+			if(_workcntrl){
+				_workcntrl->EndWork();
+				_workcntrl = NULL;
+			}
+		}
+
+	private:
+		Napi::FunctionReference					_callbackRef;
+		std::optional<Napi::Promise::Deferred>	_deferred;
+		ChmpxCntrl*								_workcntrl;
+		std::function<void(void)>				_completehook;
+		std::unique_ptr<ChmpxAbortWatcher>		_abortwatcher;
+};
+
+//---------------------------------------------------------
+// InitializeOnWorker class
+//
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, const std::string& filename, bool is_auto, bool is_on_server)
+// Callback function:	function(string error)
+//
+//---------------------------------------------------------
+class InitializeOnWorker : public ChmpxAsyncWorker
+{
+	public:
+		InitializeOnWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, const std::string& filename, bool is_auto, bool is_on_server) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _filename(filename), _is_auto_rejoin(is_auto), _is_server(is_on_server)
+		{
+		}
+
+		// Run on worker thread
+		void Execute() override
+		{
+			if(!_chmpxcntrl){
+				SetError("No object is associated to async worker");
+				return;
+			}
+
+			_chmpxcntrl->Clean();
+			if(_is_server){
+				if(!_chmpxcntrl->InitializeOnServer(_filename.c_str(), _is_auto_rejoin)){
+					SetError(std::string("Failed to initialize chmpx object on server: ") + _filename);	// call SetError method in Napi::AsyncWorker
+					return;
+				}
+			}else{
+				if(!_chmpxcntrl->InitializeOnSlave(_filename.c_str(), _is_auto_rejoin)){
+					SetError(std::string("Failed to initialize chmpx object on slave: ") + _filename);	// call SetError method in Napi::AsyncWorker
+					return;
+				}
+			}
+		}
+
+	private:
+		ChmpxCntrl*				_chmpxcntrl;
 		std::string				_filename;
 		bool					_is_auto_rejoin;
 		bool					_is_server;
@@ -116,25 +288,20 @@ class InitializeOnWorker : public Napi::AsyncWorker
 //---------------------------------------------------------
 // OpenWorker class
 //
-// Constructor:			constructor(const Napi::Function& callback, ChmCntrl* pobj, bool no_giveup)
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, bool no_giveup, bool is_handle = false)
 // Callback function:	function(string error[, msgid_t msgid]])
 //
+// [NOTE]
+// If is_handle is true, the msgid is returned as ChmpxMsgId handle
+// instead of Buffer.
+//
 //---------------------------------------------------------
-class OpenWorker : public Napi::AsyncWorker
+class OpenWorker : public ChmpxAsyncWorker
 {
 	public:
-		OpenWorker(const Napi::Function& callback, ChmCntrl* pobj, bool no_giveup) :
-			Napi::AsyncWorker(callback), _callbackRef(Napi::Persistent(callback)), _chmpxcntrl(pobj), _no_giveup_rejoin(no_giveup), _msgid(CHM_INVALID_MSGID)
+		OpenWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, bool no_giveup, bool is_handle = false) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _no_giveup_rejoin(no_giveup), _is_handle(is_handle), _msgid(CHM_INVALID_MSGID)
 		{
-			_callbackRef.Ref();
-		}
-
-		~OpenWorker() override
-		{
-			if(_callbackRef){
-				_callbackRef.Unref();
-				_callbackRef.Reset();
-			}
 		}
 
 		// Run on worker thread
@@ -151,64 +318,140 @@ class OpenWorker : public Napi::AsyncWorker
 			}
 		}
 
-		// handler for success
-		void OnOK() override
+		// set results(run on main thread)
+		std::vector<napi_value> GetResult(Napi::Env env) override
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
-
-			// The first argument is null and the second argument is the result.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ env.Null(), Napi::Buffer<char>::Copy(Env(), reinterpret_cast<char*>(&_msgid), static_cast<size_t>(sizeof(_msgid))) });
-			}else{
-				Napi::TypeError::New(env, "Internal error in async worker").ThrowAsJavaScriptException();
+			if(_is_handle){
+				return { ChmpxMsgId::NewInstance(env, _msgid, _chmpxcntrl) };
 			}
+			return { Napi::Buffer<char>::Copy(env, reinterpret_cast<char*>(&_msgid), static_cast<size_t>(sizeof(_msgid))) };
 		}
 
-		// handler for failure (by calling SetError)
-		void OnError(const Napi::Error& err) override
+	private:
+		ChmpxCntrl*				_chmpxcntrl;
+		bool					_no_giveup_rejoin;
+		bool					_is_handle;
+		msgid_t					_msgid;
+};
+
+//---------------------------------------------------------
+// CloseWorker class
+//
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t msgid, const ChmpxRequestChannelPtr& channel)
+// Callback function:	function(string error)
+//
+// [NOTE]
+// If the channel for requests on the msgid is specified, this waits
+// for its thread to exit before closing the msgid.
+//
+//---------------------------------------------------------
+class CloseWorker : public ChmpxAsyncWorker
+{
+	public:
+		CloseWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t msgid, const ChmpxRequestChannelPtr& channel = nullptr) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _close_msgid(msgid), _channel(channel)
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
+		}
 
-			// The first argument is the error message.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ Napi::String::New(env, err.Value().ToString().Utf8Value()) });
-			}else{
-				// Throw error
-				err.ThrowAsJavaScriptException();
+		// Run on worker thread
+		void Execute() override
+		{
+			if(!_chmpxcntrl){
+				SetError("No object is associated to async worker");
+				return;
+			}
+
+			// wait for the thread receiving replies on the msgid
+			if(_channel){
+				_channel->Wait();
+			}
+
+			if(false == _chmpxcntrl->Close(_close_msgid)){
+				SetError(std::string("Failed to close msgid."));
+				return;
 			}
 		}
 
 	private:
-		Napi::FunctionReference	_callbackRef;
-		ChmCntrl*				_chmpxcntrl;
-		bool					_no_giveup_rejoin;
-		msgid_t					_msgid;
+		ChmpxCntrl*				_chmpxcntrl;
+		msgid_t					_close_msgid;
+		ChmpxRequestChannelPtr	_channel;
 };
 
 //---------------------------------------------------------
-// CloseWorker class
+// OpenPoolWorker class
 //
-// Constructor:			constructor(const Napi::Function& callback, ChmCntrl* pobj, msgid_t msgid)
-// Callback function:	function(string error)
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, const Napi::Object& nodeobj, size_t count, bool no_giveup)
+// Callback function:	function(string error[, ChmpxMsgPool pool])
 //
 //---------------------------------------------------------
-class CloseWorker : public Napi::AsyncWorker
+class OpenPoolWorker : public ChmpxAsyncWorker
 {
 	public:
-		CloseWorker(const Napi::Function& callback, ChmCntrl* pobj, msgid_t msgid) :
-			Napi::AsyncWorker(callback), _callbackRef(Napi::Persistent(callback)), _chmpxcntrl(pobj), _close_msgid(msgid)
+		OpenPoolWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, const Napi::Object& nodeobj, size_t count, bool no_giveup) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _nodeRef(Napi::Persistent(nodeobj)), _count(count), _no_giveup_rejoin(no_giveup)
 		{
-			_callbackRef.Ref();
 		}
 
-		~CloseWorker() override
+		// Run on worker thread
+		void Execute() override
 		{
-			if(_callbackRef){
-				_callbackRef.Unref();
-				_callbackRef.Reset();
+			if(!_chmpxcntrl){
+				SetError("No object is associated to async worker");
+				return;
 			}
+
+			if(!ChmpxOpenMsgIds(_chmpxcntrl, _count, _no_giveup_rejoin, _msgids)){
+				SetError(std::string("Failed to open msgids for pool."));
+				return;
+			}
+		}
+
+		// set results(run on main thread)
+		std::vector<napi_value> GetResult(Napi::Env env) override
+		{
+			return { ChmpxMsgPool::NewInstance(env, _nodeRef.Value(), _msgids) };
+		}
+
+	private:
+		ChmpxCntrl*				_chmpxcntrl;
+		Napi::ObjectReference	_nodeRef;
+		size_t					_count;
+		bool					_no_giveup_rejoin;
+		std::vector<msgid_t>	_msgids;
+};
+
+//---------------------------------------------------------
+// ClosePoolWorker class
+//
+// Constructor:			constructor(Napi::Env env, const ChmpxPoolCloseStatePtr& state, ChmpxCntrl* pobj, msgid_t msgid, const ChmpxRequestChannelPtr& channel)
+// Callback function:	function(string error)
+//
+// [NOTE]
+// This worker closes one msgid in the pool, and is queued in the
+// send lane of the msgid so that it runs after the sends queued
+// before it. It waits for the thread of the channel for requests
+// on the msgid to exit before closing it.
+// The workers for all msgids in the pool share the state, and the
+// last completed one calls the callback only once.
+//
+//---------------------------------------------------------
+struct ChmpxPoolCloseState
+{
+	Napi::FunctionReference	callbackRef;
+	size_t					remaining;
+	std::string				error;
+
+	ChmpxPoolCloseState(const Napi::Function& callback, size_t count) : callbackRef(Napi::Persistent(callback)), remaining(count) {}
+};
+typedef std::shared_ptr<ChmpxPoolCloseState>	ChmpxPoolCloseStatePtr;
+
+class ClosePoolWorker : public ChmpxAsyncWorker
+{
+	public:
+		ClosePoolWorker(Napi::Env env, const ChmpxPoolCloseStatePtr& state, ChmpxCntrl* pobj, msgid_t msgid, const ChmpxRequestChannelPtr& channel) :
+			ChmpxAsyncWorker(env), _state(state), _chmpxcntrl(pobj), _msgid(msgid), _channel(channel)
+		{
 		}
 
 		// Run on worker thread
@@ -219,69 +462,195 @@ class CloseWorker : public Napi::AsyncWorker
 				return;
 			}
 
-			if(false == _chmpxcntrl->Close(_close_msgid)){
-				SetError(std::string("Failed to close msgid."));
+			// wait for the thread receiving replies on the msgid
+			if(_channel){
+				_channel->Wait();
+			}
+
+			if(!_chmpxcntrl->Close(_msgid)){
+				SetError(std::string("Failed to close msgids in pool."));
 				return;
 			}
 		}
 
-		// handler for success
+		// handler for success(run on main thread)
 		void OnOK() override
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
+			RunCompleteHook();
+			Settle();
+		}
 
-			// The first argument is null and the second argument is the result.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ env.Null() });
+		// handler for failure(run on main thread)
+		void OnError(const Napi::Error& err) override
+		{
+			RunCompleteHook();
+			if(_state && _state->error.empty()){
+				_state->error = err.Message();
+			}
+			Settle();
+		}
+
+	private:
+		void Settle(void)
+		{
+			if(!_state || 0 == _state->remaining || 0 < --(_state->remaining)){
+				return;
+			}
+			Napi::Env			env = Env();
+			Napi::HandleScope	scope(env);
+			if(_state->error.empty()){
+				_state->callbackRef.Value().Call({ env.Null() });
 			}else{
-				Napi::TypeError::New(env, "Internal error in async worker").ThrowAsJavaScriptException();
+				_state->callbackRef.Value().Call({ Napi::String::New(env, _state->error) });
 			}
 		}
 
-		// handler for failure (by calling SetError)
-		void OnError(const Napi::Error& err) override
+	private:
+		ChmpxPoolCloseStatePtr	_state;
+		ChmpxCntrl*				_chmpxcntrl;
+		msgid_t					_msgid;
+		ChmpxRequestChannelPtr	_channel;
+};
+
+//---------------------------------------------------------
+// CleanupWorker class
+//
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, const std::function<bool(void)>& cleanup)
+// Callback function:	function(string error)
+//
+// [NOTE]
+// This worker runs the cleanup function which may block(ex.
+// draining async workers and detaching MQs) off JS thread.
+// The cleanup function returns false if it could not finish.
+// It must not be queued to the worker thread pool, because the
+// cleanup may wait for the workers on it.
+//
+//---------------------------------------------------------
+class CleanupWorker : public ChmpxAsyncWorker
+{
+	public:
+		CleanupWorker(Napi::Env env, const Napi::Function& callback, const std::function<bool(void)>& cleanup) :
+			ChmpxAsyncWorker(env, callback), _cleanup(cleanup)
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
+		}
 
-			// The first argument is the error message.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ Napi::String::New(env, err.Value().ToString().Utf8Value()) });
-			}else{
-				// Throw error
-				err.ThrowAsJavaScriptException();
+		// Run on worker thread
+		void Execute() override
+		{
+			if(!_cleanup){
+				SetError("No cleanup function is associated to async worker");
+				return;
+			}
+			if(!_cleanup()){
+				SetError("Timeout waiting for the async workers, the resources are cleaned up after them.");
 			}
 		}
 
 	private:
-		Napi::FunctionReference	_callbackRef;
-		ChmCntrl*				_chmpxcntrl;
-		msgid_t					_close_msgid;
+		std::function<bool(void)>	_cleanup;
 };
 
 //---------------------------------------------------------
-// SendWorker class
+// DrainWorker class
 //
-// Constructor:			constructor(const Napi::Function& callback, ChmCntrl* pobj, msgid_t send_msgid, unsigned char* pbinptr, ssize_t binsize, chmhash_t binhash, bool is_routing)
-// Callback function:	function(string error[, int receivercount])
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, ChmpxThreadList* pthreads, ChmpxRequester* prequester, const Napi::Object& nodeobj, int timeout)
+// Callback function:	function(string error[, object result])
+// Result:				{ flushed: number, abandoned: number, closed: number }
+//
+// [NOTE]
+// This worker must be queued to the libuv thread pool, because it
+// waits for the workers on the worker thread pool. The workers
+// are counted until they are deleted on JS thread, so it must not
+// run on JS thread. The node object is referenced until this is
+// completed, so that the resources are not freed during draining.
+// The msgids are closed only if all workers are flushed, because
+// the abandoned workers may be still using them.
+// The requests in flight at the completion are rejected and they
+// are counted as abandoned.
 //
 //---------------------------------------------------------
-class SendWorker : public Napi::AsyncWorker
+class DrainWorker : public ChmpxAsyncWorker
 {
 	public:
-		SendWorker(const Napi::Function& callback, ChmCntrl* pobj, msgid_t send_msgid, unsigned char* pbinptr, ssize_t binsize, chmhash_t binhash, bool is_routing) :
-			Napi::AsyncWorker(callback), _callbackRef(Napi::Persistent(callback)), _chmpxcntrl(pobj), _msgid(send_msgid), _pbin(pbinptr), _length(binsize), _hash(binhash), _routing(is_routing), _recievercnt(-1)
+		DrainWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, ChmpxThreadList* pthreads, ChmpxRequester* prequester, const Napi::Object& nodeobj, int timeout) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _threads(pthreads), _requester(prequester), _nodeRef(Napi::Persistent(nodeobj)), _timeout_ms(timeout), _flushed(0), _abandoned(0), _closed(0)
 		{
-			_callbackRef.Ref();
 		}
 
-		~SendWorker() override
+		// Run on worker thread
+		void Execute() override
 		{
-			if(_callbackRef){
-				_callbackRef.Unref();
-				_callbackRef.Reset();
+			if(!_chmpxcntrl){
+				SetError("No object is associated to async worker");
+				return;
+			}
+
+			// stop background receiving(and sending)
+			if(_threads){
+				_threads->StopAll();
 			}
+
+			// wait for workers
+			size_t	outstanding	= _chmpxcntrl->GetWorkCount();
+			size_t	remaining	= _chmpxcntrl->WaitWorks(_timeout_ms);
+			_flushed			= (remaining < outstanding ? (outstanding - remaining) : 0);
+			_abandoned			= remaining;
+
+			// close msgids
+			if(0 == remaining){
+				_closed = _chmpxcntrl->CloseAll();
+			}
+		}
+
+		// set results(run on main thread)
+		std::vector<napi_value> GetResult(Napi::Env env) override
+		{
+			if(_requester){
+				size_t	pending = _requester->GetPendingCount();
+				if(0 < pending){
+					_requester->CancelAll(env, "The object is drained.");
+					_abandoned += pending;
+				}
+			}
+
+			Napi::Object	result = Napi::Object::New(env);
+			result.Set("flushed",	Napi::Number::New(env, static_cast<double>(_flushed)));
+			result.Set("abandoned",	Napi::Number::New(env, static_cast<double>(_abandoned)));
+			result.Set("closed",	Napi::Number::New(env, static_cast<double>(_closed)));
+			return { result };
+		}
+
+	private:
+		ChmpxCntrl*				_chmpxcntrl;
+		ChmpxThreadList*		_threads;
+		ChmpxRequester*			_requester;
+		Napi::ObjectReference	_nodeRef;
+		int						_timeout_ms;
+		size_t					_flushed;
+		size_t					_abandoned;
+		size_t					_closed;
+};
+
+//---------------------------------------------------------
+// SendWorker class
+//
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t send_msgid, const Napi::Object& bodyobj, unsigned char* pbinptr, ssize_t binsize, chmhash_t binhash, bool is_routing)
+// Callback function:	function(string error[, int receivercount])
+//
+// [NOTE]
+// bodyobj is the Buffer which has pbinptr, and it is referenced
+// until the worker is completed. So the caller does not need to
+// copy the Buffer, but must not modify it until completion.
+// If the body is gathered from an array, DetachBody() moves it
+// into the worker.
+//
+//---------------------------------------------------------
+class SendWorker : public ChmpxAsyncWorker
+{
+	public:
+		SendWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t send_msgid, const Napi::Object& bodyobj, unsigned char* pbinptr, ssize_t binsize, chmhash_t binhash, bool is_routing) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _msgid(send_msgid), _bodyRef(Napi::Persistent(bodyobj)), _pbin(pbinptr), _length(binsize), _hash(binhash), _routing(is_routing), _recievercnt(-1)
+		{
 		}
 
 		// Run on worker thread
@@ -299,68 +668,135 @@ class SendWorker : public Napi::AsyncWorker
 			}
 		}
 
-		// handler for success
-		void OnOK() override
+		// set results(run on main thread)
+		std::vector<napi_value> GetResult(Napi::Env env) override
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
+			return { Napi::Number::New(env, static_cast<int32_t>(_recievercnt)) };
+		}
 
-			// The first argument is null and the second argument is the result.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ env.Null(), Napi::Number::New(env, static_cast<int32_t>(_recievercnt)) });
-			}else{
-				Napi::TypeError::New(env, "Internal error in async worker").ThrowAsJavaScriptException();
+		// [NOTE]
+		// If the body is gathered from the pieces, it is moved into this
+		// worker. This must be called before the worker is queued.
+		//
+		void DetachBody(ChmpxSndBody& body)
+		{
+			body.Detach(_gathered);
+		}
+
+	private:
+		ChmpxCntrl*					_chmpxcntrl;
+		msgid_t						_msgid;
+		Napi::ObjectReference		_bodyRef;
+		std::vector<unsigned char>	_gathered;
+		unsigned char*				_pbin;
+		ssize_t						_length;
+		chmhash_t					_hash;
+		bool						_routing;
+		long						_recievercnt;
+};
+
+//---------------------------------------------------------
+// RequestWorker class
+//
+// Constructor:			constructor(Napi::Env env, ChmpxCntrl* pobj, const ChmpxRequestChannelPtr& channel, uint64_t reqid, msgid_t send_msgid, unsigned char* pbinptr, ssize_t binsize, bool is_routing)
+//
+// [NOTE]
+// This worker sends the request data which has the request header
+// in front of the body. It has no callback and no promise, because
+// the Promise of the request is settled by the channel when the
+// reply arrives. If sending failed, the request is canceled.
+// The hash value is calculated from the body without the request
+// header, so the request is routed as same as Send.
+//
+//---------------------------------------------------------
+class RequestWorker : public ChmpxAsyncWorker
+{
+	public:
+		RequestWorker(Napi::Env env, ChmpxCntrl* pobj, const ChmpxRequestChannelPtr& channel, uint64_t reqid, msgid_t send_msgid, unsigned char* pbinptr, ssize_t binsize, bool is_routing) :
+			ChmpxAsyncWorker(env), _chmpxcntrl(pobj), _channel(channel), _reqid(reqid), _msgid(send_msgid), _pbin(pbinptr), _length(binsize), _routing(is_routing)
+		{
+		}
+
+		// Run on worker thread
+		void Execute() override
+		{
+			if(!_chmpxcntrl){
+				SetError("No object is associated to async worker");
+				return;
+			}
+			if(!_pbin || _length < static_cast<ssize_t>(CHMPX_REQHDR_SIZE)){
+				SetError("Wrong request data is specified.");
+				return;
+			}
+
+			ChmBinData	bindata;
+			long		recievercnt = 0;
+			bindata.Set(_pbin + CHMPX_REQHDR_SIZE, static_cast<size_t>(_length) - CHMPX_REQHDR_SIZE);
+			if(!_chmpxcntrl->Send(_msgid, _pbin, _length, bindata.GetHash(), &recievercnt, _routing)){
+				SetError(std::string("Failed to send request data."));
+				return;
 			}
 		}
 
-		// handler for failure (by calling SetError)
+		// handler for success(run on main thread)
+		void OnOK() override
+		{
+			RunCompleteHook();
+		}
+
+		// handler for failure(run on main thread)
 		void OnError(const Napi::Error& err) override
 		{
 			Napi::Env env = Env();
 			Napi::HandleScope scope(env);
 
-			// The first argument is the error message.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ Napi::String::New(env, err.Value().ToString().Utf8Value()) });
-			}else{
-				// Throw error
-				err.ThrowAsJavaScriptException();
+			RunCompleteHook();
+			if(_channel){
+				_channel->CancelRequest(env, _reqid, err.Message().c_str());
 			}
 		}
 
+		// [NOTE]
+		// The body which is gathered after the headroom for the request
+		// header is moved into this worker. This must be called before
+		// the worker is queued.
+		//
+		void DetachBody(ChmpxSndBody& body)
+		{
+			body.Detach(_gathered);
+		}
+
 	private:
-		Napi::FunctionReference	_callbackRef;
-		ChmCntrl*				_chmpxcntrl;
-		msgid_t					_msgid;
-		unsigned char*			_pbin;
-		ssize_t					_length;
-		chmhash_t				_hash;
-		bool					_routing;
-		long					_recievercnt;
+		ChmpxCntrl*					_chmpxcntrl;
+		ChmpxRequestChannelPtr		_channel;
+		uint64_t					_reqid;
+		msgid_t						_msgid;
+		std::vector<unsigned char>	_gathered;
+		unsigned char*				_pbin;
+		ssize_t						_length;
+		bool						_routing;
 };
 
 //---------------------------------------------------------
 // BroadcastWorker class
 //
-// Constructor:			constructor(const Napi::Function& callback, ChmCntrl* pobj, msgid_t send_msgid, unsigned char* pbinptr, ssize_t binsize, chmhash_t binhash)
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t send_msgid, const Napi::Object& bodyobj, unsigned char* pbinptr, ssize_t binsize, chmhash_t binhash)
 // Callback function:	function(string error[, int receivercount])
 //
+// [NOTE]
+// bodyobj is the Buffer which has pbinptr, and it is referenced
+// until the worker is completed. So the caller does not need to
+// copy the Buffer, but must not modify it until completion.
+// If the body is gathered from an array, DetachBody() moves it
+// into the worker.
+//
 //---------------------------------------------------------
-class BroadcastWorker : public Napi::AsyncWorker
+class BroadcastWorker : public ChmpxAsyncWorker
 {
 	public:
-		BroadcastWorker(const Napi::Function& callback, ChmCntrl* pobj, msgid_t send_msgid, unsigned char* pbinptr, ssize_t binsize, chmhash_t binhash) :
-			Napi::AsyncWorker(callback), _callbackRef(Napi::Persistent(callback)), _chmpxcntrl(pobj), _msgid(send_msgid), _pbin(pbinptr), _length(binsize), _hash(binhash), _recievercnt(-1)
-		{
-			_callbackRef.Ref();
-		}
-
-		~BroadcastWorker() override
+		BroadcastWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t send_msgid, const Napi::Object& bodyobj, unsigned char* pbinptr, ssize_t binsize, chmhash_t binhash) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _msgid(send_msgid), _bodyRef(Napi::Persistent(bodyobj)), _pbin(pbinptr), _length(binsize), _hash(binhash), _recievercnt(-1)
 		{
-			if(_callbackRef){
-				_callbackRef.Unref();
-				_callbackRef.Reset();
-			}
 		}
 
 		// Run on worker thread
@@ -378,67 +814,51 @@ class BroadcastWorker : public Napi::AsyncWorker
 			}
 		}
 
-		// handler for success
-		void OnOK() override
+		// set results(run on main thread)
+		std::vector<napi_value> GetResult(Napi::Env env) override
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
-
-			// The first argument is null and the second argument is the result.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ env.Null(), Napi::Number::New(env, static_cast<int32_t>(_recievercnt)) });
-			}else{
-				Napi::TypeError::New(env, "Internal error in async worker").ThrowAsJavaScriptException();
-			}
+			return { Napi::Number::New(env, static_cast<int32_t>(_recievercnt)) };
 		}
 
-		// handler for failure (by calling SetError)
-		void OnError(const Napi::Error& err) override
+		// [NOTE]
+		// If the body is gathered from the pieces, it is moved into this
+		// worker. This must be called before the worker is queued.
+		//
+		void DetachBody(ChmpxSndBody& body)
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
-
-			// The first argument is the error message.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ Napi::String::New(env, err.Value().ToString().Utf8Value()) });
-			}else{
-				// Throw error
-				err.ThrowAsJavaScriptException();
-			}
+			body.Detach(_gathered);
 		}
 
 	private:
-		Napi::FunctionReference	_callbackRef;
-		ChmCntrl*				_chmpxcntrl;
-		msgid_t					_msgid;
-		unsigned char*			_pbin;
-		ssize_t					_length;
-		chmhash_t				_hash;
-		long					_recievercnt;
+		ChmpxCntrl*					_chmpxcntrl;
+		msgid_t						_msgid;
+		Napi::ObjectReference		_bodyRef;
+		std::vector<unsigned char>	_gathered;
+		unsigned char*				_pbin;
+		ssize_t						_length;
+		chmhash_t					_hash;
+		long						_recievercnt;
 };
 
 //---------------------------------------------------------
-// ReplyWorker class
+// SendBatchWorker class
 //
-// Constructor:			constructor(const Napi::Function& callback, ChmCntrl* pobj, PCOMPKT compkt, unsigned char* pbinptr, ssize_t binsize)
-// Callback function:	function(string error)
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t send_msgid, const chmpxsndlist_t& sndlist, const Napi::Array& bodies, bool is_broadcast, bool is_routing)
+// Callback function:	function(string error[, Int32Array receivercounts])
+//
+// [NOTE]
+// bodies is the array of Buffers in sndlist, and it is referenced
+// until the worker is completed. The bodies which are gathered
+// (string or array of pieces) are moved into this worker by
+// DetachBodies().
 //
 //---------------------------------------------------------
-class ReplyWorker : public Napi::AsyncWorker
+class SendBatchWorker : public ChmpxAsyncWorker
 {
 	public:
-		ReplyWorker(const Napi::Function& callback, ChmCntrl* pobj, PCOMPKT compkt, unsigned char* pbinptr, ssize_t binsize) :
-			Napi::AsyncWorker(callback), _callbackRef(Napi::Persistent(callback)), _chmpxcntrl(pobj), _pComPkt(compkt), _pbin(pbinptr), _length(binsize)
-		{
-			_callbackRef.Ref();
-		}
-
-		~ReplyWorker() override
+		SendBatchWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t send_msgid, const chmpxsndlist_t& sndlist, const Napi::Array& bodies, bool is_broadcast, bool is_routing) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _msgid(send_msgid), _sndlist(sndlist), _bodiesRef(Napi::Persistent(bodies)), _broadcast(is_broadcast), _routing(is_routing)
 		{
-			if(_callbackRef){
-				_callbackRef.Unref();
-				_callbackRef.Reset();
-			}
 		}
 
 		// Run on worker thread
@@ -449,78 +869,124 @@ class ReplyWorker : public Napi::AsyncWorker
 				return;
 			}
 
-			if(!_chmpxcntrl->Reply(_pComPkt, _pbin, _length)){
-				SetError(std::string("Failed to broadcast data."));
+			if(!ChmpxSendDataList(_chmpxcntrl, _msgid, _sndlist, _broadcast, _routing, _counts)){
+				SetError(std::string(_broadcast ? "Failed to broadcast data." : "Failed to send data."));
 				return;
 			}
 		}
 
-		// handler for success
-		void OnOK() override
+		// set results(run on main thread)
+		std::vector<napi_value> GetResult(Napi::Env env) override
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
+			return { ChmpxSendCountsToArray(env, _counts) };
+		}
+
+		// [NOTE]
+		// The gathered bodies which are pointed by the send list are
+		// moved into this worker. This must be called before the worker
+		// is queued.
+		//
+		void DetachBodies(chmpxsndbufs_t& gathered)
+		{
+			_gathered.swap(gathered);
+		}
 
-			// The first argument is null and the second argument is the result.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ env.Null() });
+	private:
+		ChmpxCntrl*				_chmpxcntrl;
+		msgid_t					_msgid;
+		chmpxsndlist_t			_sndlist;
+		Napi::ObjectReference	_bodiesRef;
+		chmpxsndbufs_t			_gathered;
+		bool					_broadcast;
+		bool					_routing;
+		chmpxsndcnts_t			_counts;
+};
+
+//---------------------------------------------------------
+// ReplyWorker class
+//
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, PCOMPKT compkt, const Napi::Object& bodyobj, unsigned char* pbinptr, ssize_t binsize)
+// Callback function:	function(string error)
+//
+// [NOTE]
+// bodyobj is the Buffer which has pbinptr, and it is referenced
+// until the worker is completed. So the caller does not need to
+// copy the Buffer, but must not modify it until completion.
+// If the body is gathered from an array(or has the request header
+// in the headroom), DetachBody() moves it into the worker.
+//
+//---------------------------------------------------------
+class ReplyWorker : public ChmpxAsyncWorker
+{
+	public:
+		ReplyWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, PCOMPKT compkt, const Napi::Object& bodyobj, unsigned char* pbinptr, ssize_t binsize) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _bodyRef(Napi::Persistent(bodyobj)), _pbin(pbinptr), _length(binsize)
+		{
+			// [NOTE]
+			// compkt may be on the caller's stack, so it is copied here.
+			//
+			if(compkt){
+				_compkt = *compkt;
 			}else{
-				Napi::TypeError::New(env, "Internal error in async worker").ThrowAsJavaScriptException();
+				memset(&_compkt, 0, sizeof(COMPKT));
 			}
 		}
 
-		// handler for failure (by calling SetError)
-		void OnError(const Napi::Error& err) override
+		// Run on worker thread
+		void Execute() override
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
+			if(!_chmpxcntrl){
+				SetError("No object is associated to async worker");
+				return;
+			}
 
-			// The first argument is the error message.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ Napi::String::New(env, err.Value().ToString().Utf8Value()) });
-			}else{
-				// Throw error
-				err.ThrowAsJavaScriptException();
+			if(!_chmpxcntrl->Reply(&_compkt, _pbin, _length)){
+				SetError(std::string("Failed to broadcast data."));
+				return;
 			}
 		}
 
+		// [NOTE]
+		// If the body is gathered from the pieces, it is moved into this
+		// worker. This must be called before the worker is queued.
+		//
+		void DetachBody(ChmpxSndBody& body)
+		{
+			body.Detach(_gathered);
+		}
+
 	private:
-		Napi::FunctionReference	_callbackRef;
-		ChmCntrl*				_chmpxcntrl;
-		PCOMPKT					_pComPkt;
-		unsigned char*			_pbin;
-		ssize_t					_length;
+		ChmpxCntrl*					_chmpxcntrl;
+		COMPKT						_compkt;
+		Napi::ObjectReference		_bodyRef;
+		std::vector<unsigned char>	_gathered;
+		unsigned char*				_pbin;
+		ssize_t						_length;
 };
 
 //---------------------------------------------------------
 // ReceiveWorker class
 //
-// Constructor:			constructor(const Napi::Function& callback, ChmCntrl* pobj, int timeout, bool no_giveup)
-// 						constructor(const Napi::Function& callback, ChmCntrl* pobj, msgid_t rcv_msgid, int timeout)
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, int timeout, bool no_giveup, CHMPXBODYTYPE bodytype)
+// 						constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t rcv_msgid, int timeout, CHMPXBODYTYPE bodytype)
 // Callback function:	function(string error[, binary compkt, buffer data])
 //
 //---------------------------------------------------------
-class ReceiveWorker : public Napi::AsyncWorker
+class ReceiveWorker : public ChmpxAsyncWorker
 {
 	public:
-		ReceiveWorker(const Napi::Function& callback, ChmCntrl* pobj, int timeout, bool no_giveup) :
-			Napi::AsyncWorker(callback), _callbackRef(Napi::Persistent(callback)), _chmpxcntrl(pobj), _is_server(true), _msgid(CHM_INVALID_MSGID), _timeout_ms(timeout), _no_giveup_rejoin(no_giveup), _pComPkt(NULL), _pBody(NULL), _length(0)
+		ReceiveWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, int timeout, bool no_giveup, CHMPXBODYTYPE bodytype) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _is_server(true), _msgid(CHM_INVALID_MSGID), _timeout_ms(timeout), _no_giveup_rejoin(no_giveup), _bodytype(bodytype), _pComPkt(NULL), _pBody(NULL), _length(0), _has_reqid(false), _reqid(0)
 		{
-			_callbackRef.Ref();
 		}
 
-		ReceiveWorker(const Napi::Function& callback, ChmCntrl* pobj, msgid_t rcv_msgid, int timeout) :
-			Napi::AsyncWorker(callback), _callbackRef(Napi::Persistent(callback)), _chmpxcntrl(pobj), _is_server(false), _msgid(rcv_msgid), _timeout_ms(timeout), _no_giveup_rejoin(false), _pComPkt(NULL), _pBody(NULL), _length(0)
+		ReceiveWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t rcv_msgid, int timeout, CHMPXBODYTYPE bodytype) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _is_server(false), _msgid(rcv_msgid), _timeout_ms(timeout), _no_giveup_rejoin(false), _bodytype(bodytype), _pComPkt(NULL), _pBody(NULL), _length(0), _has_reqid(false), _reqid(0)
 		{
-			_callbackRef.Ref();
 		}
 
 		~ReceiveWorker() override
 		{
-			if(_callbackRef){
-				_callbackRef.Unref();
-				_callbackRef.Reset();
-			}
 			CHM_Free(_pComPkt);
 			CHM_Free(_pBody);
 		}
@@ -536,57 +1002,96 @@ class ReceiveWorker : public Napi::AsyncWorker
 			// receive
 			bool	result;
 			if(_is_server){
-				result = _chmpxcntrl->Receive(&_pComPkt, &_pBody, &_length, _timeout_ms, _no_giveup_rejoin);
+				result = _chmpxcntrl->Receive(&_pComPkt, &_pBody, &_length, _timeout_ms, _no_giveup_rejoin, GetAbortFlag());
 			}else{
-				result = _chmpxcntrl->Receive(_msgid, &_pComPkt, &_pBody, &_length, _timeout_ms);
+				result = _chmpxcntrl->Receive(_msgid, &_pComPkt, &_pBody, &_length, _timeout_ms, GetAbortFlag());
 			}
+			// [NOTE]
+			// The abort is reported only when nothing was received, so the
+			// data which libchmpx has already handed over is not lost.
+			//
 			if(!result || !_pComPkt || !_pBody || 0 == _length){
-				SetError(std::string("Failed to receive data."));
+				SetError(std::string(IsAborted() ? "The operation was aborted." : "Failed to receive data."));
 				return;
 			}
+			if(_is_server && _chmpxcntrl->IsReqHeader()){
+				_has_reqid = ChmpxStripReqHeader(_pBody, _length, _reqid);
+			}
 		}
 
-		// handler for success
-		void OnOK() override
+		// set results(run on main thread)
+		std::vector<napi_value> GetResult(Napi::Env env) override
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
+			Napi::Value	pktBuf	= ChmpxCreatePktBuffer(env, _pComPkt, _has_reqid, _reqid);
+			Napi::Value	bodyBuf	= ChmpxCreateBodyBuffer(env, _pBody, _length, _bodytype);
+			return { pktBuf, bodyBuf };
+		}
 
-			// The first argument is null and the second argument is the result.
-			if(!_callbackRef.IsEmpty()){
-				Napi::Value	pktBuf	= Napi::Buffer<char>::Copy(env, reinterpret_cast<char*>(_pComPkt), static_cast<size_t>(sizeof(COMPKT)));
-				Napi::Value	bodyBuf	= Napi::Buffer<char>::Copy(env, reinterpret_cast<char*>(_pBody), static_cast<size_t>(_length));
-				_callbackRef.Value().Call({ env.Null(), pktBuf, bodyBuf });
-			}else{
-				Napi::TypeError::New(env, "Internal error in async worker").ThrowAsJavaScriptException();
-			}
+	private:
+		ChmpxCntrl*				_chmpxcntrl;
+		bool					_is_server;
+		msgid_t					_msgid;
+		int						_timeout_ms;
+		bool					_no_giveup_rejoin;
+		CHMPXBODYTYPE			_bodytype;
+		PCOMPKT					_pComPkt;
+		unsigned char*			_pBody;
+		size_t					_length;
+		bool					_has_reqid;
+		uint64_t				_reqid;
+};
+
+//---------------------------------------------------------
+// ReceiveBatchWorker class
+//
+// Constructor:			constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, size_t maxcount, int timeout, bool no_giveup, CHMPXBODYTYPE bodytype)
+// 						constructor(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t rcv_msgid, size_t maxcount, int timeout, CHMPXBODYTYPE bodytype)
+// Callback function:	function(string error[, array [[binary compkt, buffer data], ...]])
+//
+//---------------------------------------------------------
+class ReceiveBatchWorker : public ChmpxAsyncWorker
+{
+	public:
+		ReceiveBatchWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, size_t maxcount, int timeout, bool no_giveup, CHMPXBODYTYPE bodytype) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _is_server(true), _msgid(CHM_INVALID_MSGID), _maxcount(maxcount), _timeout_ms(timeout), _no_giveup_rejoin(no_giveup), _bodytype(bodytype)
+		{
 		}
 
-		// handler for failure (by calling SetError)
-		void OnError(const Napi::Error& err) override
+		ReceiveBatchWorker(Napi::Env env, const Napi::Function& callback, ChmpxCntrl* pobj, msgid_t rcv_msgid, size_t maxcount, int timeout, CHMPXBODYTYPE bodytype) :
+			ChmpxAsyncWorker(env, callback), _chmpxcntrl(pobj), _is_server(false), _msgid(rcv_msgid), _maxcount(maxcount), _timeout_ms(timeout), _no_giveup_rejoin(false), _bodytype(bodytype)
 		{
-			Napi::Env env = Env();
-			Napi::HandleScope scope(env);
+		}
 
-			// The first argument is the error message.
-			if(!_callbackRef.IsEmpty()){
-				_callbackRef.Value().Call({ Napi::String::New(env, err.Value().ToString().Utf8Value()) });
-			}else{
-				// Throw error
-				err.ThrowAsJavaScriptException();
+		// Run on worker thread
+		void Execute() override
+		{
+			if(!_chmpxcntrl){
+				SetError("No object is associated to async worker");
+				return;
+			}
+
+			// receive
+			if(!ChmpxReceiveDataList(_chmpxcntrl, _is_server, _msgid, _maxcount, _timeout_ms, _no_giveup_rejoin, _rcvlist, GetAbortFlag())){
+				SetError(std::string(IsAborted() ? "The operation was aborted." : "Failed to receive data."));
+				return;
 			}
 		}
 
+		// set results(run on main thread)
+		std::vector<napi_value> GetResult(Napi::Env env) override
+		{
+			return { ChmpxRcvDataListToArray(env, _rcvlist, _bodytype) };
+		}
+
 	private:
-		Napi::FunctionReference	_callbackRef;
-		ChmCntrl*				_chmpxcntrl;
+		ChmpxCntrl*				_chmpxcntrl;
 		bool					_is_server;
 		msgid_t					_msgid;
+		size_t					_maxcount;
 		int						_timeout_ms;
 		bool					_no_giveup_rejoin;
-		PCOMPKT					_pComPkt;
-		unsigned char*			_pBody;
-		size_t					_length;
+		CHMPXBODYTYPE			_bodytype;
+		chmpxrcvlist_t			_rcvlist;
 };
 
 #endif
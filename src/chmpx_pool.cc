@@ -0,0 +1,394 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include <algorithm>
+#include <pthread.h>
+#include <system_error>
+#include "chmpx_pool.h"
+#include "chmpx_node_async.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// ChmpxWorkerPool Class
+//---------------------------------------------------------
+const char*	ChmpxWorkerPool::DEFAULT_THREAD_NAME = "chmpx-pool";
+
+ChmpxWorkerPool::ChmpxWorkerPool(Napi::Env env) : pool_env(env), pending_count(0), pool_size(ChmpxWorkerPool::DEFAULT_POOL_SIZE), thread_name(ChmpxWorkerPool::DEFAULT_THREAD_NAME), max_per_owner(ChmpxWorkerPool::DEFAULT_MAX_PER_OWNER), coalesce(ChmpxWorkerPool::DEFAULT_COALESCE), generation(0), thread_count(0), live_threads(0), stop_request(false)
+{
+	tsfn = PoolTsfn::New(env, "ChmpxWorkerPool", 0, 1, this);
+	tsfn.Unref(env);			// no pending worker
+}
+
+ChmpxWorkerPool::~ChmpxWorkerPool()
+{
+	// [NOTE]
+	// This waits for the workers which are running(also on the
+	// retired threads), so a blocking call without timeout delays
+	// the tear down.
+	// The workers remaining in the queue(and the executed workers
+	// which could not be passed to JS thread) are deleted without
+	// calling their callbacks, because JS can not be called while
+	// the environment is tearing down. Deleting them ends their
+	// works counted in ChmpxCntrl, so that the cleanup waiting for
+	// them is not blocked.
+	//
+	StopThreads();
+
+	std::vector<ChmpxAsyncWorker*>	workers;
+	{
+		std::lock_guard<std::mutex>	guard(pool_lock);
+		for(chmpxpooltasks_t::const_iterator iter = tasks.begin(); iter != tasks.end(); ++iter){
+			workers.push_back(iter->pworker);
+		}
+		tasks.clear();
+	}
+	{
+		std::lock_guard<std::mutex>	guard(completed_lock);
+		workers.insert(workers.end(), completed.begin(), completed.end());
+		completed.clear();
+	}
+	for(std::vector<ChmpxAsyncWorker*>::const_iterator iter = workers.begin(); iter != workers.end(); ++iter){
+		delete *iter;
+	}
+	tsfn.Release();
+}
+
+//
+// Run on JS thread
+//
+// [NOTE]
+// env is null when the ThreadSafeFunction is finalizing with
+// remaining data, then the worker can not be completed and it is
+// deleted without calling its callback. context may be already
+// deleted at that time, so it is not used.
+// pworker is null for the notification of the completed queue.
+//
+void ChmpxWorkerPool::CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxWorkerPool* context, ChmpxAsyncWorker* pworker)
+{
+	if(nullptr == static_cast<napi_env>(env)){
+		delete pworker;
+		return;
+	}
+	if(!context){
+		return;
+	}
+	if(!pworker){
+		context->FlushCompleted(env);
+		return;
+	}
+
+	// complete worker(calls OnOK or OnError, and deletes worker)
+	pworker->OnWorkComplete(env, napi_ok);
+
+	if(0 < context->pending_count && 0 == --context->pending_count){
+		context->tsfn.Unref(env);
+	}
+}
+
+bool ChmpxWorkerPool::Configure(size_t size, const std::string& name, size_t max_per_owner_count, bool is_coalesce)
+{
+	if(0 == size){
+		return false;
+	}
+	RetireThreads();
+
+	{
+		std::lock_guard<std::mutex>	guard(pool_lock);
+		pool_size		= size;
+		thread_name		= name.empty() ? ChmpxWorkerPool::DEFAULT_THREAD_NAME : name;
+		max_per_owner	= max_per_owner_count;
+	}
+	coalesce = is_coalesce;
+
+	// restart threads if there are queued workers
+	if(0 < pending_count){
+		return StartThreads();
+	}
+	return true;
+}
+
+bool ChmpxWorkerPool::Queue(ChmpxAsyncWorker* pworker, const void* owner, const ChmpxPoolLane& lane)
+{
+	if(!pworker){
+		return false;
+	}
+	if(0 == thread_count && !StartThreads()){
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex>	guard(pool_lock);
+		tasks.push_back({pworker, owner, lane});
+	}
+	if(0 == pending_count++){
+		tsfn.Ref(Napi::Env(pool_env));
+	}
+	pool_cond.notify_one();
+
+	return true;
+}
+
+//
+// [NOTE]
+// This is used for the worker which is rejected before executing,
+// so that its callback(or Promise) is settled asynchronously as
+// same as the executed workers.
+//
+bool ChmpxWorkerPool::Complete(ChmpxAsyncWorker* pworker)
+{
+	if(!pworker){
+		return false;
+	}
+	if(0 == pending_count++){
+		tsfn.Ref(Napi::Env(pool_env));
+	}
+	bool	result = (coalesce.load() ? PushCompleted(pworker) : (napi_ok == tsfn.NonBlockingCall(pworker)));
+	if(!result){
+		if(0 == --pending_count){
+			tsfn.Unref(Napi::Env(pool_env));
+		}
+		return false;
+	}
+	return true;
+}
+
+bool ChmpxWorkerPool::StartThreads(void)
+{
+	std::lock_guard<std::mutex>	guard(pool_lock);
+
+	stop_request = false;
+	for(size_t cnt = thread_count; cnt < pool_size; ++cnt){
+		try{
+			std::thread(&ChmpxWorkerPool::Run, this, cnt, generation).detach();
+		}catch(const std::system_error& err){
+			if(0 == thread_count){
+				return false;
+			}
+			break;				// works with the threads which are already started
+		}
+		++thread_count;
+		++live_threads;
+	}
+	return true;
+}
+
+//
+// [NOTE]
+// The retired threads exit after their running workers without
+// taking new workers, and this does not wait for them.
+//
+void ChmpxWorkerPool::RetireThreads(void)
+{
+	{
+		std::lock_guard<std::mutex>	guard(pool_lock);
+		++generation;
+		thread_count = 0;
+	}
+	pool_cond.notify_all();
+}
+
+//
+// [NOTE]
+// This waits for all threads including the retired threads, because
+// they use this object until they exit.
+//
+void ChmpxWorkerPool::StopThreads(void)
+{
+	std::unique_lock<std::mutex>	guard(pool_lock);
+	stop_request = true;
+	pool_cond.notify_all();
+
+	exit_cond.wait(guard, [this]{ return (0 == live_threads); });
+	thread_count = 0;
+}
+
+//
+// [NOTE]
+// Must be called with locking pool_lock
+// The skipped task keeps its position, and all tasks behind it
+// in the same owner or lane are also skipped for the same reason,
+// so the order in the lane is kept.
+//
+bool ChmpxWorkerPool::PopRunnableTask(ChmpxPoolTask& task)
+{
+	for(chmpxpooltasks_t::iterator iter = tasks.begin(); iter != tasks.end(); ++iter){
+		if(0 != max_per_owner){
+			chmpxpoolrunning_t::const_iterator	riter = running.find(iter->owner);
+			if(running.end() != riter && max_per_owner <= riter->second){
+				continue;		// the owner reaches the limit
+			}
+		}
+		if(CHMPX_LANE_NONE != iter->lane.type && busy_lanes.end() != busy_lanes.find(std::make_pair(iter->owner, iter->lane))){
+			continue;			// the lane is busy
+		}
+		task = *iter;
+		tasks.erase(iter);
+		++running[task.owner];
+		if(CHMPX_LANE_NONE != task.lane.type){
+			busy_lanes.insert(std::make_pair(task.owner, task.lane));
+		}
+		return true;
+	}
+	return false;
+}
+
+//
+// Run on pool thread
+//
+void ChmpxWorkerPool::Run(size_t index, uint64_t thread_generation)
+{
+	// set thread name(up to 15 characters, the name may be changed by Configure)
+	std::string	name;
+	{
+		std::lock_guard<std::mutex>	guard(pool_lock);
+		name = thread_name + "-" + std::to_string(index);
+	}
+	if(15 < name.length()){
+		name = name.substr(name.length() - 15);
+	}
+	pthread_setname_np(pthread_self(), name.c_str());
+
+	std::unique_lock<std::mutex>	guard(pool_lock);
+	while(true){
+		ChmpxPoolTask	task = {NULL, NULL, ChmpxPoolLane()};
+		pool_cond.wait(guard, [this, &task, thread_generation]{ return (stop_request || thread_generation != generation || PopRunnableTask(task)); });
+		if(!task.pworker){
+			break;				// stop request(or retired)
+		}
+		guard.unlock();
+
+		// execute worker(calls Execute)
+		task.pworker->OnExecute(Napi::Env(pool_env));
+
+		guard.lock();
+		chmpxpoolrunning_t::iterator	riter = running.find(task.owner);
+		if(running.end() != riter && 0 == --(riter->second)){
+			running.erase(riter);
+		}
+		if(CHMPX_LANE_NONE != task.lane.type){
+			busy_lanes.erase(std::make_pair(task.owner, task.lane));
+		}
+		guard.unlock();
+
+		// the other workers of this owner(and lane) may be runnable
+		pool_cond.notify_all();
+
+		// complete worker on JS thread
+		if(coalesce.load() ? !PushCompleted(task.pworker) : (napi_ok != tsfn.BlockingCall(task.pworker))){
+			// [NOTE]
+			// The environment is tearing down, the worker can not be
+			// completed nor deleted on this thread. It is kept in the
+			// completed queue without notification, and is deleted by
+			// the destructor.
+			//
+			std::lock_guard<std::mutex>	guard(completed_lock);
+			completed.push_back(task.pworker);
+		}
+
+		guard.lock();
+		if(stop_request || thread_generation != generation){
+			break;
+		}
+	}
+
+	// [NOTE]
+	// This object is not accessed after unlocking, because the
+	// destructor may free it then.
+	//
+	--live_threads;
+	exit_cond.notify_all();
+}
+
+//
+// Put the executed worker into the completed queue
+//
+// [NOTE]
+// The ThreadSafeFunction is called only when the queue becomes not
+// empty, and the following workers are completed by the same call.
+// If the call failed(the environment is tearing down), the worker is
+// removed from the queue and returns false.
+//
+bool ChmpxWorkerPool::PushCompleted(ChmpxAsyncWorker* pworker)
+{
+	bool	is_first;
+	{
+		std::lock_guard<std::mutex>	guard(completed_lock);
+		is_first = completed.empty();
+		completed.push_back(pworker);
+	}
+	if(is_first && napi_ok != tsfn.NonBlockingCall(NULL)){
+		std::lock_guard<std::mutex>	guard(completed_lock);
+		std::vector<ChmpxAsyncWorker*>::iterator	iter = std::find(completed.begin(), completed.end(), pworker);
+		if(completed.end() != iter){
+			completed.erase(iter);
+		}
+		return false;
+	}
+	return true;
+}
+
+//
+// Run on JS thread
+//
+// [NOTE]
+// The queue is swapped out, so the workers which are executed while
+// completing these are queued with a new notification.
+// If a callback throws, the exception is taken and reported as the
+// uncaught exception before completing the next worker. Otherwise
+// the pending exception makes all the following callbacks(and the
+// Promises) fail without being called.
+//
+void ChmpxWorkerPool::FlushCompleted(Napi::Env env)
+{
+	std::vector<ChmpxAsyncWorker*>	workers;
+	{
+		std::lock_guard<std::mutex>	guard(completed_lock);
+		workers.swap(completed);
+	}
+
+	Napi::HandleScope	scope(env);
+	for(std::vector<ChmpxAsyncWorker*>::const_iterator iter = workers.begin(); iter != workers.end(); ++iter){
+		// complete worker(calls OnOK or OnError, and deletes worker)
+		(*iter)->OnWorkComplete(env, napi_ok);
+
+		if(env.IsExceptionPending()){
+			Napi::Error	error = env.GetAndClearPendingException();
+			napi_fatal_exception(env, error.Value());
+		}
+	}
+	if(0 < pending_count){
+		pending_count = (workers.size() < pending_count ? (pending_count - workers.size()) : 0);
+		if(0 == pending_count){
+			tsfn.Unref(env);
+		}
+	}
+}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,188 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_POOL_H
+#define CHMPX_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "chmpx_common.h"
+
+class ChmpxAsyncWorker;
+
+//---------------------------------------------------------
+// Lane for ordering workers
+//---------------------------------------------------------
+// [NOTE]
+// The workers which have the same lane of the same owner run one
+// at a time in the queued order, and the workers in different
+// lanes run in parallel. CHMPX_LANE_NONE means no ordering.
+//
+typedef enum chmpx_pool_lane_type{
+	CHMPX_LANE_NONE = 0,				// no ordering(initialize, open, etc)
+	CHMPX_LANE_SEND,					// send, broadcast and close on msgid
+	CHMPX_LANE_RECEIVE,					// receive on msgid(or on server)
+	CHMPX_LANE_REPLY					// reply on server
+}CHMPXLANETYPE;
+
+struct ChmpxPoolLane
+{
+	CHMPXLANETYPE	type;
+	uint64_t		id;					// msgid(CHM_INVALID_MSGID on server)
+
+	explicit ChmpxPoolLane(CHMPXLANETYPE lanetype = CHMPX_LANE_NONE, uint64_t laneid = 0) : type(lanetype), id(laneid) {}
+
+	bool operator<(const ChmpxPoolLane& other) const
+	{
+		return (type != other.type ? (type < other.type) : (id < other.id));
+	}
+};
+
+//---------------------------------------------------------
+// ChmpxWorkerPool Class
+//---------------------------------------------------------
+// [NOTE]
+// This class runs ChmpxAsyncWorker objects on its own threads
+// instead of the libuv thread pool, so that blocking chmpx calls
+// (ex. receive with timeout) never starve fs/crypto/dns.
+// The worker is executed on the pool thread, and is completed
+// (OnOK/OnError, and deleted) on the JS thread through the
+// ThreadSafeFunction.
+// The ThreadSafeFunction is referenced only while there are
+// pending workers, so the pool does not keep the event loop
+// alive when it is idle.
+//
+// The pool is created for each environment(main thread and
+// worker_threads), and is kept in the instance data of it.
+//
+// The threads are detached and counted. Configure retires the
+// running threads by the generation without waiting for them, and
+// each of them exits after its running worker(so JS thread is not
+// blocked by a long receiving). The destructor waits for all of
+// threads including the retired threads.
+//
+// The maximum number of workers which run at the same time for
+// one owner(ChmpxNode) can be limited by max_per_owner(0 means
+// no limit). The other workers of the owner wait in the queue.
+// The workers are also ordered by the lane(see ChmpxPoolLane),
+// and a worker whose lane is busy waits in the queue without
+// blocking the workers behind it in the other lanes.
+//
+// If coalesce is true, the executed workers are put into the
+// completed queue and the ThreadSafeFunction is called only when
+// the queue becomes not empty. Then all workers in the queue are
+// completed in one call on JS thread, so many completions in a
+// loop turn cost one dispatch instead of one for each worker.
+//
+class ChmpxWorkerPool
+{
+	public:
+		static const size_t	DEFAULT_POOL_SIZE		= 4;
+		static const size_t	DEFAULT_MAX_PER_OWNER	= 0;			// no limit
+		static const bool	DEFAULT_COALESCE		= false;
+		static const char*	DEFAULT_THREAD_NAME;
+
+	protected:
+		typedef struct chmpx_pool_task{
+			ChmpxAsyncWorker*	pworker;
+			const void*			owner;
+			ChmpxPoolLane		lane;
+		}ChmpxPoolTask;
+
+		typedef std::deque<ChmpxPoolTask>								chmpxpooltasks_t;
+		typedef std::map<const void*, size_t>							chmpxpoolrunning_t;
+		typedef std::set<std::pair<const void*, ChmpxPoolLane>>			chmpxpoollanes_t;
+
+		static void CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxWorkerPool* context, ChmpxAsyncWorker* pworker);
+
+	public:
+		typedef Napi::TypedThreadSafeFunction<ChmpxWorkerPool, ChmpxAsyncWorker, ChmpxWorkerPool::CallJs>	PoolTsfn;
+
+		explicit ChmpxWorkerPool(Napi::Env env);
+		virtual ~ChmpxWorkerPool();
+
+		// Configure retires running threads(does not wait for them), and new threads are started by next Queue
+		bool Configure(size_t size, const std::string& name, size_t max_per_owner, bool is_coalesce);
+
+		// Queue must be called on JS thread, returns false if the worker could not be queued(and it is not deleted)
+		bool Queue(ChmpxAsyncWorker* pworker, const void* owner, const ChmpxPoolLane& lane = ChmpxPoolLane());
+
+		// Complete must be called on JS thread, the worker is completed on JS thread later without executing it
+		bool Complete(ChmpxAsyncWorker* pworker);
+
+		size_t GetSize(void) const { return pool_size; }
+		std::string GetThreadName(void) const { return thread_name; }
+		size_t GetMaxPerOwner(void) const { return max_per_owner; }
+		bool IsCoalesce(void) const { return coalesce.load(); }
+		size_t GetPendingCount(void) const { return pending_count; }
+
+	protected:
+		bool StartThreads(void);
+		void RetireThreads(void);
+		void StopThreads(void);
+		bool PopRunnableTask(ChmpxPoolTask& task);
+		void Run(size_t index, uint64_t thread_generation);
+		bool PushCompleted(ChmpxAsyncWorker* pworker);
+		void FlushCompleted(Napi::Env env);
+
+	protected:
+		napi_env				pool_env;
+		PoolTsfn				tsfn;
+		size_t					pending_count;			// accessed only on JS thread
+
+		size_t					pool_size;
+		std::string				thread_name;
+		size_t					max_per_owner;
+		std::atomic<bool>		coalesce;
+
+		std::mutex				pool_lock;
+		std::condition_variable	pool_cond;
+		chmpxpooltasks_t		tasks;
+		chmpxpoolrunning_t		running;
+		chmpxpoollanes_t		busy_lanes;
+		std::condition_variable	exit_cond;
+		uint64_t				generation;				// threads of older generation are retired
+		size_t					thread_count;			// threads of current generation
+		size_t					live_threads;			// all threads including retired threads
+		bool					stop_request;
+
+		std::mutex				completed_lock;
+		std::vector<ChmpxAsyncWorker*>	completed;		// executed workers waiting for completion(coalesce mode)
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
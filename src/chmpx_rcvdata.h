@@ -0,0 +1,226 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_RCVDATA_H
+#define CHMPX_RCVDATA_H
+
+#include <memory>
+#include <vector>
+#include "chmpx_common.h"
+#include "chmpx_cntrl.h"
+#include "chmpx_reqhdr.h"
+
+//---------------------------------------------------------
+// Structure for received data
+//---------------------------------------------------------
+// [NOTE]
+// The destructor frees the buffers allocated by libchmpx.
+// has_reqid is set when the request header is stripped from
+// the body on server side(only if the requestHeader receive
+// option is enabled).
+//
+struct ChmpxRcvData
+{
+	std::string		error;				// not empty means error
+	PCOMPKT			pComPkt;
+	unsigned char*	pBody;
+	size_t			length;
+	bool			has_reqid;
+	uint64_t		reqid;
+
+	ChmpxRcvData() : pComPkt(NULL), pBody(NULL), length(0), has_reqid(false), reqid(0) {}
+	ChmpxRcvData(PCOMPKT compkt, unsigned char* pbody, size_t bodylen) : pComPkt(compkt), pBody(pbody), length(bodylen), has_reqid(false), reqid(0) {}
+	~ChmpxRcvData()
+	{
+		CHM_Free(pComPkt);
+		CHM_Free(pBody);
+	}
+};
+
+typedef std::vector<std::unique_ptr<ChmpxRcvData>>	chmpxrcvlist_t;
+
+//---------------------------------------------------------
+// Type of received body value
+//---------------------------------------------------------
+typedef enum chmpx_body_type{
+	CHMPX_BODY_COPY		= 0,			// Buffer which has the copy of body(default)
+	CHMPX_BODY_ZEROCOPY,				// Buffer which wraps the memory allocated by libchmpx
+	CHMPX_BODY_UTF8						// String which is decoded from UTF-8 body
+}CHMPXBODYTYPE;
+
+//---------------------------------------------------------
+// Utility functions for received data
+//---------------------------------------------------------
+//
+// Receive one data
+//
+// [NOTE]
+// Returns false if failed to receive(or aborted by pabort), and
+// returns true with null pointer in ppdata when timeouted.
+// On server side, the request header is stripped from the body
+// if the receive option is enabled(see ChmpxCntrl::IsReqHeader).
+//
+inline bool ChmpxReceiveData(ChmpxCntrl* pchmcntrl, bool is_server, msgid_t msgid, int timeout_ms, bool no_giveup_rejoin, ChmpxRcvData** ppdata, const std::atomic<bool>* pabort = NULL)
+{
+	PCOMPKT			pComPkt	= NULL;
+	unsigned char*	pBody	= NULL;
+	size_t			length	= 0;
+	bool			result;
+
+	*ppdata = NULL;
+	if(is_server){
+		result = pchmcntrl->Receive(&pComPkt, &pBody, &length, timeout_ms, no_giveup_rejoin, pabort);
+	}else{
+		result = pchmcntrl->Receive(msgid, &pComPkt, &pBody, &length, timeout_ms, pabort);
+	}
+	if(!result || !pComPkt){
+		CHM_Free(pComPkt);
+		CHM_Free(pBody);
+		return result;
+	}
+	*ppdata = new ChmpxRcvData(pComPkt, pBody, length);
+	if(is_server && pchmcntrl->IsReqHeader()){
+		(*ppdata)->has_reqid = ChmpxStripReqHeader((*ppdata)->pBody, (*ppdata)->length, (*ppdata)->reqid);
+	}
+	return true;
+}
+
+//
+// Receive data up to maxcount
+//
+// [NOTE]
+// Only the first receiving waits for timeout_ms, and the following
+// receiving does not wait, so this returns the data which have
+// been already queued.
+// Returns false only if failed to receive before getting any data.
+//
+inline bool ChmpxReceiveDataList(ChmpxCntrl* pchmcntrl, bool is_server, msgid_t msgid, size_t maxcount, int timeout_ms, bool no_giveup_rejoin, chmpxrcvlist_t& rcvlist, const std::atomic<bool>* pabort = NULL)
+{
+	for(size_t cnt = 0; cnt < maxcount; ++cnt){
+		ChmpxRcvData*	pdata = NULL;
+		if(!ChmpxReceiveData(pchmcntrl, is_server, msgid, (0 == cnt ? timeout_ms : 0), no_giveup_rejoin, &pdata, pabort)){
+			return !rcvlist.empty();
+		}
+		if(!pdata){
+			break;			// timeouted or no more data
+		}
+		rcvlist.emplace_back(pdata);
+	}
+	return true;
+}
+
+//
+// Create compkt Buffer
+//
+// [NOTE]
+// If the received data was a request, the request header is put
+// after COMPKT, and Reply uses it.
+//
+inline Napi::Value ChmpxCreatePktBuffer(Napi::Env env, const COMPKT* pComPkt, bool has_reqid, uint64_t reqid)
+{
+	if(!has_reqid){
+		return Napi::Buffer<char>::Copy(env, reinterpret_cast<const char*>(pComPkt), static_cast<size_t>(sizeof(COMPKT)));
+	}
+	Napi::Buffer<unsigned char>	pktBuf = Napi::Buffer<unsigned char>::New(env, sizeof(COMPKT) + CHMPX_REQHDR_SIZE);
+	memcpy(pktBuf.Data(), pComPkt, sizeof(COMPKT));
+	ChmpxSetReqHeader(pktBuf.Data() + sizeof(COMPKT), reqid);
+	return pktBuf;
+}
+
+//
+// Create Buffers from received data
+//
+inline Napi::Value ChmpxRcvDataToPktBuffer(Napi::Env env, const ChmpxRcvData& data)
+{
+	return ChmpxCreatePktBuffer(env, data.pComPkt, data.has_reqid, data.reqid);
+}
+
+//
+// Create body Buffer(or String)
+//
+// [NOTE]
+// If bodytype is CHMPX_BODY_UTF8, the body is decoded to String
+// directly without the intermediate Buffer.
+// If bodytype is CHMPX_BODY_ZEROCOPY, the Buffer is created as an external
+// buffer over the memory allocated by libchmpx and takes the
+// ownership of it(pBody is set null). The memory is freed by
+// the finalizer of the Buffer, and the size is reported to GC
+// by AdjustExternalMemory while the Buffer is alive.
+// If external buffers are not allowed in the runtime, NewOrCopy
+// copies the data and calls the finalizer immediately.
+//
+inline Napi::Value ChmpxCreateBodyBuffer(Napi::Env env, unsigned char*& pBody, size_t length, CHMPXBODYTYPE bodytype)
+{
+	if(CHMPX_BODY_UTF8 == bodytype){
+		if(!pBody || 0 == length){
+			return Napi::String::New(env, "");
+		}
+		return Napi::String::New(env, reinterpret_cast<const char*>(pBody), length);
+	}
+	if(!pBody || 0 == length){
+		return Napi::Buffer<unsigned char>::New(env, 0);
+	}
+	if(CHMPX_BODY_ZEROCOPY != bodytype){
+		return Napi::Buffer<unsigned char>::Copy(env, pBody, length);
+	}
+
+	unsigned char*	pOwned = pBody;
+	pBody = NULL;
+	Napi::MemoryManagement::AdjustExternalMemory(env, static_cast<int64_t>(length));
+
+	return Napi::Buffer<unsigned char>::NewOrCopy(env, pOwned, length, [length](Napi::Env finalize_env, unsigned char* pdata)
+	{
+		CHM_Free(pdata);
+		Napi::MemoryManagement::AdjustExternalMemory(finalize_env, -static_cast<int64_t>(length));
+	});
+}
+
+inline Napi::Value ChmpxRcvDataToBodyBuffer(Napi::Env env, ChmpxRcvData& data, CHMPXBODYTYPE bodytype)
+{
+	return ChmpxCreateBodyBuffer(env, data.pBody, data.length, bodytype);
+}
+
+//
+// Create Array([[compkt, body], ...]) from received data list
+//
+inline Napi::Array ChmpxRcvDataListToArray(Napi::Env env, chmpxrcvlist_t& rcvlist, CHMPXBODYTYPE bodytype)
+{
+	Napi::Array	result = Napi::Array::New(env, rcvlist.size());
+	for(size_t pos = 0; pos < rcvlist.size(); ++pos){
+		Napi::Array	pair = Napi::Array::New(env, 2);
+		pair.Set(static_cast<uint32_t>(0), ChmpxRcvDataToPktBuffer(env, *rcvlist[pos]));
+		pair.Set(static_cast<uint32_t>(1), ChmpxRcvDataToBodyBuffer(env, *rcvlist[pos], bodytype));
+		result.Set(static_cast<uint32_t>(pos), pair);
+	}
+	return result;
+}
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
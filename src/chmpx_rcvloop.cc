@@ -0,0 +1,185 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include <memory>
+#include <system_error>
+#include "chmpx_rcvloop.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// ChmpxReceiveLoop Class
+//---------------------------------------------------------
+ChmpxReceiveLoop::ChmpxReceiveLoop(ChmpxCntrl* pobj, bool server, msgid_t msgid, int timeout, bool no_giveup, CHMPXBODYTYPE type) :
+	pchmcntrl(pobj), is_server(server), rcv_msgid(server ? CHM_INVALID_MSGID : msgid), timeout_ms((0 < timeout) ? timeout : ChmpxReceiveLoop::DEFAULT_TIMEOUT_MS), no_giveup_rejoin(server ? no_giveup : false), bodytype(type), is_exited(true), is_started(false), is_running(false), stop_request(false)
+{
+}
+
+//
+// [NOTE]
+// This object is freed after the thread exits, because the
+// ThreadSafeFunction keeps it until then.
+//
+ChmpxReceiveLoop::~ChmpxReceiveLoop()
+{
+	RequestStop();
+}
+
+//
+// Run on JS thread
+//
+// [NOTE]
+// env is null when the ThreadSafeFunction is finalizing with
+// remaining data, then only the data is freed.
+// The context is alive while the calls remain, because the
+// finalizer which frees it is called after them.
+//
+void ChmpxReceiveLoop::CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxReceiveLoop* context, ChmpxRcvData* pdata)
+{
+	std::unique_ptr<ChmpxRcvData>	data(pdata);
+	if(!data || !context || nullptr == static_cast<napi_env>(env) || jsCallback.IsEmpty()){
+		return;
+	}
+
+	if(!data->error.empty()){
+		jsCallback.Call({ Napi::String::New(env, data->error) });
+	}else{
+		jsCallback.Call({ env.Null(), ChmpxRcvDataToPktBuffer(env, *data), ChmpxRcvDataToBodyBuffer(env, *data, context->bodytype) });
+	}
+}
+
+//
+// Run on JS thread
+//
+// [NOTE]
+// The holder keeps this object alive until all queued calls are
+// done and the thread exits.
+//
+void ChmpxReceiveLoop::Finalize(Napi::Env env, std::shared_ptr<ChmpxReceiveLoop>* pholder, ChmpxReceiveLoop* context)
+{
+	delete pholder;
+}
+
+//
+// [NOTE]
+// This object is added to the thread list before the thread starts,
+// so that the thread can remove it when exiting.
+//
+bool ChmpxReceiveLoop::Start(Napi::Env env, const Napi::Function& cb, const std::shared_ptr<ChmpxThreadList>& list)
+{
+	if(!pchmcntrl || !list || is_started){
+		return false;
+	}
+	is_started	= true;
+	threadlist	= list;
+	tsfn		= RcvTsfn::New(env, cb, "ChmpxReceiveLoop", 0, 1, this, &ChmpxReceiveLoop::Finalize, new std::shared_ptr<ChmpxReceiveLoop>(shared_from_this()));
+
+	{
+		std::lock_guard<std::mutex>	guard(exit_lock);
+		is_exited = false;
+	}
+	stop_request	= false;
+	is_running		= true;
+	list->Add(shared_from_this());
+	try{
+		std::thread(&ChmpxReceiveLoop::Run, this).detach();
+	}catch(const std::system_error& err){
+		list->Remove(shared_from_this());
+		is_running = false;
+		{
+			std::lock_guard<std::mutex>	guard(exit_lock);
+			is_exited = true;
+		}
+		tsfn.Release();
+		return false;
+	}
+	return true;
+}
+
+void ChmpxReceiveLoop::RequestStop(void)
+{
+	stop_request = true;
+}
+
+bool ChmpxReceiveLoop::Stop(void)
+{
+	bool	was_running = IsRunning();
+
+	RequestStop();
+
+	std::unique_lock<std::mutex>	guard(exit_lock);
+	exit_cond.wait(guard, [this]{ return is_exited; });
+	return was_running;
+}
+
+//
+// Run on receiving thread
+//
+void ChmpxReceiveLoop::Run(void)
+{
+	while(!stop_request.load()){
+		ChmpxRcvData*	pdata	= NULL;
+		bool			result	= ChmpxReceiveData(pchmcntrl, is_server, rcv_msgid, timeout_ms, no_giveup_rejoin, &pdata, &stop_request);
+		if(result && !pdata){
+			continue;			// timeouted(or aborted)
+		}
+		if(!result){
+			if(stop_request.load()){
+				break;
+			}
+			pdata			= new ChmpxRcvData;
+			pdata->error	= "Failed to receive data.";
+		}
+		if(napi_ok != tsfn.BlockingCall(pdata)){
+			delete pdata;
+			break;
+		}
+		if(!result){
+			break;
+		}
+	}
+	is_running = false;
+
+	// [NOTE]
+	// The thread list and ThreadSafeFunction keep this object, and
+	// the ThreadSafeFunction is released at last.
+	//
+	std::shared_ptr<ChmpxThreadList>	list = threadlist.lock();
+	if(list){
+		list->Remove(shared_from_this());
+	}
+	{
+		std::lock_guard<std::mutex>	guard(exit_lock);
+		is_exited = true;
+	}
+	exit_cond.notify_all();
+	tsfn.Release();
+}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
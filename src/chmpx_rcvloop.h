@@ -0,0 +1,113 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_RCVLOOP_H
+#define CHMPX_RCVLOOP_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "chmpx_common.h"
+#include "chmpx_rcvdata.h"
+#include "chmpx_thrlist.h"
+
+//---------------------------------------------------------
+// ChmpxReceiveLoop Class
+//---------------------------------------------------------
+// [NOTE]
+// This class runs one dedicated thread which loops on
+// ChmCntrl::Receive, and each received message is passed
+// to the JS callback through the ThreadSafeFunction.
+// The timeout value is used as the polling interval, so a
+// negative value(wait forever) is replaced by the default
+// value. The receiving is done in slices with the stop flag,
+// so the thread notices the stop request after ABORT_SLICE_MS
+// at most.
+//
+// This object is started only once(ChmpxNode creates a new one
+// for each StartReceiving). The thread is detached, and this
+// object is kept alive by the ThreadSafeFunction until its
+// finalizer, so the queued calls never refer to the freed object.
+// This object is in the thread list of ChmpxNode while the thread
+// is running, and the thread removes it when exiting. So that JS
+// thread(StopReceiving) only requests to stop by RequestStop, and
+// the node still waits for the thread by the thread list before
+// its ChmpxCntrl is freed.
+//
+class ChmpxReceiveLoop : public ChmpxThreadTask, public std::enable_shared_from_this<ChmpxReceiveLoop>
+{
+	public:
+		static const int	DEFAULT_TIMEOUT_MS = 100;
+
+	protected:
+		static void CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxReceiveLoop* context, ChmpxRcvData* pdata);
+		static void Finalize(Napi::Env env, std::shared_ptr<ChmpxReceiveLoop>* pholder, ChmpxReceiveLoop* context);
+
+	public:
+		typedef Napi::TypedThreadSafeFunction<ChmpxReceiveLoop, ChmpxRcvData, ChmpxReceiveLoop::CallJs>	RcvTsfn;
+
+		ChmpxReceiveLoop(ChmpxCntrl* pobj, bool is_server, msgid_t msgid, int timeout_ms, bool no_giveup, CHMPXBODYTYPE type);
+		virtual ~ChmpxReceiveLoop();
+
+		// Run on JS thread(returns false if failed to start)
+		bool Start(Napi::Env env, const Napi::Function& cb, const std::shared_ptr<ChmpxThreadList>& threadlist);
+
+		// Run on any thread
+		void RequestStop(void);										// does not wait for the thread
+		bool Stop(void) override;									// waits for the thread
+		bool IsRunning(void) const { return is_running.load(); }
+
+	protected:
+		void Run(void);
+
+	protected:
+		ChmpxCntrl*						pchmcntrl;
+		bool							is_server;
+		msgid_t							rcv_msgid;
+		int								timeout_ms;
+		bool							no_giveup_rejoin;
+		CHMPXBODYTYPE					bodytype;
+
+		RcvTsfn							tsfn;
+		std::weak_ptr<ChmpxThreadList>	threadlist;
+		std::mutex						exit_lock;
+		std::condition_variable			exit_cond;
+		bool							is_exited;				// under exit_lock
+		bool							is_started;				// only on JS thread
+		std::atomic<bool>				is_running;
+		std::atomic<bool>				stop_request;
+};
+
+typedef std::shared_ptr<ChmpxReceiveLoop>	ChmpxReceiveLoopPtr;
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
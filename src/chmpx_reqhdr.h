@@ -0,0 +1,118 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_REQHDR_H
+#define CHMPX_REQHDR_H
+
+#include <cstring>
+#include <vector>
+#include "chmpx_common.h"
+
+//---------------------------------------------------------
+// Request header for request/reply correlation
+//---------------------------------------------------------
+// [NOTE]
+// ChmpxNode::Request puts this header in front of the body,
+// and the server side which enables the requestHeader receive
+// option strips it from the received body and keeps it after
+// COMPKT in the compkt Buffer. Then Reply puts
+// the same header in front of the reply body, so the slave
+// side can find the request from the request id.
+// The request id is in the host byte order, because it is only
+// interpreted by the node which made it.
+//
+#define	CHMPX_REQHDR_MAGIC			"\x7f" "CHMPXRQ"
+#define	CHMPX_REQHDR_MAGIC_LENGTH	8
+
+typedef struct chmpx_request_header{
+	unsigned char	magic[CHMPX_REQHDR_MAGIC_LENGTH];
+	uint64_t		reqid;
+}CHMPXREQHDR, *PCHMPXREQHDR;
+
+#define	CHMPX_REQHDR_SIZE			sizeof(CHMPXREQHDR)
+
+//---------------------------------------------------------
+// Utility functions for request header
+//---------------------------------------------------------
+inline bool ChmpxGetReqHeader(const unsigned char* pdata, size_t length, uint64_t& reqid)
+{
+	if(!pdata || length < CHMPX_REQHDR_SIZE || 0 != memcmp(pdata, CHMPX_REQHDR_MAGIC, CHMPX_REQHDR_MAGIC_LENGTH)){
+		return false;
+	}
+	CHMPXREQHDR	header;
+	memcpy(&header, pdata, CHMPX_REQHDR_SIZE);		// pdata may not be aligned
+	reqid = header.reqid;
+	return true;
+}
+
+inline void ChmpxSetReqHeader(unsigned char* pdata, uint64_t reqid)
+{
+	CHMPXREQHDR	header;
+	memcpy(header.magic, CHMPX_REQHDR_MAGIC, CHMPX_REQHDR_MAGIC_LENGTH);
+	header.reqid = reqid;
+	memcpy(pdata, &header, CHMPX_REQHDR_SIZE);
+}
+
+//
+// Strip request header from received body
+//
+// [NOTE]
+// The body is moved to the head of the buffer which is allocated
+// by libchmpx, so the buffer can be freed as it is.
+//
+inline bool ChmpxStripReqHeader(unsigned char* pbody, size_t& length, uint64_t& reqid)
+{
+	if(!ChmpxGetReqHeader(pbody, length, reqid)){
+		return false;
+	}
+	length -= CHMPX_REQHDR_SIZE;
+	if(0 < length){
+		memmove(pbody, pbody + CHMPX_REQHDR_SIZE, length);
+	}
+	return true;
+}
+
+//
+// Get request header from compkt Buffer
+//
+// [NOTE]
+// The compkt Buffer which is made by receiving a request has the
+// request header after COMPKT.
+//
+inline bool ChmpxGetPktReqHeader(const unsigned char* ppkt, size_t pktlength, uint64_t& reqid)
+{
+	if(!ppkt || pktlength < (sizeof(COMPKT) + CHMPX_REQHDR_SIZE)){
+		return false;
+	}
+	return ChmpxGetReqHeader(ppkt + sizeof(COMPKT), pktlength - sizeof(COMPKT), reqid);
+}
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
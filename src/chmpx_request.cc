@@ -0,0 +1,400 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include <system_error>
+#include "chmpx_request.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// ChmpxRequestChannel Class
+//---------------------------------------------------------
+shared_ptr<ChmpxRequestChannel> ChmpxRequestChannel::Create(Napi::Env env, ChmpxCntrl* pobj, msgid_t msgid)
+{
+	shared_ptr<ChmpxRequestChannel>	channel = make_shared<ChmpxRequestChannel>(pobj, msgid);
+	if(!channel->StartThread(env, new shared_ptr<ChmpxRequestChannel>(channel))){
+		return nullptr;
+	}
+	return channel;
+}
+
+ChmpxRequestChannel::ChmpxRequestChannel(ChmpxCntrl* pobj, msgid_t msgid) : pchmcntrl(pobj), req_msgid(msgid), is_ref(false), stop_request(false), is_exited(true)
+{
+}
+
+ChmpxRequestChannel::~ChmpxRequestChannel()
+{
+	Stop();
+}
+
+//
+// Run on JS thread
+//
+// [NOTE]
+// env is null when the ThreadSafeFunction is finalizing with
+// remaining data, then only the data is freed.
+//
+void ChmpxRequestChannel::CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxRequestChannel* context, ChmpxReqResult* presult)
+{
+	unique_ptr<ChmpxReqResult>	result(presult);
+	if(!result || !context || nullptr == static_cast<napi_env>(env)){
+		return;
+	}
+	context->SettleRequest(env, *result);
+}
+
+void ChmpxRequestChannel::Finalize(Napi::Env env, shared_ptr<ChmpxRequestChannel>* pself, ChmpxRequestChannel* context)
+{
+	delete pself;
+}
+
+bool ChmpxRequestChannel::StartThread(Napi::Env env, shared_ptr<ChmpxRequestChannel>* pself)
+{
+	tsfn = ReqTsfn::New(env, "ChmpxRequestChannel", 0, 1, this, &ChmpxRequestChannel::Finalize, pself);
+	tsfn.Unref(env);
+
+	stop_request	= false;
+	is_exited		= false;
+	try{
+		std::thread(&ChmpxRequestChannel::Run, this).detach();
+	}catch(const std::system_error& err){
+		is_exited = true;
+		tsfn.Release();
+		return false;
+	}
+	return true;
+}
+
+//
+// [NOTE]
+// The receiving is aborted by the stop request, so the thread
+// notices it at the latest after ABORT_SLICE_MS of ChmpxCntrl.
+//
+void ChmpxRequestChannel::Stop(void)
+{
+	stop_request = true;
+}
+
+void ChmpxRequestChannel::Wait(void)
+{
+	unique_lock<mutex>	guard(exit_lock);
+	exit_cond.wait(guard, [this]{ return is_exited; });
+}
+
+void ChmpxRequestChannel::AddRequest(Napi::Env env, uint64_t reqid, const Napi::Promise::Deferred& deferred, int timeout_ms, const std::function<void(void)>& donehook)
+{
+	deferreds.emplace(reqid, ChmpxPendingRequest(deferred, donehook));
+	{
+		lock_guard<mutex>	guard(req_lock);
+		if(0 < timeout_ms){
+			reqclock_t::time_point	deadline = reqclock_t::now() + chrono::milliseconds(timeout_ms);
+			deadlines[reqid] = deadline;
+			expiries.insert(make_pair(deadline, reqid));
+		}else{
+			deadlines[reqid] = reqclock_t::time_point::max();
+		}
+	}
+	UpdateRef(env);
+}
+
+void ChmpxRequestChannel::CancelRequest(Napi::Env env, uint64_t reqid, const char* perror)
+{
+	{
+		lock_guard<mutex>	guard(req_lock);
+		auto	iter = deadlines.find(reqid);
+		if(deadlines.end() != iter){
+			expiries.erase(make_pair(iter->second, reqid));
+			deadlines.erase(iter);
+		}
+	}
+	ChmpxReqResult	result(reqid, perror);
+	SettleRequest(env, result);
+}
+
+void ChmpxRequestChannel::CancelAllRequests(Napi::Env env, const char* perror)
+{
+	{
+		lock_guard<mutex>	guard(req_lock);
+		deadlines.clear();
+		expiries.clear();
+	}
+	for(auto iter = deferreds.begin(); deferreds.end() != iter; ++iter){
+		pchmcntrl->RecordStats(req_msgid, CHMPX_STATS_REQUEST, false, false, 0, iter->second.start);
+		iter->second.Done();
+		iter->second.deferred.Reject(Napi::Error::New(env, perror).Value());
+	}
+	deferreds.clear();
+	UpdateRef(env);
+}
+
+void ChmpxRequestChannel::SettleRequest(Napi::Env env, ChmpxReqResult& result)
+{
+	auto	iter = deferreds.find(result.reqid);
+	if(deferreds.end() == iter){
+		return;				// already settled(canceled)
+	}
+	ChmpxPendingRequest	request = iter->second;
+	deferreds.erase(iter);
+	UpdateRef(env);
+	request.Done();
+
+	if(!result.error.empty()){
+		pchmcntrl->RecordStats(req_msgid, CHMPX_STATS_REQUEST, false, result.is_timeout, 0, request.start);
+		request.deferred.Reject(Napi::Error::New(env, result.error).Value());
+	}else if(!result.data || !result.data->pBody || result.data->length <= CHMPX_REQHDR_SIZE){
+		pchmcntrl->RecordStats(req_msgid, CHMPX_STATS_REQUEST, true, false, 0, request.start);
+		request.deferred.Resolve(Napi::Buffer<unsigned char>::New(env, 0));
+	}else{
+		size_t	length = result.data->length - CHMPX_REQHDR_SIZE;
+		pchmcntrl->RecordStats(req_msgid, CHMPX_STATS_REQUEST, true, false, length, request.start);
+		request.deferred.Resolve(Napi::Buffer<unsigned char>::Copy(env, result.data->pBody + CHMPX_REQHDR_SIZE, length));
+	}
+}
+
+//
+// [NOTE]
+// The ThreadSafeFunction keeps the event loop alive only while
+// there are requests in flight.
+//
+void ChmpxRequestChannel::UpdateRef(Napi::Env env)
+{
+	if(deferreds.empty() && is_ref){
+		tsfn.Unref(env);
+		is_ref = false;
+	}else if(!deferreds.empty() && !is_ref){
+		tsfn.Ref(env);
+		is_ref = true;
+	}
+}
+
+//
+// Run on receiving thread
+//
+void ChmpxRequestChannel::Run(void)
+{
+	while(!stop_request.load()){
+		ChmpxRcvData*	pdata = NULL;
+		if(!ChmpxReceiveData(pchmcntrl, false, req_msgid, GetWaitTime(), false, &pdata, &stop_request)){
+			if(stop_request.load()){
+				break;					// aborted by Stop
+			}
+			// [NOTE]
+			// The msgid may be closed, then all requests are failed
+			// and retry after the polling interval.
+			//
+			FailAllRequests("Failed to receive reply data.");
+			std::this_thread::sleep_for(chrono::milliseconds(ChmpxRequestChannel::POLL_INTERVAL_MS));
+			continue;
+		}
+		if(pdata){
+			unique_ptr<ChmpxRcvData>	data(pdata);
+			uint64_t					reqid	= 0;
+			bool						found	= false;
+			if(ChmpxGetReqHeader(data->pBody, data->length, reqid)){
+				lock_guard<mutex>	guard(req_lock);
+				auto	iter = deadlines.find(reqid);
+				if(deadlines.end() != iter){
+					expiries.erase(make_pair(iter->second, reqid));
+					deadlines.erase(iter);
+					found = true;
+				}
+			}
+			if(found){
+				PostResult(new ChmpxReqResult(reqid, data.release()));
+			}
+		}
+		ExpireRequests();
+	}
+
+	// [NOTE]
+	// This object is alive until the ThreadSafeFunction is finalized,
+	// and ChmpxCntrl may be freed after notifying.
+	//
+	{
+		lock_guard<mutex>	guard(exit_lock);
+		is_exited = true;
+	}
+	exit_cond.notify_all();
+	tsfn.Release();
+}
+
+//
+// Returns the timeout for receiving, it is the polling interval
+// or the time until the nearest deadline.
+//
+int ChmpxRequestChannel::GetWaitTime(void)
+{
+	lock_guard<mutex>	guard(req_lock);
+	if(expiries.empty()){
+		return ChmpxRequestChannel::POLL_INTERVAL_MS;
+	}
+	int64_t	remain = chrono::duration_cast<chrono::milliseconds>(expiries.begin()->first - reqclock_t::now()).count();
+	if(remain <= 0){
+		return 0;
+	}
+	return static_cast<int>(std::min(remain, static_cast<int64_t>(ChmpxRequestChannel::POLL_INTERVAL_MS)));
+}
+
+void ChmpxRequestChannel::PostResult(ChmpxReqResult* presult)
+{
+	if(napi_ok != tsfn.BlockingCall(presult)){
+		delete presult;
+	}
+}
+
+void ChmpxRequestChannel::ExpireRequests(void)
+{
+	vector<uint64_t>		expired;
+	reqclock_t::time_point	now = reqclock_t::now();
+	{
+		lock_guard<mutex>	guard(req_lock);
+		while(!expiries.empty() && expiries.begin()->first <= now){
+			expired.push_back(expiries.begin()->second);
+			deadlines.erase(expiries.begin()->second);
+			expiries.erase(expiries.begin());
+		}
+	}
+	for(auto iter = expired.begin(); expired.end() != iter; ++iter){
+		PostResult(new ChmpxReqResult(*iter, "Request timed out.", true));
+	}
+}
+
+void ChmpxRequestChannel::FailAllRequests(const char* perror)
+{
+	vector<uint64_t>	failed;
+	{
+		lock_guard<mutex>	guard(req_lock);
+		for(auto iter = deadlines.begin(); deadlines.end() != iter; ++iter){
+			failed.push_back(iter->first);
+		}
+		deadlines.clear();
+		expiries.clear();
+	}
+	for(auto iter = failed.begin(); failed.end() != iter; ++iter){
+		PostResult(new ChmpxReqResult(*iter, perror));
+	}
+}
+
+//---------------------------------------------------------
+// ChmpxRequester Class
+//---------------------------------------------------------
+ChmpxRequester::ChmpxRequester() : next_reqid(1)
+{
+}
+
+ChmpxRequester::~ChmpxRequester()
+{
+	Stop();
+}
+
+//
+// [NOTE]
+// The request is registered before sending, because the reply may
+// arrive soon, and the receiving thread of the msgid is started at
+// the first request.
+//
+Napi::Value ChmpxRequester::Request(Napi::Env env, ChmpxCntrl* pobj, msgid_t msgid, int timeout_ms, ChmpxRequestChannelPtr& channel, uint64_t& reqid, const std::function<void(void)>& donehook)
+{
+	Napi::Promise::Deferred	deferred	= Napi::Promise::Deferred::New(env);
+	Napi::Promise			promise		= deferred.Promise();
+
+	channel = nullptr;
+
+	auto	iter = channels.find(msgid);
+	if(channels.end() != iter){
+		channel = iter->second;
+	}else{
+		if(nullptr == (channel = ChmpxRequestChannel::Create(env, pobj, msgid))){
+			deferred.Reject(Napi::Error::New(env, "Could not start the thread for receiving replies.").Value());
+			return promise;
+		}
+		channels[msgid] = channel;
+	}
+
+	reqid = next_reqid++;
+	channel->AddRequest(env, reqid, deferred, timeout_ms, donehook);
+	return promise;
+}
+
+ChmpxRequestChannelPtr ChmpxRequester::Remove(Napi::Env env, msgid_t msgid)
+{
+	auto	iter = channels.find(msgid);
+	if(channels.end() == iter){
+		return nullptr;
+	}
+	ChmpxRequestChannelPtr	channel = iter->second;
+	channels.erase(iter);
+
+	// [NOTE]
+	// The requests are rejected before stopping, because the
+	// ThreadSafeFunction is released by the thread.
+	//
+	channel->CancelAllRequests(env, "The msgid is closed.");
+	channel->Stop();
+	return channel;
+}
+
+size_t ChmpxRequester::GetPendingCount(msgid_t msgid) const
+{
+	auto	iter = channels.find(msgid);
+	return (channels.end() != iter ? iter->second->GetPendingCount() : 0);
+}
+
+size_t ChmpxRequester::GetPendingCount(void) const
+{
+	size_t	count = 0;
+	for(auto iter = channels.begin(); channels.end() != iter; ++iter){
+		count += iter->second->GetPendingCount();
+	}
+	return count;
+}
+
+void ChmpxRequester::CancelAll(Napi::Env env, const char* perror)
+{
+	for(auto iter = channels.begin(); channels.end() != iter; ++iter){
+		iter->second->CancelAllRequests(env, perror);
+	}
+}
+
+//
+// [NOTE]
+// This waits for the threads, so it should run off JS thread.
+//
+void ChmpxRequester::Stop(void)
+{
+	for(auto iter = channels.begin(); channels.end() != iter; ++iter){
+		iter->second->Stop();
+	}
+	for(auto iter = channels.begin(); channels.end() != iter; ++iter){
+		iter->second->Wait();
+	}
+	channels.clear();
+}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,208 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_REQUEST_H
+#define CHMPX_REQUEST_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include "chmpx_common.h"
+#include "chmpx_rcvdata.h"
+
+//---------------------------------------------------------
+// Structure for request result
+//---------------------------------------------------------
+struct ChmpxReqResult
+{
+	uint64_t						reqid;
+	std::string						error;				// not empty means error
+	bool							is_timeout;
+	std::unique_ptr<ChmpxRcvData>	data;
+
+	ChmpxReqResult(uint64_t id, const char* perror, bool timeout = false) : reqid(id), error(perror ? perror : ""), is_timeout(timeout) {}
+	ChmpxReqResult(uint64_t id, ChmpxRcvData* pdata) : reqid(id), is_timeout(false), data(pdata) {}
+};
+
+//---------------------------------------------------------
+// Structure for request in flight
+//---------------------------------------------------------
+// [NOTE]
+// The donehook is called on JS thread when the request is settled
+// or canceled(ex. for the pending count of msgid handle).
+//
+struct ChmpxPendingRequest
+{
+	Napi::Promise::Deferred					deferred;
+	ChmpxStats::statsclock_t::time_point	start;
+	std::function<void(void)>				donehook;
+
+	ChmpxPendingRequest(const Napi::Promise::Deferred& def, const std::function<void(void)>& hook) : deferred(def), start(ChmpxStats::Now()), donehook(hook) {}
+
+	void Done(void)
+	{
+		if(donehook){
+			donehook();
+		}
+	}
+};
+
+//---------------------------------------------------------
+// ChmpxRequestChannel Class
+//---------------------------------------------------------
+// [NOTE]
+// This class has the requests in flight on one msgid, and runs
+// one dedicated thread which receives the replies on the msgid.
+// The reply is matched to the request by the request id in the
+// request header, and the Promise of the request is settled
+// through the ThreadSafeFunction. The replies which do not have
+// the request header or are for unknown(timeouted) requests are
+// discarded, so the msgid should be used only for requests.
+//
+// The Promises(deferreds) are accessed only on JS thread, and
+// the deadlines are shared with the receiving thread under the
+// lock. The ThreadSafeFunction is referenced only while there
+// are requests in flight, so an idle channel does not keep the
+// event loop alive.
+// This object is kept by the ThreadSafeFunction and freed by its
+// finalizer, because the queued calls have this as context.
+//
+// The thread is detached, and Stop only requests stopping, so it
+// never blocks JS thread. The thread releases the ThreadSafeFunction
+// at exiting, then this object is freed by the finalizer. Wait waits
+// for the thread to exit(it no longer uses ChmpxCntrl after that),
+// so it should be called off JS thread before closing the msgid or
+// cleaning up ChmpxCntrl.
+//
+class ChmpxRequestChannel
+{
+	public:
+		static const int	POLL_INTERVAL_MS = 100;
+
+	protected:
+		static void CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxRequestChannel* context, ChmpxReqResult* presult);
+		static void Finalize(Napi::Env env, std::shared_ptr<ChmpxRequestChannel>* pself, ChmpxRequestChannel* context);
+
+	public:
+		typedef Napi::TypedThreadSafeFunction<ChmpxRequestChannel, ChmpxReqResult, ChmpxRequestChannel::CallJs>	ReqTsfn;
+		typedef std::chrono::steady_clock																		reqclock_t;
+
+		static std::shared_ptr<ChmpxRequestChannel> Create(Napi::Env env, ChmpxCntrl* pobj, msgid_t msgid);
+
+		ChmpxRequestChannel(ChmpxCntrl* pobj, msgid_t msgid);
+		virtual ~ChmpxRequestChannel();
+
+		void Stop(void);
+		void Wait(void);
+
+		// Run on JS thread
+		void AddRequest(Napi::Env env, uint64_t reqid, const Napi::Promise::Deferred& deferred, int timeout_ms, const std::function<void(void)>& donehook);
+		void CancelRequest(Napi::Env env, uint64_t reqid, const char* perror);
+		void CancelAllRequests(Napi::Env env, const char* perror);
+		size_t GetPendingCount(void) const { return deferreds.size(); }
+
+	protected:
+		bool StartThread(Napi::Env env, std::shared_ptr<ChmpxRequestChannel>* pself);
+		void Run(void);
+		int GetWaitTime(void);
+		void PostResult(ChmpxReqResult* presult);
+		void ExpireRequests(void);
+		void FailAllRequests(const char* perror);
+		void SettleRequest(Napi::Env env, ChmpxReqResult& result);
+		void UpdateRef(Napi::Env env);
+
+	protected:
+		ChmpxCntrl*										pchmcntrl;
+		msgid_t											req_msgid;
+
+		ReqTsfn											tsfn;
+		bool											is_ref;				// JS thread only
+		std::map<uint64_t, ChmpxPendingRequest>			deferreds;			// JS thread only
+
+		std::mutex										req_lock;
+		std::map<uint64_t, reqclock_t::time_point>		deadlines;			// under req_lock, all requests in flight
+		std::set<std::pair<reqclock_t::time_point, uint64_t>>	expiries;	// under req_lock, requests which have timeout
+
+		std::atomic<bool>								stop_request;
+		std::mutex										exit_lock;
+		std::condition_variable							exit_cond;
+		bool											is_exited;			// under exit_lock
+};
+
+typedef std::shared_ptr<ChmpxRequestChannel>	ChmpxRequestChannelPtr;
+typedef std::vector<ChmpxRequestChannelPtr>		chmpxreqchannels_t;
+
+//---------------------------------------------------------
+// ChmpxRequester Class
+//---------------------------------------------------------
+// [NOTE]
+// This class has the ChmpxRequestChannel for each msgid, and
+// all methods run on JS thread except Stop.
+// Request only registers the request, and the caller sends the
+// request data with the request header off JS thread(see
+// RequestWorker).
+// Remove requests stopping the channel without waiting, and
+// returns it, so that the caller can wait for it off JS thread.
+// Stop stops all channels and waits for them.
+//
+class ChmpxRequester
+{
+	public:
+		ChmpxRequester();
+		virtual ~ChmpxRequester();
+
+		// Returns the Promise which is resolved with the reply body Buffer, channel is null if failed(the Promise is rejected)
+		Napi::Value Request(Napi::Env env, ChmpxCntrl* pobj, msgid_t msgid, int timeout_ms, ChmpxRequestChannelPtr& channel, uint64_t& reqid, const std::function<void(void)>& donehook = nullptr);
+
+		// Stops the channel and rejects the requests on it, returns the channel(null if not found)
+		ChmpxRequestChannelPtr Remove(Napi::Env env, msgid_t msgid);
+
+		// Rejects the requests on all channels(the channels are not stopped)
+		void CancelAll(Napi::Env env, const char* perror);
+
+		// Returns the count of requests in flight on the msgid
+		size_t GetPendingCount(msgid_t msgid) const;
+		// Returns the count of requests in flight on all channels
+		size_t GetPendingCount(void) const;
+		void Stop(void);
+
+	protected:
+		std::map<msgid_t, ChmpxRequestChannelPtr>				channels;
+		uint64_t												next_reqid;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,483 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include <cstring>
+#include <system_error>
+#include "chmpx_sendring.h"
+#include "chmpx_node.h"
+
+using namespace std;
+
+static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t) && ATOMIC_INT_LOCK_FREE == 2, "The header of send ring needs lock free int32 atomics.");
+
+//---------------------------------------------------------
+// Utility functions
+//---------------------------------------------------------
+static inline uint32_t ChmpxRingAlign(uint32_t length)
+{
+	return ((length + 7) & ~static_cast<uint32_t>(7));
+}
+
+static inline uint32_t ChmpxRingReadU32(const unsigned char* ptr)
+{
+	uint32_t	value;
+	memcpy(&value, ptr, sizeof(uint32_t));
+	return value;
+}
+
+//---------------------------------------------------------
+// ChmpxSendRingSender Class
+//---------------------------------------------------------
+size_t ChmpxSendRingSender::GetCapacity(size_t size)
+{
+	size_t	capacity = ChmpxSendRingSender::MIN_CAPACITY;
+	while(capacity < size && capacity < ChmpxSendRingSender::MAX_CAPACITY){
+		capacity <<= 1;
+	}
+	return capacity;
+}
+
+ChmpxSendRingSender::ChmpxSendRingSender(ChmpxCntrl* pobj, msgid_t msgid, bool is_routing, unsigned char* pringbuf, size_t ringcap) :
+	pchmcntrl(pobj), snd_msgid(msgid), routing(is_routing), pring(pringbuf), capacity(ringcap), is_exited(true), doorbell(false), is_running(false), stop_request(false)
+{
+}
+
+//
+// [NOTE]
+// This object is freed after the thread exits, because the
+// ThreadSafeFunction keeps it until then.
+//
+ChmpxSendRingSender::~ChmpxSendRingSender()
+{
+}
+
+//
+// Run on JS thread
+//
+// [NOTE]
+// The ThreadSafeFunction is never called, it is only for releasing
+// the holder on JS thread.
+//
+void ChmpxSendRingSender::CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxSendRingSender* context, void* pdata)
+{
+}
+
+//
+// Run on JS thread
+//
+void ChmpxSendRingSender::Finalize(Napi::Env env, Holder* pholder, ChmpxSendRingSender* context)
+{
+	delete pholder;
+}
+
+//
+// [NOTE]
+// This object is added to the thread list before the thread starts,
+// so that the thread can remove it when exiting.
+// The ThreadSafeFunction does not keep the event loop alive.
+//
+bool ChmpxSendRingSender::Start(Napi::Env env, const Napi::Object& buffer, const std::shared_ptr<ChmpxThreadList>& list)
+{
+	{
+		std::lock_guard<std::mutex>	guard(exit_lock);
+		if(!pchmcntrl || !pring || !list || !is_exited || 0 != Slot(CHMPX_RING_CLOSED).load()){
+			return false;
+		}
+		is_exited = false;
+	}
+	Holder*	pholder		= new Holder;
+	pholder->sender		= shared_from_this();
+	pholder->bufferRef	= Napi::Persistent(buffer);
+
+	threadlist	= list;
+	tsfn		= HolderTsfn::New(env, "ChmpxSendRingSender", 0, 1, this, &ChmpxSendRingSender::Finalize, pholder);
+	tsfn.Unref(env);
+
+	stop_request	= false;
+	is_running		= true;
+	list->Add(shared_from_this());
+	try{
+		std::thread(&ChmpxSendRingSender::Run, this).detach();
+	}catch(const std::system_error& err){
+		list->Remove(shared_from_this());
+		is_running = false;
+		Slot(CHMPX_RING_CLOSED).store(1);
+		{
+			std::lock_guard<std::mutex>	guard(exit_lock);
+			is_exited = true;
+		}
+		tsfn.Release();
+		return false;
+	}
+	return true;
+}
+
+//
+// [NOTE]
+// The ring memory is accessed only while the thread is running,
+// because the memory may be freed after the thread exits(this
+// object may be alive in the thread list or ChmpxSendRing).
+//
+void ChmpxSendRingSender::RequestStop(void)
+{
+	{
+		std::lock_guard<std::mutex>	guard(exit_lock);
+		if(is_exited){
+			return;
+		}
+		Slot(CHMPX_RING_CLOSED).store(1);
+	}
+	{
+		std::lock_guard<std::mutex>	guard(bell_lock);
+		stop_request = true;
+	}
+	bell_cond.notify_all();
+}
+
+bool ChmpxSendRingSender::Stop(void)
+{
+	bool	was_running = IsRunning();
+
+	RequestStop();
+
+	std::unique_lock<std::mutex>	guard(exit_lock);
+	exit_cond.wait(guard, [this]{ return is_exited; });
+	return was_running;
+}
+
+void ChmpxSendRingSender::Notify(void)
+{
+	{
+		std::lock_guard<std::mutex>	guard(bell_lock);
+		doorbell = true;
+	}
+	bell_cond.notify_one();
+}
+
+//
+// Run on sending thread
+//
+// [NOTE]
+// SLEEPING is set before checking TAIL again, and JS checks SLEEPING
+// after writing TAIL. Both are sequentially consistent, so one of
+// them sees the other and the doorbell is never lost.
+//
+void ChmpxSendRingSender::Run(void)
+{
+	while(true){
+		if(!SendRecords()){
+			break;
+		}
+		if(stop_request.load()){
+			if(Slot(CHMPX_RING_HEAD).load() == Slot(CHMPX_RING_TAIL).load()){
+				break;
+			}
+			continue;
+		}
+
+		// wait for doorbell
+		Slot(CHMPX_RING_SLEEPING).store(1);
+		if(Slot(CHMPX_RING_HEAD).load() == Slot(CHMPX_RING_TAIL).load()){
+			std::unique_lock<std::mutex>	lock(bell_lock);
+			bell_cond.wait_for(lock, std::chrono::milliseconds(ChmpxSendRingSender::POLLING_TIMEOUT_MS), [this]{ return (doorbell || stop_request.load()); });
+			doorbell = false;
+		}
+		Slot(CHMPX_RING_SLEEPING).store(0);
+	}
+	Slot(CHMPX_RING_CLOSED).store(1);
+	is_running = false;
+
+	// [NOTE]
+	// The thread list and ThreadSafeFunction keep this object, and
+	// the ThreadSafeFunction is released at last.
+	//
+	std::shared_ptr<ChmpxThreadList>	list = threadlist.lock();
+	if(list){
+		list->Remove(shared_from_this());
+	}
+	{
+		std::lock_guard<std::mutex>	guard(exit_lock);
+		is_exited = true;
+	}
+	exit_cond.notify_all();
+	tsfn.Release();
+}
+
+//
+// Run on sending thread
+//
+// [NOTE]
+// Sends all records up to TAIL which is read at first. If a record
+// is broken(JS wrote the wrong data), returns false and the ring is
+// closed.
+// The length is written by JS, so it is checked against the rest of
+// the data area before aligning(aligning a huge length wraps around).
+//
+bool ChmpxSendRingSender::SendRecords(void)
+{
+	const unsigned char*	pdata	= pring + CHMPX_RING_HEADER_SIZE;
+	uint32_t				mask	= static_cast<uint32_t>(capacity - 1);
+	uint32_t				head	= static_cast<uint32_t>(Slot(CHMPX_RING_HEAD).load());
+	uint32_t				tail	= static_cast<uint32_t>(Slot(CHMPX_RING_TAIL).load());
+
+	while(head != tail){
+		uint32_t	offset	= head & mask;
+		uint32_t	length	= ChmpxRingReadU32(pdata + offset);
+
+		if(CHMPX_RING_WRAP_MARK == length){
+			head += static_cast<uint32_t>(capacity) - offset;
+		}else{
+			if(capacity - offset < CHMPX_RING_RECORD_HEADER_SIZE || capacity - offset - CHMPX_RING_RECORD_HEADER_SIZE < length){
+				Slot(CHMPX_RING_CLOSED).store(1);
+				return false;
+			}
+			uint32_t	recsize	= CHMPX_RING_RECORD_HEADER_SIZE + ChmpxRingAlign(length);
+			if(capacity - offset < recsize || (tail - head) < recsize){
+				Slot(CHMPX_RING_CLOSED).store(1);
+				return false;
+			}
+			uint32_t		flags	= ChmpxRingReadU32(pdata + offset + 4);
+			unsigned char*	pbody	= const_cast<unsigned char*>(pdata + offset + CHMPX_RING_RECORD_HEADER_SIZE);
+			chmhash_t		hash;
+			if(flags & CHMPX_RING_RECORD_HAS_HASH){
+				hash = static_cast<chmhash_t>(ChmpxRingReadU32(pdata + offset + 8)) | (static_cast<chmhash_t>(ChmpxRingReadU32(pdata + offset + 12)) << 32);
+			}else{
+				ChmBinData	bindata;
+				bindata.Set(pbody, length);
+				hash = bindata.GetHash();
+			}
+
+			long	recievercnt = 0;
+			if(pchmcntrl->Send(snd_msgid, pbody, length, hash, &recievercnt, routing)){
+				Slot(CHMPX_RING_SENT).fetch_add(1);
+			}else{
+				Slot(CHMPX_RING_ERRORS).fetch_add(1);
+			}
+			head += recsize;
+		}
+		Slot(CHMPX_RING_HEAD).store(static_cast<int32_t>(head));		// free the space
+	}
+	return true;
+}
+
+//---------------------------------------------------------
+// ChmpxSendRing Methods
+//---------------------------------------------------------
+//
+// [NOTE]
+// The parameters are passed by External which is used only in the
+// constructor.
+//
+struct ChmpxSendRingParam
+{
+	ChmpxSendRingSenderPtr				sender;
+	std::shared_ptr<ChmpxThreadList>	threadlist;
+	Napi::Object						buffer;
+};
+
+Napi::Function ChmpxSendRing::Init(Napi::Env env)
+{
+	return DefineClass(env, "ChmpxSendRing", {
+		ChmpxSendRing::InstanceMethod("notify",		&ChmpxSendRing::Notify),
+		ChmpxSendRing::InstanceMethod("close",		&ChmpxSendRing::Close),
+		ChmpxSendRing::InstanceAccessor("buffer",	&ChmpxSendRing::GetBuffer,	nullptr),
+		ChmpxSendRing::InstanceAccessor("sent",		&ChmpxSendRing::GetSent,	nullptr),
+		ChmpxSendRing::InstanceAccessor("errors",	&ChmpxSendRing::GetErrors,	nullptr),
+		ChmpxSendRing::InstanceAccessor("closed",	&ChmpxSendRing::GetClosed,	nullptr)
+	});
+}
+
+//
+// [NOTE]
+// N-API can not create SharedArrayBuffer, so it is created by the
+// constructor in global, and the memory is accessed through the
+// Uint8Array over it.
+//
+Napi::Object ChmpxSendRing::NewInstance(Napi::Env env, const Napi::Object& nodeobj, ChmpxCntrl* pchmcntrl, const std::shared_ptr<ChmpxThreadList>& threadlist, msgid_t msgid, bool is_routing, size_t capacity)
+{
+	Napi::EscapableHandleScope	scope(env);
+	ChmpxAddonData*				pdata	= env.GetInstanceData<ChmpxAddonData>();
+	Napi::Object				global	= env.Global();
+
+	Napi::Object		buffer	= global.Get("SharedArrayBuffer").As<Napi::Function>().New({Napi::Number::New(env, static_cast<double>(CHMPX_RING_HEADER_SIZE + capacity))});
+	Napi::Uint8Array	view	= global.Get("Uint8Array").As<Napi::Function>().New({buffer}).As<Napi::Uint8Array>();
+	unsigned char*		pring	= view.Data();
+	if(!pring){
+		Napi::Error::New(env, "Could not access the memory of SharedArrayBuffer.").ThrowAsJavaScriptException();
+		return Napi::Object();
+	}
+	reinterpret_cast<std::atomic<int32_t>*>(pring + CHMPX_RING_CAPACITY * sizeof(int32_t))->store(static_cast<int32_t>(capacity));
+
+	ChmpxSendRingParam	param = { std::make_shared<ChmpxSendRingSender>(pchmcntrl, msgid, is_routing, pring, capacity), threadlist, buffer };
+
+	Napi::Object obj = pdata->sendring_constructor.Value().New({nodeobj, Napi::External<ChmpxSendRingParam>::New(env, &param)});
+	return scope.Escape(napi_value(obj)).ToObject();
+}
+
+ChmpxSendRing::ChmpxSendRing(const Napi::CallbackInfo& info) : Napi::ObjectWrap<ChmpxSendRing>(info)
+{
+	Napi::Env env = info.Env();
+
+	if(info.Length() < 2 || !info[0].IsObject() || !info[0].As<Napi::Object>().InstanceOf(ChmpxNode::GetConstructor(env)) || !info[1].IsExternal()){
+		Napi::TypeError::New(env, "ChmpxSendRing can not be created directly, use ChmpxNode::openSendRing().").ThrowAsJavaScriptException();
+		return;
+	}
+	const ChmpxSendRingParam*	pparam = info[1].As<Napi::External<ChmpxSendRingParam>>().Data();
+
+	_nodeRef	= Napi::Persistent(info[0].As<Napi::Object>());
+	_bufferRef	= Napi::Persistent(pparam->buffer);
+	_sender		= pparam->sender;
+
+	// start sending(the sender is registered to the thread list while running)
+	if(!_sender || !_sender->Start(env, pparam->buffer, pparam->threadlist)){
+		Napi::Error::New(env, "Failed to start the sender of send ring.").ThrowAsJavaScriptException();
+		return;
+	}
+}
+
+//
+// [NOTE]
+// The sender keeps its own reference of SharedArrayBuffer until
+// the thread exits, so the reference of this object can be released
+// before that.
+//
+ChmpxSendRing::~ChmpxSendRing()
+{
+	Finish();
+}
+
+//
+// Request to stop the sender
+//
+// [NOTE]
+// This does not wait for the thread, it exits after sending the
+// written records and removes the sender from the thread list of
+// ChmpxNode.
+//
+void ChmpxSendRing::Finish(void)
+{
+	if(!_sender){
+		return;
+	}
+	_sender->RequestStop();
+}
+
+/// \defgroup nodejs_methods	the methods for using from node.js
+//@{
+
+/**
+ * @memberof ChmpxSendRing
+ * @fn bool Notify()
+ * @brief	Wake up the sender(doorbell)
+ *
+ *	push() calls this only when the sender is waiting, so it is not
+ *	needed to call this after push().
+ *
+ * @return	Returns false if the ring is closed.
+ */
+
+Napi::Value ChmpxSendRing::Notify(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!_sender || !_sender->IsRunning()){
+		return Napi::Boolean::New(env, false);
+	}
+	_sender->Notify();
+	return Napi::Boolean::New(env, true);
+}
+
+/**
+ * @memberof ChmpxSendRing
+ * @fn bool Close()
+ * @brief	Close the ring
+ *
+ *	push() fails after closing. The records which are already written
+ *	are sent after this method returns(see sent and errors), this does
+ *	not wait for sending them.
+ *
+ * @return	Returns true if the sender was running, otherwise false.
+ */
+
+Napi::Value ChmpxSendRing::Close(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	bool	result = (_sender && _sender->IsRunning());
+	Finish();
+	return Napi::Boolean::New(env, result);
+}
+
+/**
+ * @memberof ChmpxSendRing
+ * @fn SharedArrayBuffer buffer
+ * @brief	The SharedArrayBuffer of the ring(see the layout in chmpx_sendring.h)
+ */
+
+Napi::Value ChmpxSendRing::GetBuffer(const Napi::CallbackInfo& info)
+{
+	return _bufferRef.Value();
+}
+
+/**
+ * @memberof ChmpxSendRing
+ * @fn number sent
+ * @brief	The count of the sent records
+ */
+
+Napi::Value ChmpxSendRing::GetSent(const Napi::CallbackInfo& info)
+{
+	return Napi::Number::New(info.Env(), static_cast<double>(static_cast<uint32_t>(_sender ? _sender->GetHeader(CHMPX_RING_SENT) : 0)));
+}
+
+/**
+ * @memberof ChmpxSendRing
+ * @fn number errors
+ * @brief	The count of the records which failed to send
+ */
+
+Napi::Value ChmpxSendRing::GetErrors(const Napi::CallbackInfo& info)
+{
+	return Napi::Number::New(info.Env(), static_cast<double>(static_cast<uint32_t>(_sender ? _sender->GetHeader(CHMPX_RING_ERRORS) : 0)));
+}
+
+/**
+ * @memberof ChmpxSendRing
+ * @fn bool closed
+ * @brief	true after the ring is closed
+ */
+
+Napi::Value ChmpxSendRing::GetClosed(const Napi::CallbackInfo& info)
+{
+	return Napi::Boolean::New(info.Env(), (!_sender || 0 != _sender->GetHeader(CHMPX_RING_CLOSED)));
+}
+
+//@}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,215 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_SENDRING_H
+#define CHMPX_SENDRING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "chmpx_common.h"
+#include "chmpx_cntrl.h"
+#include "chmpx_thrlist.h"
+
+//---------------------------------------------------------
+// Layout of send ring
+//---------------------------------------------------------
+// [NOTE]
+// The send ring is one SharedArrayBuffer which has the header and
+// the data area. JS(single producer) writes the records into the
+// data area and the sender thread(single consumer) sends them.
+// The same values are used by src/index.ts, so they must not be
+// changed independently.
+//
+// Header(int32 slots, accessed by Atomics on JS side):
+//	HEAD		: byte position of the next record to send(sender writes)
+//	TAIL		: byte position after the last written record(JS writes)
+//	SLEEPING	: 1 while the sender waits for the doorbell(sender writes)
+//	CLOSED		: 1 after the ring is closed(sender writes)
+//	CAPACITY	: byte size of the data area, power of 2
+//	SENT		: count of the sent records
+//	ERRORS		: count of the records which failed to send
+// The positions are uint32 counters which wrap around, and the
+// offset in the data area is (position & (CAPACITY - 1)).
+//
+// Record(8 bytes aligned, in native byte order):
+//	uint32	length		: body length, WRAP_MARK means the rest of the
+//						  data area is skipped
+//	uint32	flags		: RECORD_HAS_HASH if the hash is specified
+//	uint32	hash_low
+//	uint32	hash_high
+//	body and padding to 8 bytes
+//
+// The record is never split at the end of the data area.
+// After writing TAIL, JS calls notify() only if SLEEPING is 1, so
+// the doorbell costs one call only when the sender is idle.
+//
+#define	CHMPX_RING_HEAD					0
+#define	CHMPX_RING_TAIL					1
+#define	CHMPX_RING_SLEEPING				2
+#define	CHMPX_RING_CLOSED				3
+#define	CHMPX_RING_CAPACITY				4
+#define	CHMPX_RING_SENT					5
+#define	CHMPX_RING_ERRORS				6
+#define	CHMPX_RING_HEADER_SIZE			64
+#define	CHMPX_RING_RECORD_HEADER_SIZE	16
+#define	CHMPX_RING_RECORD_HAS_HASH		0x1
+#define	CHMPX_RING_WRAP_MARK			0xFFFFFFFFU
+
+//---------------------------------------------------------
+// ChmpxSendRingSender Class
+//---------------------------------------------------------
+// [NOTE]
+// This class runs one dedicated thread which sends the records in
+// the ring by ChmpxCntrl::Send. The space of each record is freed
+// (HEAD is advanced) after it is sent, so the body is sent from
+// the shared memory without copying.
+// When the ring is empty, the thread waits for the doorbell(Notify)
+// or POLLING_TIMEOUT_MS.
+// RequestStop sets CLOSED, and the thread exits after sending the
+// records which are already written.
+//
+// The thread is detached. The ThreadSafeFunction(which is never
+// called) keeps this object and the SharedArrayBuffer of the ring
+// until the thread exits, and its finalizer releases them on JS
+// thread. This object is in the thread list of ChmpxNode while the
+// thread is running, and the thread removes it when exiting. So
+// that JS thread(close() and GC of ChmpxSendRing) only requests to
+// stop and does not wait for the thread, and the node still waits
+// for the thread by the thread list before its ChmpxCntrl is freed.
+//
+class ChmpxSendRingSender : public ChmpxThreadTask, public std::enable_shared_from_this<ChmpxSendRingSender>
+{
+	public:
+		static const size_t	DEFAULT_CAPACITY	= 1024 * 1024;
+		static const size_t	MIN_CAPACITY		= 4096;
+		static const size_t	MAX_CAPACITY		= 1024 * 1024 * 1024;
+		static const int	POLLING_TIMEOUT_MS	= 100;
+
+		static size_t GetCapacity(size_t size);			// returns power of 2 in [MIN_CAPACITY, MAX_CAPACITY]
+
+	protected:
+		// The objects which are kept until the thread exits
+		struct Holder
+		{
+			std::shared_ptr<ChmpxSendRingSender>	sender;
+			Napi::ObjectReference					bufferRef;
+		};
+
+		static void CallJs(Napi::Env env, Napi::Function jsCallback, ChmpxSendRingSender* context, void* pdata);
+		static void Finalize(Napi::Env env, Holder* pholder, ChmpxSendRingSender* context);
+
+	public:
+		typedef Napi::TypedThreadSafeFunction<ChmpxSendRingSender, void, ChmpxSendRingSender::CallJs>	HolderTsfn;
+
+		ChmpxSendRingSender(ChmpxCntrl* pobj, msgid_t msgid, bool is_routing, unsigned char* pring, size_t capacity);
+		virtual ~ChmpxSendRingSender();
+
+		// Run on JS thread
+		bool Start(Napi::Env env, const Napi::Object& buffer, const std::shared_ptr<ChmpxThreadList>& threadlist);
+
+		// Run on any thread
+		void RequestStop(void);							// does not wait for the thread
+		bool Stop(void) override;						// waits for the thread
+		void Notify(void);
+		bool IsRunning(void) const { return is_running.load(); }
+
+		int32_t GetHeader(int slot) const { return Slot(slot).load(); }
+
+	protected:
+		std::atomic<int32_t>& Slot(int slot) const { return *reinterpret_cast<std::atomic<int32_t>*>(pring + slot * sizeof(int32_t)); }
+		void Run(void);
+		bool SendRecords(void);							// returns false if the ring is broken
+
+	protected:
+		ChmpxCntrl*						pchmcntrl;
+		msgid_t							snd_msgid;
+		bool							routing;
+		unsigned char*					pring;
+		size_t							capacity;
+
+		HolderTsfn						tsfn;
+		std::weak_ptr<ChmpxThreadList>	threadlist;
+		std::mutex						exit_lock;
+		std::condition_variable			exit_cond;
+		bool							is_exited;				// under exit_lock
+		std::mutex						bell_lock;
+		std::condition_variable			bell_cond;
+		bool							doorbell;
+		std::atomic<bool>				is_running;
+		std::atomic<bool>				stop_request;
+};
+
+typedef std::shared_ptr<ChmpxSendRingSender>	ChmpxSendRingSenderPtr;
+
+//---------------------------------------------------------
+// ChmpxSendRing Class
+//---------------------------------------------------------
+// [NOTE]
+// This class is returned by ChmpxNode::OpenSendRing, and has the
+// SharedArrayBuffer and the sender. The records are written by
+// push() which is added by src/index.ts in JS, so that sending
+// one message does not call this module.
+// The sender is registered to the thread list of ChmpxNode while
+// it is running, and is stopped when ChmpxNode is destroyed(or
+// drained).
+// This object references ChmpxNode object, so ChmpxNode is not
+// freed while this object is alive.
+//
+class ChmpxSendRing : public Napi::ObjectWrap<ChmpxSendRing>
+{
+	public:
+		static Napi::Function Init(Napi::Env env);
+		static Napi::Object NewInstance(Napi::Env env, const Napi::Object& nodeobj, ChmpxCntrl* pchmcntrl, const std::shared_ptr<ChmpxThreadList>& threadlist, msgid_t msgid, bool is_routing, size_t capacity);
+
+		// Constructor / Destructor
+		explicit ChmpxSendRing(const Napi::CallbackInfo& info);
+		~ChmpxSendRing();
+
+	private:
+		Napi::Value Notify(const Napi::CallbackInfo& info);
+		Napi::Value Close(const Napi::CallbackInfo& info);
+		Napi::Value GetBuffer(const Napi::CallbackInfo& info);
+		Napi::Value GetSent(const Napi::CallbackInfo& info);
+		Napi::Value GetErrors(const Napi::CallbackInfo& info);
+		Napi::Value GetClosed(const Napi::CallbackInfo& info);
+
+		void Finish(void);
+
+	private:
+		Napi::ObjectReference				_nodeRef;
+		Napi::ObjectReference				_bufferRef;			// SharedArrayBuffer
+		ChmpxSendRingSenderPtr				_sender;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,348 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_SNDDATA_H
+#define CHMPX_SNDDATA_H
+
+#include <cstring>
+#include <vector>
+#include "chmpx_common.h"
+#include "chmpx_cntrl.h"
+
+//---------------------------------------------------------
+// Structure for sending data
+//---------------------------------------------------------
+// [NOTE]
+// This structure does not have the buffer, the caller must
+// keep the buffer until sending is finished.
+//
+struct ChmpxSndData
+{
+	unsigned char*	pBody;
+	ssize_t			length;
+
+	ChmpxSndData() : pBody(NULL), length(0) {}
+	ChmpxSndData(unsigned char* pbody, ssize_t bodylen) : pBody(pbody), length(bodylen) {}
+};
+
+typedef std::vector<ChmpxSndData>					chmpxsndlist_t;
+typedef std::vector<int32_t>						chmpxsndcnts_t;
+typedef std::vector<std::vector<unsigned char>>		chmpxsndbufs_t;		// gathered bodies which are pointed by chmpxsndlist_t
+
+//---------------------------------------------------------
+// Utility functions for sending data
+//---------------------------------------------------------
+//
+// Get the pointer and length of binary data
+//
+// [NOTE]
+// Buffer, TypedArray, DataView and ArrayBuffer are allowed, and
+// the data is not copied. Returns false without exception if the
+// value is not binary data.
+//
+inline bool ChmpxGetBinaryData(const Napi::Value& value, unsigned char*& pdata, size_t& length)
+{
+	if(value.IsBuffer()){
+		Napi::Buffer<unsigned char>	databuf	= value.As<Napi::Buffer<unsigned char>>();
+		pdata								= databuf.Data();
+		length								= databuf.Length();
+	}else if(value.IsTypedArray()){
+		Napi::TypedArray	array	= value.As<Napi::TypedArray>();
+		Napi::ArrayBuffer	arrbuf	= array.ArrayBuffer();
+		pdata						= arrbuf.Data() ? (static_cast<unsigned char*>(arrbuf.Data()) + array.ByteOffset()) : NULL;
+		length						= array.ByteLength();
+	}else if(value.IsDataView()){
+		Napi::DataView		view	= value.As<Napi::DataView>();
+		pdata						= static_cast<unsigned char*>(view.Data());		// already offset
+		length						= view.ByteLength();
+	}else if(value.IsArrayBuffer()){
+		Napi::ArrayBuffer	arrbuf	= value.As<Napi::ArrayBuffer>();
+		pdata						= static_cast<unsigned char*>(arrbuf.Data());
+		length						= arrbuf.ByteLength();
+	}else{
+		return false;
+	}
+	return true;
+}
+
+//
+// Get the body pointer and length from the binary parameter
+//
+// [NOTE]
+// This throws TypeError and returns false if the parameter is
+// wrong.
+//
+inline bool GetChmpxBodyParam(Napi::Env env, const Napi::Value& value, unsigned char*& pbinptr, ssize_t& binLen)
+{
+	size_t	dataLen	= 0;
+	pbinptr			= NULL;
+	if(!ChmpxGetBinaryData(value, pbinptr, dataLen)){
+		Napi::TypeError::New(env, "Wrong send data is specified.").ThrowAsJavaScriptException();
+		return false;
+	}
+	binLen = static_cast<ssize_t>(dataLen);		// adjust to size_t
+	if(!pbinptr && 0 < dataLen){
+		Napi::TypeError::New(env, "Could not access buffer data.").ThrowAsJavaScriptException();
+		return false;
+	}
+	return true;
+}
+
+//---------------------------------------------------------
+// ChmpxSndBody Class
+//---------------------------------------------------------
+// [NOTE]
+// The body parameter of the send, broadcast and reply methods(and
+// each element of the batch methods) is binary data
+// (Buffer, TypedArray, DataView or ArrayBuffer), a string, or an
+// array of them which are gathered into one contiguous body.
+// Binary data is sent as it is without copying. A string is
+// encoded to UTF-8 natively, and the pieces are gathered into the
+// thread local scratch buffer which is reused on each call, so
+// that they do not allocate memory after the scratch buffer has
+// grown. The async worker takes the gathered body by Detach(),
+// then the scratch buffer is allocated again by the next one.
+// Only one object uses the scratch buffer at the same time on a
+// thread. Getting a piece may call JS(getters or Proxy traps) which
+// sends again, so the object created while the scratch buffer is
+// in use gathers into its own buffer instead.
+//
+// If headroom is specified, the body is always copied after the
+// headroom bytes(ex. for the request header of Reply).
+//
+class ChmpxSndBody
+{
+	public:
+		static const size_t	SCRATCH_KEEP_SIZE = 1024 * 1024;		// larger scratch buffer is released after use
+
+	protected:
+		static std::vector<unsigned char>& GetScratch(void)
+		{
+			static thread_local std::vector<unsigned char>	scratch;
+			return scratch;
+		}
+
+		static bool& GetScratchInUse(void)
+		{
+			static thread_local bool	in_use = false;
+			return in_use;
+		}
+
+		// Append the string encoded to UTF-8 without intermediate buffer
+		static bool AppendString(Napi::Env env, const Napi::Value& value, std::vector<unsigned char>& output)
+		{
+			size_t	length = 0;
+			if(napi_ok != napi_get_value_string_utf8(env, value, NULL, 0, &length)){
+				Napi::TypeError::New(env, "Could not access send data string.").ThrowAsJavaScriptException();
+				return false;
+			}
+			size_t	offset = output.size();
+			output.resize(offset + length + 1);												// with terminating null
+			if(napi_ok != napi_get_value_string_utf8(env, value, reinterpret_cast<char*>(&output[offset]), length + 1, &length)){
+				Napi::TypeError::New(env, "Could not access send data string.").ThrowAsJavaScriptException();
+				return false;
+			}
+			output.resize(offset + length);
+			return true;
+		}
+
+		static bool AppendPiece(Napi::Env env, const Napi::Value& value, std::vector<unsigned char>& output)
+		{
+			if(value.IsString()){
+				return ChmpxSndBody::AppendString(env, value, output);
+			}
+			unsigned char*	pdata	= NULL;
+			size_t			length	= 0;
+			if(!ChmpxGetBinaryData(value, pdata, length)){
+				Napi::TypeError::New(env, "Wrong send data piece is specified.").ThrowAsJavaScriptException();
+				return false;
+			}
+			if(0 < length){
+				if(!pdata){
+					Napi::TypeError::New(env, "Could not access send data piece.").ThrowAsJavaScriptException();
+					return false;
+				}
+				size_t	offset = output.size();
+				output.resize(offset + length);
+				memcpy(&output[offset], pdata, length);
+			}
+			return true;
+		}
+
+	public:
+		ChmpxSndBody() : is_shared(!ChmpxSndBody::GetScratchInUse()), scratch(is_shared ? ChmpxSndBody::GetScratch() : ownbuf), pbody(NULL), length(0), is_gathered(false)
+		{
+			if(is_shared){
+				ChmpxSndBody::GetScratchInUse() = true;
+			}
+		}
+
+		~ChmpxSndBody()
+		{
+			if(is_shared){
+				if(ChmpxSndBody::SCRATCH_KEEP_SIZE < scratch.capacity()){
+					std::vector<unsigned char>().swap(scratch);
+				}
+				ChmpxSndBody::GetScratchInUse() = false;
+			}
+		}
+
+		ChmpxSndBody(const ChmpxSndBody&) = delete;
+		ChmpxSndBody& operator=(const ChmpxSndBody&) = delete;
+
+		bool Set(Napi::Env env, const Napi::Value& value, size_t headroom = 0)
+		{
+			if(value.IsArray()){
+				Napi::Array	pieces	= value.As<Napi::Array>();
+				uint32_t	count	= pieces.Length();
+
+				scratch.resize(headroom);
+				for(uint32_t pos = 0; pos < count; ++pos){
+					if(!ChmpxSndBody::AppendPiece(env, pieces.Get(pos), scratch)){
+						return false;
+					}
+				}
+			}else if(value.IsString()){
+				scratch.resize(headroom);
+				if(!ChmpxSndBody::AppendString(env, value, scratch)){
+					return false;
+				}
+			}else{
+				unsigned char*	pbinptr	= NULL;
+				ssize_t			binLen	= 0;
+				if(!GetChmpxBodyParam(env, value, pbinptr, binLen)){
+					return false;
+				}
+				if(0 == headroom){
+					owner		= value.As<Napi::Object>();
+					pbody		= pbinptr;
+					length		= binLen;
+					is_gathered	= false;
+					return true;
+				}
+				scratch.resize(headroom + static_cast<size_t>(binLen));
+				if(0 < binLen){
+					memcpy(&scratch[headroom], pbinptr, static_cast<size_t>(binLen));
+				}
+			}
+			if(scratch.empty()){
+				scratch.reserve(1);												// for the valid pointer of empty body
+			}
+			owner		= Napi::Object();
+			pbody		= scratch.data();
+			length		= static_cast<ssize_t>(scratch.size());
+			is_gathered	= true;
+			return true;
+		}
+
+		// Data and Length include the headroom
+		unsigned char* Data(void) const { return pbody; }
+		ssize_t Length(void) const { return length; }
+		bool IsGathered(void) const { return is_gathered; }
+
+		// The object which has Data() if it is not gathered(referenced by async worker)
+		Napi::Object Owner(void) const { return owner; }
+
+		chmhash_t GetHash(void) const
+		{
+			ChmBinData	bindata;
+			bindata.Set(pbody, static_cast<size_t>(length));
+			return bindata.GetHash();
+		}
+
+		// Move the gathered body to output(Data() is still valid)
+		void Detach(std::vector<unsigned char>& output)
+		{
+			if(is_gathered){
+				output.swap(scratch);
+				scratch.clear();
+			}
+		}
+
+	protected:
+		std::vector<unsigned char>	ownbuf;							// used when the scratch buffer is in use(reentered)
+		bool						is_shared;						// scratch is the thread local scratch buffer
+		std::vector<unsigned char>&	scratch;
+		Napi::Object				owner;
+		unsigned char*				pbody;
+		ssize_t						length;
+		bool						is_gathered;
+};
+
+//
+// Send(or Broadcast) each data in list
+//
+// [NOTE]
+// The hash value of each data is calculated here, so that it
+// is calculated on the worker thread for async.
+// The receiver count for each data is set in counts, -1 means
+// failure. Returns false if all of data failed to send.
+//
+inline bool ChmpxSendDataList(ChmpxCntrl* pchmcntrl, msgid_t msgid, const chmpxsndlist_t& sndlist, bool is_broadcast, bool is_routing, chmpxsndcnts_t& counts)
+{
+	bool	result = sndlist.empty();
+
+	counts.clear();
+	counts.reserve(sndlist.size());
+	for(chmpxsndlist_t::const_iterator iter = sndlist.begin(); iter != sndlist.end(); ++iter){
+		ChmBinData	bindata;
+		long		recievercnt	= 0;
+		bool		sendresult;
+
+		bindata.Set(iter->pBody, iter->length);
+		if(is_broadcast){
+			sendresult = pchmcntrl->Broadcast(msgid, iter->pBody, iter->length, bindata.GetHash(), &recievercnt);
+		}else{
+			sendresult = pchmcntrl->Send(msgid, iter->pBody, iter->length, bindata.GetHash(), &recievercnt, is_routing);
+		}
+		if(sendresult){
+			counts.push_back(static_cast<int32_t>(recievercnt));
+			result = true;
+		}else{
+			counts.push_back(-1);
+		}
+	}
+	return result;
+}
+
+//
+// Create Int32Array from receiver counts
+//
+inline Napi::Int32Array ChmpxSendCountsToArray(Napi::Env env, const chmpxsndcnts_t& counts)
+{
+	Napi::Int32Array	cntarr = Napi::Int32Array::New(env, counts.size());
+	for(size_t pos = 0; pos < counts.size(); ++pos){
+		cntarr[pos] = counts[pos];
+	}
+	return cntarr;
+}
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
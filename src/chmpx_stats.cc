@@ -0,0 +1,138 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#include "chmpx_stats.h"
+
+using namespace std;
+
+//---------------------------------------------------------
+// ChmpxStats Class
+//---------------------------------------------------------
+static const char*	stc_stats_opnames[CHMPX_STATS_OP_COUNT] = {
+	"send",
+	"broadcast",
+	"receive",
+	"reply",
+	"open",
+	"close",
+	"request"
+};
+
+const char* ChmpxStats::GetOpName(CHMPXSTATSOP op)
+{
+	if(op < CHMPX_STATS_SEND || CHMPX_STATS_OP_COUNT <= op){
+		return "unknown";
+	}
+	return stc_stats_opnames[op];
+}
+
+ChmpxStats::ChmpxStats()
+{
+	Reset();
+}
+
+size_t ChmpxStats::GetLatencyBucket(uint64_t usec)
+{
+	size_t	bucket = 0;
+	for(usec >>= 1; 0 < usec && bucket < (ChmpxStats::LATENCY_BUCKET_COUNT - 1); usec >>= 1){
+		++bucket;
+	}
+	return bucket;
+}
+
+void ChmpxStats::Record(CHMPXSTATSOP op, bool is_success, bool is_timeout, size_t bytes, const statsclock_t::time_point& start)
+{
+	if(op < CHMPX_STATS_SEND || CHMPX_STATS_OP_COUNT <= op){
+		return;
+	}
+	ChmpxOpStats&	stats	= opstats[op];
+	int64_t			usec	= chrono::duration_cast<chrono::microseconds>(statsclock_t::now() - start).count();
+
+	if(is_timeout){
+		stats.timeouts.fetch_add(1, memory_order_relaxed);
+	}else if(is_success){
+		stats.count.fetch_add(1, memory_order_relaxed);
+		stats.bytes.fetch_add(bytes, memory_order_relaxed);
+	}else{
+		stats.errors.fetch_add(1, memory_order_relaxed);
+	}
+	stats.latency[ChmpxStats::GetLatencyBucket(0 < usec ? static_cast<uint64_t>(usec) : 0)].fetch_add(1, memory_order_relaxed);
+}
+
+void ChmpxStats::Reset(void)
+{
+	for(size_t op = 0; op < CHMPX_STATS_OP_COUNT; ++op){
+		opstats[op].count.store(0, memory_order_relaxed);
+		opstats[op].errors.store(0, memory_order_relaxed);
+		opstats[op].timeouts.store(0, memory_order_relaxed);
+		opstats[op].bytes.store(0, memory_order_relaxed);
+		for(size_t bucket = 0; bucket < ChmpxStats::LATENCY_BUCKET_COUNT; ++bucket){
+			opstats[op].latency[bucket].store(0, memory_order_relaxed);
+		}
+	}
+}
+
+//
+// Make the object for getStats
+//
+// {
+//		send: {
+//			count:		number,
+//			errors:		number,
+//			timeouts:	number,
+//			bytes:		number,
+//			latency:	number[]		// log2 bucketed by us
+//		},
+//		broadcast: {...},
+//		...
+// }
+//
+Napi::Object ChmpxStats::ToObject(Napi::Env env) const
+{
+	Napi::Object	result = Napi::Object::New(env);
+	for(size_t op = 0; op < CHMPX_STATS_OP_COUNT; ++op){
+		const ChmpxOpStats&	stats	= opstats[op];
+		Napi::Object		opobj	= Napi::Object::New(env);
+		Napi::Array			latency	= Napi::Array::New(env, ChmpxStats::LATENCY_BUCKET_COUNT);
+
+		opobj.Set("count",		Napi::Number::New(env, static_cast<double>(stats.count.load(memory_order_relaxed))));
+		opobj.Set("errors",		Napi::Number::New(env, static_cast<double>(stats.errors.load(memory_order_relaxed))));
+		opobj.Set("timeouts",	Napi::Number::New(env, static_cast<double>(stats.timeouts.load(memory_order_relaxed))));
+		opobj.Set("bytes",		Napi::Number::New(env, static_cast<double>(stats.bytes.load(memory_order_relaxed))));
+		for(size_t bucket = 0; bucket < ChmpxStats::LATENCY_BUCKET_COUNT; ++bucket){
+			latency.Set(static_cast<uint32_t>(bucket), Napi::Number::New(env, static_cast<double>(stats.latency[bucket].load(memory_order_relaxed))));
+		}
+		opobj.Set("latency",	latency);
+
+		result.Set(ChmpxStats::GetOpName(static_cast<CHMPXSTATSOP>(op)), opobj);
+	}
+	return result;
+}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,106 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_STATS_H
+#define CHMPX_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include "chmpx_common.h"
+
+//---------------------------------------------------------
+// Operation types for statistics
+//---------------------------------------------------------
+typedef enum chmpx_stats_op{
+	CHMPX_STATS_SEND = 0,
+	CHMPX_STATS_BROADCAST,
+	CHMPX_STATS_RECEIVE,
+	CHMPX_STATS_REPLY,
+	CHMPX_STATS_OPEN,
+	CHMPX_STATS_CLOSE,
+	CHMPX_STATS_REQUEST,
+	CHMPX_STATS_OP_COUNT
+}CHMPXSTATSOP;
+
+//---------------------------------------------------------
+// ChmpxStats Class
+//---------------------------------------------------------
+// [NOTE]
+// This class has the counters and the latency histogram for each
+// operation. The counters are relaxed atomic variables, so they
+// can be updated from any thread(JS thread, worker pool threads,
+// receiving threads) without locking. Each operation is aligned
+// to the cache line to avoid false sharing between operations.
+//
+// The latency histogram is log2 bucketed by microseconds, the
+// bucket N counts the latency less than 2^(N+1) us(and not less
+// than 2^N us except bucket 0), and the last bucket counts all
+// latency over it.
+// The values are not a consistent snapshot while operations are
+// running, because each counter is read separately.
+//
+class ChmpxStats
+{
+	public:
+		static const size_t	LATENCY_BUCKET_COUNT = 32;
+
+		typedef std::chrono::steady_clock	statsclock_t;
+
+	protected:
+		struct alignas(64) ChmpxOpStats
+		{
+			std::atomic<uint64_t>	count;					// succeeded
+			std::atomic<uint64_t>	errors;					// failed
+			std::atomic<uint64_t>	timeouts;				// timeouted(receive and request)
+			std::atomic<uint64_t>	bytes;					// body bytes
+			std::atomic<uint64_t>	latency[LATENCY_BUCKET_COUNT];
+		};
+
+	public:
+		ChmpxStats();
+
+		static statsclock_t::time_point Now(void) { return statsclock_t::now(); }
+		static const char* GetOpName(CHMPXSTATSOP op);
+
+		void Record(CHMPXSTATSOP op, bool is_success, bool is_timeout, size_t bytes, const statsclock_t::time_point& start);
+		void Reset(void);
+
+		// Run on JS thread
+		Napi::Object ToObject(Napi::Env env) const;
+
+	protected:
+		static size_t GetLatencyBucket(uint64_t usec);
+
+	protected:
+		ChmpxOpStats	opstats[CHMPX_STATS_OP_COUNT];
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -0,0 +1,106 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+#ifndef CHMPX_THRLIST_H
+#define CHMPX_THRLIST_H
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include "chmpx_common.h"
+
+//---------------------------------------------------------
+// ChmpxThreadTask Class
+//---------------------------------------------------------
+// [NOTE]
+// This is the base class of the objects which run their own
+// thread with ChmpxCntrl of ChmpxNode(ex. the receiving stream
+// of messages(), the sender of send ring).
+// Stop must be callable on any thread and more than once, and
+// it returns after the thread exits.
+//
+class ChmpxThreadTask
+{
+	public:
+		virtual ~ChmpxThreadTask() {}
+		virtual bool Stop(void) = 0;
+};
+
+typedef std::shared_ptr<ChmpxThreadTask>	ChmpxThreadTaskPtr;
+
+//---------------------------------------------------------
+// ChmpxThreadList Class
+//---------------------------------------------------------
+// [NOTE]
+// ChmpxNode has the running thread tasks in this list, and stops
+// them before its resources are cleaned up(or drained), because
+// they use ChmpxCntrl of the node.
+// The tasks are stopped out of the lock, because Stop waits for
+// the thread.
+//
+class ChmpxThreadList
+{
+	public:
+		void Add(const ChmpxThreadTaskPtr& task)
+		{
+			std::lock_guard<std::mutex>	guard(list_lock);
+			tasks.insert(task);
+		}
+
+		void Remove(const ChmpxThreadTaskPtr& task)
+		{
+			std::lock_guard<std::mutex>	guard(list_lock);
+			tasks.erase(task);
+		}
+
+		// returns the count of stopped tasks which were running
+		size_t StopAll(void)
+		{
+			std::set<ChmpxThreadTaskPtr>	stopping;
+			{
+				std::lock_guard<std::mutex>	guard(list_lock);
+				stopping.swap(tasks);
+			}
+			size_t	count = 0;
+			for(std::set<ChmpxThreadTaskPtr>::const_iterator iter = stopping.begin(); iter != stopping.end(); ++iter){
+				if((*iter)->Stop()){
+					++count;
+				}
+			}
+			return count;
+		}
+
+	protected:
+		std::mutex						list_lock;
+		std::set<ChmpxThreadTaskPtr>	tasks;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
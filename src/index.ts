@@ -136,6 +136,188 @@ function copyPropsToFactory(chmpxFactory: AnyFn, factory_native: any)
 	}
 }
 
+//---------------------------------------------------------
+// Send ring
+//---------------------------------------------------------
+// [NOTE]
+// The layout of the SharedArrayBuffer of ChmpxSendRing, these must
+// be the same as src/chmpx_sendring.h.
+//
+const	RING_HEAD				= 0;
+const	RING_TAIL				= 1;
+const	RING_SLEEPING			= 2;
+const	RING_CLOSED				= 3;
+const	RING_CAPACITY			= 4;
+const	RING_HEADER_SIZE		= 64;
+const	RING_RECORD_HEADER_SIZE	= 16;
+const	RING_RECORD_HAS_HASH	= 0x1;
+const	RING_WRAP_MARK			= 0xFFFFFFFF;
+
+type RingViews = {
+	header:		Int32Array;
+	words:		Uint32Array;
+	bytes:		Uint8Array;
+	capacity:	number;
+};
+
+const	_ringViews = new WeakMap<object, RingViews>();
+
+function getRingViews(ring: any): RingViews
+{
+	let	views = _ringViews.get(ring);
+	if(!views){
+		const	buffer	= ring.buffer;
+		const	header	= new Int32Array(buffer, 0, RING_HEADER_SIZE / 4);
+		views = {
+			header:		header,
+			words:		new Uint32Array(buffer, RING_HEADER_SIZE),
+			bytes:		new Uint8Array(buffer, RING_HEADER_SIZE),
+			capacity:	Atomics.load(header, RING_CAPACITY)
+		};
+		_ringViews.set(ring, views);
+	}
+	return views;
+}
+
+//
+// Split the hash into low and high 32 bits
+//
+function splitRingHash(hash: number | bigint): [number, number]
+{
+	if(typeof hash === 'bigint'){
+		const	hex = (hash as any).toString(16).padStart(16, '0');
+		return [parseInt(hex.slice(-8), 16), parseInt(hex.slice(-16, -8), 16)];
+	}
+	return [(hash % 4294967296) >>> 0, Math.floor(hash / 4294967296) >>> 0];
+}
+
+// [NOTE]
+// push() of ChmpxSendRing writes one record in JS only, and calls
+// notify() only when the sender is waiting. Returns false if the
+// ring is full or closed(the record is not written).
+//
+function ringPush(this: any, body: Uint8Array, hash?: number | bigint): boolean
+{
+	if(!(body instanceof Uint8Array)){
+		throw new TypeError('The body must be Buffer or Uint8Array.');
+	}
+	const	views	= getRingViews(this);
+	const	header	= views.header;
+	const	recsize	= RING_RECORD_HEADER_SIZE + ((body.length + 7) & ~7);
+	if(views.capacity < recsize){
+		throw new RangeError('The body is too large for the ring.');
+	}
+	if(0 !== Atomics.load(header, RING_CLOSED)){
+		return false;
+	}
+
+	// free space(the record is not split at the end of data area)
+	//
+	// [NOTE]
+	// If the record does not fit in the rest of data area, the wrap
+	// marker is published by itself first. Then the record is checked
+	// from the head of data area, so that a record which is larger than
+	// the rest never makes the ring full forever.
+	//
+	const	head	= Atomics.load(header, RING_HEAD) >>> 0;
+	let		tail	= Atomics.load(header, RING_TAIL) >>> 0;
+	let		free	= views.capacity - ((tail - head) >>> 0);
+	let		offset	= tail & (views.capacity - 1);
+	const	rest	= views.capacity - offset;
+	if(rest < recsize){
+		if(free < rest){
+			return false;
+		}
+		views.words[offset >>> 2]	= RING_WRAP_MARK;
+		tail						= (tail + rest) >>> 0;
+		free						-= rest;
+		offset						= 0;
+		Atomics.store(header, RING_TAIL, tail | 0);
+	}
+	if(free < recsize){
+		ringDoorbell(this, header);			// for the wrap marker
+		return false;
+	}
+
+	// write record and publish it
+	const	word = offset >>> 2;
+	views.words[word] = body.length;
+	if(undefined === hash || null === hash){
+		views.words[word + 1] = 0;
+	}else{
+		const	[low, high] = splitRingHash(hash);
+		views.words[word + 1] = RING_RECORD_HAS_HASH;
+		views.words[word + 2] = low;
+		views.words[word + 3] = high;
+	}
+	views.bytes.set(body, offset + RING_RECORD_HEADER_SIZE);
+	Atomics.store(header, RING_TAIL, (tail + recsize) | 0);
+
+	ringDoorbell(this, header);
+	return true;
+}
+
+//
+// Wake up the sender only when it is waiting
+//
+function ringDoorbell(ring: any, header: Int32Array): void
+{
+	if(0 !== Atomics.load(header, RING_SLEEPING)){
+		ring.notify();
+	}
+}
+
+// [NOTE]
+// Add the methods written in JS to the prototypes of native objects.
+//	- createReadStream() of ChmpxNode is the object mode Readable over
+//	  the async iterator which is returned by messages(), and the
+//	  arguments are the same as it. Readable.from() pulls the next
+//	  data only while its buffer has less than highWaterMark, so the
+//	  native receiving is paused too.
+//	- push() of ChmpxSendRing is added when openSendRing() returns
+//	  the first ring, because its constructor is not exported.
+//
+function installJsMethods(js_native: any)
+{
+	const	nodeCtor = (js_native && typeof js_native.ChmpxNode === 'function') ? js_native.ChmpxNode : undefined;
+	if(!nodeCtor || !nodeCtor.prototype || typeof nodeCtor.prototype.createReadStream === 'function'){
+		return;
+	}
+
+	const	openSendRing = nodeCtor.prototype.openSendRing;
+	if(typeof openSendRing === 'function'){
+		Object.defineProperty(nodeCtor.prototype, 'openSendRing', {
+			value: function(this: any, ...args: any[]): any
+			{
+				const	ring	= openSendRing.apply(this, args);
+				const	proto	= ring ? Object.getPrototypeOf(ring) : undefined;
+				if(proto && typeof proto.push !== 'function'){
+					Object.defineProperty(proto, 'push', { value: ringPush, writable: true, configurable: true, enumerable: false });
+				}
+				return ring;
+			},
+			writable:		true,
+			configurable:	true,
+			enumerable:		false
+		});
+	}
+
+	Object.defineProperty(nodeCtor.prototype, 'createReadStream', {
+		value: function(this: any, ...args: any[]): any
+		{
+			// eslint-disable-next-line @typescript-eslint/no-var-requires
+			const	{ Readable }	= require('stream');
+			const	options			= args.find((arg: any) => (arg && typeof arg === 'object' && !Buffer.isBuffer(arg) && typeof arg.highWaterMark === 'number'));
+			const	iterator		= this.messages(...args);
+
+			return Readable.from(iterator, { objectMode: true, highWaterMark: (options ? options.highWaterMark : 16) });
+		},
+		writable:		true,
+		configurable:	true,
+		enumerable:		false
+	});
+}
+
 // [NOTE]
 // Load native on first need. Also call copyPropsToFactory once after
 // loading.
@@ -170,6 +352,11 @@ function ensureNative(): any
 		}catch{
 			// swallow copy errors to preserve robustness
 		}
+		try{
+			installJsMethods(_native);
+		}catch{
+			// createReadStream and push of send ring are not available
+		}
 	}
 	return _native;
 }
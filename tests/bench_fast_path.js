@@ -0,0 +1,126 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * AUTHOR:   Takeshi Nakatani
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+//---------------------------------------------------------
+// Fast path Microbenchmark
+//---------------------------------------------------------
+// [Purpose]
+//	Measure the per-call overhead which is removed by the fast path
+//	methods(sendFast, receiveFast).
+//
+// [Outline]
+//	This has two modes.
+//
+//	- Argument parsing only(no configuration file)
+//	  Use ChmpxNode object which is not initialized, so that each
+//	  call fails soon after argument handling and does not need the
+//	  chmpx process. The numbers are only the cost of argument
+//	  handling(and the emitter slot check of send/receive), and do
+//	  not include sending and receiving.
+//	- Round trip on slave(with configuration file)
+//	  Initialize ChmpxNode on slave chmpx, and send to the server
+//	  node which replies to each data(tests/run_process_helper.sh
+//	  start_chmpx_server, start_node_server and start_chmpx_slave).
+//	  Each measurement of send is followed by the measurement of
+//	  receive which takes all of replies, so that the replies are
+//	  not left in the queue.
+//
+//	Both call send/sendFast and receive/receiveFast the same count,
+//	and print ns per call and the ratio.
+//	An emitter callback for other operation is set, so that the
+//	emitter slots are not empty.
+//
+// [Usage]
+//	node tests/bench_fast_path.js [count(default 1000000, 10000 on slave)] [slave configuration file]
+//---------------------------------------------------------
+
+const	chmpx	= require('../');
+
+const	SLAVECONF	= process.argv[3] || null;
+const	COUNT		= parseInt(process.argv[2] || (SLAVECONF ? '10000' : '1000000'), 10);
+const	WARMUP		= Math.min(COUNT, SLAVECONF ? 1000 : 10000);
+const	RCVTIMEOUT	= SLAVECONF ? 1000 : 0;
+
+function measure(name, func, count)
+{
+	const	start = process.hrtime.bigint();
+	for(let cnt = 0; cnt < count; ++cnt){
+		func();
+	}
+	const	nspercall = Number(process.hrtime.bigint() - start) / count;
+	if(name){
+		console.log(name.padEnd(32) + nspercall.toFixed(1).padStart(12) + ' ns/call');
+	}
+	return nspercall;
+}
+
+//
+// Measure sending, then receiving which takes the replies
+//
+function measurePair(sendname, sendfunc, rcvname, rcvfunc)
+{
+	measure(null, sendfunc, WARMUP);
+	measure(null, rcvfunc, WARMUP);
+	return [measure(sendname, sendfunc, COUNT), measure(rcvname, rcvfunc, COUNT)];
+}
+
+const	chmpxobj	= chmpx();
+const	body		= Buffer.from('benchmark body');
+const	rcvarr		= [];
+let		msgid		= Buffer.alloc(8);
+
+chmpxobj.on('open', function(){});
+
+if(SLAVECONF){
+	if(!chmpxobj.initializeOnSlave(SLAVECONF, true)){
+		console.error('Could not initialize on slave chmpx with ' + SLAVECONF);
+		process.exit(1);
+	}
+	if(null === (msgid = chmpxobj.open())){
+		console.error('Could not open msgid on slave chmpx.');
+		process.exit(1);
+	}
+	console.log('mode : round trip on slave(' + SLAVECONF + ')');
+}else{
+	console.log('mode : argument parsing only(not initialized, each call fails)');
+}
+console.log('count: ' + COUNT);
+
+const	[sendns,		rcvns]		= measurePair('send(msgid, body)',		() => chmpxobj.send(msgid, body),		'receive(msgid, arr, ' + RCVTIMEOUT + ')',	() => chmpxobj.receive(msgid, rcvarr, RCVTIMEOUT));
+const	[sendfastns,	rcvfastns]	= measurePair('sendFast(msgid, body)',	() => chmpxobj.sendFast(msgid, body),	'receiveFast(msgid, ' + RCVTIMEOUT + ')',		() => chmpxobj.receiveFast(msgid, RCVTIMEOUT));
+
+console.log('send    : fast path is ' + (sendns / sendfastns).toFixed(2) + 'x');
+console.log('receive : fast path is ' + (rcvns / rcvfastns).toFixed(2) + 'x');
+
+if(SLAVECONF){
+	chmpxobj.close(msgid);
+}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
@@ -49,6 +49,9 @@ if(!chmpxserverobj.initializeOnServer(ini_file_path, true)){
 	process.exit(1);
 }
 
+// for request() of slave tests
+chmpxserverobj.setReceiveOptions({ requestHeader: true });
+
 //
 // Loop for receiving data on server process
 //
@@ -81,6 +81,37 @@ const sendReceive = (msgid: Buffer, data: Buffer, timeout_ms: number, bcast: boo
 	return true;
 };
 
+//
+// Send all data and Receive the replies in order
+//
+const sendReceiveOrdered = (msgid: Buffer, datas: Buffer[], timeout_ms: number): boolean => 
+{
+	for(const data of datas){
+		const result: number = chmpxslaveobj.send(msgid, data);
+		console.log('<--- Send(%s(hex)) : %s', msgid.toString('hex'), result);
+		if(-1 === result){
+			console.log('[ERROR] Send : [msgid:%s][data:%s], Result : false', msgid.toString('hex'), data.toString('hex'));
+			return false;
+		}
+	}
+
+	for(const data of datas){
+		const bufarr: [Buffer?, Buffer?] = [];
+		if(!chmpxslaveobj.receive(msgid, bufarr, timeout_ms) || bufarr.length < 2){
+			console.log('[ERROR] Receive(%s(hex)) : no reply for \"%s\"', msgid.toString('hex'), data.toString());
+			return false;
+		}
+		const expected: string = 'Reply(' + data.toString() + ')';
+		console.log('---> Receive(%s(hex)) : \"%s\"(utf8)', msgid.toString('hex'), (bufarr[1] as Buffer).toString());
+		if(expected !== (bufarr[1] as Buffer).toString()){
+			console.log('[ERROR] Receive(%s(hex)) : the reply is not in order, expected \"%s\"', msgid.toString('hex'), expected);
+			return false;
+		}
+	}
+	console.log();
+	return true;
+};
+
 //-------------------------------------------------------------------
 // Run chmpx nodejs for slave process
 //
@@ -117,11 +148,46 @@ const result: boolean = sendReceive(msgid1, Buffer.from('msgid1: after Close()')
 console.log('<- SendAfterClose(%s(hex)) : %s', msgid1.toString('hex'), result);
 
 //
-// Stop receiving server process
+// For receiving loop on server process
+//
+// [NOTE]
+// Wait for the server process to stop the receiving loop before
+// sending the next message.
+//
+sendReceive(msgid2, Buffer.from('receiving loop.'), 1000, false);				// receiving loop
+sleep(1000);
+
+//
+// For receive options on server process
 //
-sendReceive(msgid2, Buffer.from('BREAK TEST'), 1000, false);			// for stop server process
+sendReceive(msgid2, Buffer.from('zero copy receive.'), 1000, false);			// zero copy receive
+sendReceive(msgid2, Buffer.from('utf8 receive.'), 1000, false);					// utf8 receive
 
-process.exit(0);
+//
+// For reply bodies on server process
+//
+sendReceive(msgid2, Buffer.from('reply pieces.'), 1000, false);					// reply with array body
+sendReceive(msgid2, Buffer.from('reply fast.'), 1000, false);					// replyFast with string body
+sendReceiveOrdered(msgid2, [Buffer.from('reply lane 1'), Buffer.from('reply lane 2')], 1000);	// replies in reply lane
+
+//
+// Request(the reply is received by the request channel on msgid3)
+//
+const msgid3: Buffer = chmpxslaveobj.open();
+console.log('-> Open(msgid3): %s', msgid3.toString('hex'));
+
+chmpxslaveobj.request(msgid3, 'request body.', 3000).then((reply: Buffer) => {
+	console.log('---> Request(%s(hex)) : \"%s\"(utf8)', msgid3.toString('hex'), reply.toString());
+}).catch((error: any) => {
+	console.log('[ERROR] Request(%s(hex)) : %s', msgid3.toString('hex'), error);
+}).finally(() => {
+	//
+	// Stop receiving server process
+	//
+	sendReceive(msgid2, Buffer.from('BREAK TEST'), 1000, false);		// for stop server process
+
+	process.exit(0);
+});
 
 /*
  * Local variables:
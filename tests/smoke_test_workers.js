@@ -0,0 +1,121 @@
+/*
+ * CHMPX
+ *
+ * Copyright 2015 Yahoo Japan Corporation.
+ *
+ * CHMPX is inprocess data exchange by MQ with consistent hashing.
+ * CHMPX is made for the purpose of the construction of
+ * original messaging system and the offer of the client
+ * library.
+ * CHMPX transfers messages between the client and the server/
+ * slave. CHMPX based servers are dispersed by consistent
+ * hashing and are automatically laid out. As a result, it
+ * provides a high performance, a high scalability.
+ *
+ * For the full copyright and license information, please view
+ * the license file that was distributed with this source code.
+ *
+ * AUTHOR:   Takeshi Nakatani
+ * CREATE:   Sat Oct 17 2026
+ * REVISION:
+ *
+ */
+
+//---------------------------------------------------------
+// worker_threads Smoke Test
+//---------------------------------------------------------
+// [Purpose]
+//	Verify that the module can be loaded in several worker_threads
+//	environments at the same time, and that each environment has
+//	its own ChmpxNode class(constructor) and worker thread pool.
+//
+// [Outline]
+//	- Start some workers, and each worker loads the project root
+//	  package with require('../').
+//	- Each worker constructs ChmpxNode objects(each has its own
+//	  ChmCntrl), calls some methods which do not need the chmpx
+//	  process, and configures the worker thread pool of its own
+//	  environment.
+//	- The main thread also uses the module while the workers are
+//	  running, and waits for all workers to exit.
+//
+// [Expected]
+//		worker N: ok
+//		all workers exited
+//
+// [Meaning of Failure]
+//	- require failed in worker
+//		The native module is not loadable in several environments
+//		(not context-aware).
+//	- process crashed or a worker exited abnormally
+//		The global state is shared between environments, or it is
+//		not freed correctly when the environment is torn down.
+//---------------------------------------------------------
+
+const	{ Worker, isMainThread, parentPort, workerData }	= require('worker_threads');
+
+const	WORKER_COUNT = 4;
+
+//
+// Use the module in this environment
+//
+function useModule(name)
+{
+	const	mod			= require('../');
+	const	chmpxobj1	= new mod.ChmpxNode();
+	const	chmpxobj2	= mod();
+
+	if(typeof chmpxobj1 !== 'object' || typeof chmpxobj2 !== 'object'){
+		throw new Error(name + ': ChmpxNode is not constructed');
+	}
+	// [NOTE]
+	// The methods check that the object is an instance of ChmpxNode
+	// class in this environment, and throw TypeError if not.
+	//
+	if(typeof chmpxobj2.isChmpxExit() !== 'boolean'){
+		throw new Error(name + ': isChmpxExit failed');
+	}
+	if(!mod.ChmpxNode.configurePool({ size: 2, threadName: 'chmpx-smoke' })){
+		throw new Error(name + ': configurePool failed');
+	}
+	if(typeof chmpxobj1.getStats().send.count !== 'number'){
+		throw new Error(name + ': getStats failed');
+	}
+}
+
+if(isMainThread){
+	try{
+		const	workers = [];
+		for(let cnt = 0; cnt < WORKER_COUNT; ++cnt){
+			workers.push(new Promise((resolve, reject) => {
+				const	worker = new Worker(__filename, { workerData: { index: cnt } });
+				worker.on('message',	(msg) => { console.log(msg); });
+				worker.on('error',		reject);
+				worker.on('exit',		(code) => { (0 === code) ? resolve() : reject(new Error('worker ' + cnt + ' exited with ' + code)); });
+			}));
+		}
+		useModule('main');
+
+		Promise.all(workers).then(() => {
+			console.log('all workers exited');
+		}).catch((err2) => {
+			console.error('worker failed:', err2 && err2.message);
+			process.exit(1);
+		});
+	}catch(err1){
+		console.error('worker_threads test failed:', err1 && err1.message);
+		process.exit(1);
+	}
+}else{
+	useModule('worker ' + workerData.index);
+	parentPort.postMessage('worker ' + workerData.index + ': ok');
+}
+
+/*
+ * Local variables:
+ * tab-width: 4
+ * c-basic-offset: 4
+ * End:
+ * vim600: noexpandtab sw=4 ts=4 fdm=marker
+ * vim<600: noexpandtab sw=4 ts=4
+ */
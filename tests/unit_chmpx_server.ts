@@ -405,6 +405,179 @@ describe('CHMPX SERVER', function(){
 		done();
 	});
 
+	//
+	// ChmpxNode::startReceiving(), stopReceiving()
+	//
+	it('Server test - ChmpxNode::startReceiving(), stopReceiving()', function(done){
+		expect(chmpxserverobj.startReceiving(100, function(error: any, compkt: Buffer, data: Buffer)
+		{
+			expect(error).to.be.null;
+			if(!data || 0 == data.length){
+				return;
+			}
+			const receive_str = data.toString();
+			expect(receive_str).to.equal('receiving loop.');
+
+			const replydata = Buffer.from('Reply(' + receive_str + ')');
+			expect(chmpxserverobj.reply(compkt, replydata)).to.be.a('boolean').to.be.true;
+
+			expect(chmpxserverobj.stopReceiving()).to.be.a('boolean').to.be.true;
+			done();
+		})).to.be.a('boolean').to.be.true;
+
+		// already started
+		expect(chmpxserverobj.startReceiving(100, function(){})).to.be.a('boolean').to.be.false;
+	});
+
+	//
+	// ChmpxNode::stopReceiving() - does not wait for the thread
+	//
+	it('Server test - ChmpxNode::stopReceiving() - restart at once', function(done){
+		expect(chmpxserverobj.startReceiving(1000, function(){})).to.be.a('boolean').to.be.true;
+		expect(chmpxserverobj.stopReceiving()).to.be.a('boolean').to.be.true;
+
+		// the stopping thread is not waited, so a new loop starts at once
+		expect(chmpxserverobj.startReceiving(1000, function(){})).to.be.a('boolean').to.be.true;
+		expect(chmpxserverobj.stopReceiving()).to.be.a('boolean').to.be.true;
+		expect(chmpxserverobj.stopReceiving()).to.be.a('boolean').to.be.false;
+		done();
+	});
+
+	//
+	// ChmpxNode::setReceiveOptions() - zeroCopy
+	//
+	it('Server test - ChmpxNode::setReceiveOptions() - zeroCopy', function(done){
+		expect(chmpxserverobj.setReceiveOptions({ zeroCopy: true })).to.be.a('boolean').to.be.true;
+		while(true){
+			const outarr: Buffer[] = [];
+
+			expect(chmpxserverobj.receive(outarr, 2000)).to.be.a('boolean').to.be.true;
+			if(0 != outarr[1].length){
+				// the body wraps the received memory
+				expect(outarr[1]).to.be.an.instanceof(Buffer);
+				const receive_str = outarr[1].toString();
+				expect(receive_str).to.equal('zero copy receive.');
+
+				const replydata = Buffer.from('Reply(' + receive_str + ')');
+				expect(chmpxserverobj.reply(outarr[0], replydata)).to.be.a('boolean').to.be.true;
+
+				break;
+			}
+		}
+		expect(chmpxserverobj.setReceiveOptions({ zeroCopy: false })).to.be.a('boolean').to.be.true;
+		done();
+	});
+
+	//
+	// ChmpxNode::setReceiveOptions() - utf8
+	//
+	it('Server test - ChmpxNode::setReceiveOptions() - utf8', function(done){
+		expect(chmpxserverobj.setReceiveOptions({ encoding: 'utf8' })).to.be.a('boolean').to.be.true;
+		while(true){
+			const outarr: any[] = [];
+
+			expect(chmpxserverobj.receive(outarr, 2000)).to.be.a('boolean').to.be.true;
+			if(0 != outarr[1].length){
+				// the body is decoded to string
+				expect(outarr[1]).to.be.a('string').to.equal('utf8 receive.');
+
+				const replydata = Buffer.from('Reply(' + outarr[1] + ')');
+				expect(chmpxserverobj.reply(outarr[0], replydata)).to.be.a('boolean').to.be.true;
+
+				break;
+			}
+		}
+		expect(chmpxserverobj.setReceiveOptions({ encoding: 'buffer' })).to.be.a('boolean').to.be.true;
+		done();
+	});
+
+	//
+	// ChmpxNode::reply() - array body
+	//
+	it('Server test - ChmpxNode::reply() - array body', function(done){
+		while(true){
+			const outarr: Buffer[] = [];
+
+			expect(chmpxserverobj.receive(outarr, 2000)).to.be.a('boolean').to.be.true;
+			if(0 != outarr[1].length){
+				expect(outarr[1].toString()).to.equal('reply pieces.');
+
+				// the pieces are gathered into one reply
+				expect(chmpxserverobj.reply(outarr[0], ['Reply(', outarr[1], new Uint8Array([0x29])])).to.be.a('boolean').to.be.true;
+
+				break;
+			}
+		}
+		done();
+	});
+
+	//
+	// ChmpxNode::replyFast() - string body
+	//
+	it('Server test - ChmpxNode::replyFast() - string body', function(done){
+		while(true){
+			const outarr: Buffer[] = [];
+
+			expect(chmpxserverobj.receive(outarr, 2000)).to.be.a('boolean').to.be.true;
+			if(0 != outarr[1].length){
+				const receive_str = outarr[1].toString();
+				expect(receive_str).to.equal('reply fast.');
+
+				expect(chmpxserverobj.replyFast(outarr[0], 'Reply(' + receive_str + ')')).to.be.a('boolean').to.be.true;
+
+				// fixed signature
+				expect(function(){ chmpxserverobj.replyFast(outarr[0]); }).to.throw(TypeError);
+
+				break;
+			}
+		}
+		done();
+	});
+
+	//
+	// ChmpxNode::replyAsync() - ordered in reply lane
+	//
+	it('Server test - ChmpxNode::replyAsync() - ordered in reply lane', async function(){
+		const received: Buffer[][] = [];
+		while(received.length < 2){
+			const outarr: Buffer[] = [];
+
+			expect(chmpxserverobj.receive(outarr, 2000)).to.be.a('boolean').to.be.true;
+			if(0 != outarr[1].length){
+				received.push(outarr);
+			}
+		}
+		expect(received[0][1].toString()).to.equal('reply lane 1');
+		expect(received[1][1].toString()).to.equal('reply lane 2');
+
+		// the replies are queued at once, and they run in the queued order in the reply lane
+		await Promise.all(received.map((outarr: Buffer[]) => chmpxserverobj.replyAsync(outarr[0], Buffer.from('Reply(' + outarr[1].toString() + ')'))));
+	});
+
+	//
+	// ChmpxNode::setReceiveOptions() - requestHeader
+	//
+	it('Server test - ChmpxNode::setReceiveOptions() - requestHeader', function(done){
+		expect(chmpxserverobj.setReceiveOptions({ requestHeader: true })).to.be.a('boolean').to.be.true;
+		while(true){
+			const outarr: Buffer[] = [];
+
+			expect(chmpxserverobj.receive(outarr, 2000)).to.be.a('boolean').to.be.true;
+			if(0 != outarr[1].length){
+				// the request header is stripped from the body, and reply() puts it
+				const receive_str = outarr[1].toString();
+				expect(receive_str).to.equal('request body.');
+
+				const replydata = Buffer.from('Reply(' + receive_str + ')');
+				expect(chmpxserverobj.reply(outarr[0], replydata)).to.be.a('boolean').to.be.true;
+
+				break;
+			}
+		}
+		expect(chmpxserverobj.setReceiveOptions({ requestHeader: false })).to.be.a('boolean').to.be.true;
+		done();
+	});
+
 	//
 	// ChmpxNode::Receive() - break
 	//
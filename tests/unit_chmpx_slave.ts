@@ -433,6 +433,56 @@ describe('CHMPX SLAVE', function(){
 		expect(chmpxslaveobj.send(msgid1, Buffer.from('send receive.'))).to.be.a('boolean').to.be.true;
 	});
 
+	//
+	// ChmpxNode::send(), receive() - multiple listeners
+	//
+	it('Slave test - ChmpxNode::send(), receive() - multiple listeners', function(done){
+		expect(msgid1).to.not.be.null;
+
+		let	firstcount	= 0;
+		let	secondcount	= 0;
+		const firstcb	= function(error: any, receivecount: number)
+		{
+			expect(error).to.be.null;
+			++firstcount;
+		};
+		const secondcb	= function(error: any, receivecount: number)
+		{
+			expect(error).to.be.null;
+			++secondcount;
+
+			// both listeners are called in order
+			expect(firstcount).to.equal(1);
+			expect(secondcount).to.equal(1);
+
+			// remove only first listener
+			expect(chmpxslaveobj.off('send', firstcb)).to.be.a('boolean').to.be.true;
+			expect(chmpxslaveobj.off('send', firstcb)).to.be.a('boolean').to.be.false;
+
+			// set for receive
+			expect(chmpxslaveobj.on('receive', function(error: any, compkt: Buffer, data: Buffer)
+			{
+				expect(error).to.be.null;
+				expect(data.toString()).to.equal('Reply(multiple listeners.)');
+
+				// unset all
+				chmpxslaveobj.off('receive');
+				expect(chmpxslaveobj.off('send')).to.be.a('boolean').to.be.true;
+				done();
+			})).to.be.a('boolean').to.be.true;
+
+			expect(chmpxslaveobj.receive(msgid1, 1000)).to.be.a('boolean').to.be.true;
+		};
+
+		// set two listeners(same listener is not added twice)
+		expect(chmpxslaveobj.on('send', firstcb)).to.be.a('boolean').to.be.true;
+		expect(chmpxslaveobj.on('send', secondcb)).to.be.a('boolean').to.be.true;
+		expect(chmpxslaveobj.on('send', firstcb)).to.be.a('boolean').to.be.false;
+
+		// send
+		expect(chmpxslaveobj.send(msgid1, Buffer.from('multiple listeners.'))).to.be.a('boolean').to.be.true;
+	});
+
 	//
 	// ChmpxNode::send(), receive() - onSend/onReceive Callback
 	//
@@ -650,6 +700,852 @@ describe('CHMPX SLAVE', function(){
 		done();
 	});
 
+	//
+	// ChmpxNode::send(), receiveBatch() - No Callback
+	//
+	it('Slave test - ChmpxNode::send(), receiveBatch() - No Callback', function(done){
+		expect(msgid1).to.not.be.null;
+
+		// send
+		expect(chmpxslaveobj.send(msgid1, Buffer.from('batch 1'))).to.not.equal(-1);
+		expect(chmpxslaveobj.send(msgid1, Buffer.from('batch 2'))).to.not.equal(-1);
+		expect(chmpxslaveobj.send(msgid1, Buffer.from('batch 3'))).to.not.equal(-1);
+
+		// receive
+		const rcvstrs: string[] = [];
+		while(rcvstrs.length < 3){
+			const rcvlist: [Buffer, Buffer][] = chmpxslaveobj.receiveBatch(msgid1, 10, 1000);
+			expect(rcvlist).to.be.an('array');
+			expect(rcvlist.length).to.not.equal(0);
+			for(const pair of rcvlist){
+				expect(pair.length).to.equal(2);
+				rcvstrs.push(pair[1].toString());
+			}
+		}
+		expect(rcvstrs).to.deep.equal(['Reply(batch 1)', 'Reply(batch 2)', 'Reply(batch 3)']);
+
+		done();
+	});
+
+	//
+	// ChmpxNode::send(), receiveBatch() - inline Callback
+	//
+	it('Slave test - ChmpxNode::send(), receiveBatch() - inline Callback', function(done){
+		expect(msgid1).to.not.be.null;
+
+		// send
+		expect(chmpxslaveobj.send(msgid1, Buffer.from('batch callback'))).to.not.equal(-1);
+
+		// receive
+		expect(chmpxslaveobj.receiveBatch(msgid1, 10, 1000, function(error: any, rcvlist: [Buffer, Buffer][])
+		{
+			expect(error).to.be.null;
+			expect(rcvlist).to.be.an('array');
+			expect(rcvlist.length).to.equal(1);
+			expect(rcvlist[0][1].toString()).to.equal('Reply(batch callback)');
+
+			done();
+		})).to.be.a('boolean').to.be.true;
+	});
+
+	//
+	// ChmpxNode::setReceiveOptions(), send(), receive() - zero copy
+	//
+	it('Slave test - ChmpxNode::setReceiveOptions(), send(), receive() - zero copy', function(done){
+		expect(msgid1).to.not.be.null;
+
+		// option
+		expect(chmpxslaveobj.setReceiveOptions({ zeroCopy: true })).to.be.a('boolean').to.be.true;
+
+		// send
+		expect(chmpxslaveobj.send(msgid1, Buffer.from('zero copy'))).to.not.equal(-1);
+
+		// receive
+		const buffarr: Buffer[] = [];
+		expect(chmpxslaveobj.receive(msgid1, buffarr, 1000)).to.be.a('boolean').to.be.true;
+		expect(buffarr.length).to.equal(2);
+		expect(buffarr[1].toString()).to.equal('Reply(zero copy)');
+
+		// reset option
+		expect(chmpxslaveobj.setReceiveOptions({ zeroCopy: false })).to.be.a('boolean').to.be.true;
+
+		done();
+	});
+
+	//
+	// ChmpxNode::setReceiveOptions(), send(), receive() - string, TypedArray, ArrayBuffer and utf8
+	//
+	it('Slave test - ChmpxNode::setReceiveOptions(), send(), receive() - string, TypedArray, ArrayBuffer and utf8', async function(){
+		expect(msgid1).to.not.be.null;
+
+		// option
+		expect(chmpxslaveobj.setReceiveOptions({ encoding: 'utf8' })).to.be.a('boolean').to.be.true;
+
+		// send string, views and ArrayBuffer without Buffer
+		const bytes = new TextEncoder().encode('array buffer');
+		expect(chmpxslaveobj.send(msgid1, 'string \u3042')).to.be.a('number').to.not.equal(-1);
+		expect(chmpxslaveobj.send(msgid1, new DataView(bytes.buffer, 6, 6))).to.be.a('number').to.not.equal(-1);
+		expect(await chmpxslaveobj.sendAsync(msgid1, bytes.buffer)).to.be.a('number').to.not.equal(-1);
+		expect(chmpxslaveobj.send(msgid1, ['{"key":', bytes.subarray(0, 5), '}'])).to.be.a('number').to.not.equal(-1);
+
+		// receive as string
+		const rcvstrs: any[] = [];
+		for(let cnt = 0; cnt < 4; ++cnt){
+			const [, data] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+			rcvstrs.push(data);
+		}
+		expect(rcvstrs).to.deep.equal(['Reply(string \u3042)', 'Reply(buffer)', 'Reply(array buffer)', 'Reply({"key":array})']);
+
+		// reset option
+		expect(chmpxslaveobj.setReceiveOptions({ encoding: 'buffer' })).to.be.a('boolean').to.be.true;
+		expect(function(){ chmpxslaveobj.setReceiveOptions({ encoding: 'latin1' as any }); }).to.throw(TypeError);
+		expect(function(){ chmpxslaveobj.send(msgid1, 12345 as any); }).to.throw(TypeError);
+	});
+
+	//
+	// ChmpxNode::sendByKey(), sendWithHash(), receive() - No Callback
+	//
+	it('Slave test - ChmpxNode::sendByKey(), sendWithHash(), receive() - No Callback', function(done){
+		expect(msgid1).to.not.be.null;
+
+		// send by key
+		expect(chmpxslaveobj.sendByKey(msgid1, 'routing key', Buffer.from('send by key.'))).to.not.equal(-1);
+
+		let buffarr: Buffer[] = [];
+		expect(chmpxslaveobj.receive(msgid1, buffarr, 1000)).to.be.a('boolean').to.be.true;
+		expect(buffarr[1].toString()).to.equal('Reply(send by key.)');
+
+		// send with hash
+		expect(chmpxslaveobj.sendWithHash(msgid1, 12345, Buffer.from('send with hash.'))).to.not.equal(-1);
+
+		buffarr = [];
+		expect(chmpxslaveobj.receive(msgid1, buffarr, 1000)).to.be.a('boolean').to.be.true;
+		expect(buffarr[1].toString()).to.equal('Reply(send with hash.)');
+
+		// string and array bodies are accepted as same as send
+		expect(chmpxslaveobj.sendByKey(msgid1, 'routing key', 'send by key string.')).to.not.equal(-1);
+
+		buffarr = [];
+		expect(chmpxslaveobj.receive(msgid1, buffarr, 1000)).to.be.a('boolean').to.be.true;
+		expect(buffarr[1].toString()).to.equal('Reply(send by key string.)');
+
+		expect(chmpxslaveobj.sendWithHash(msgid1, 12345, ['send with ', Buffer.from('hash pieces.')])).to.not.equal(-1);
+
+		buffarr = [];
+		expect(chmpxslaveobj.receive(msgid1, buffarr, 1000)).to.be.a('boolean').to.be.true;
+		expect(buffarr[1].toString()).to.equal('Reply(send with hash pieces.)');
+
+		// wrong hash
+		expect(function(){ chmpxslaveobj.sendWithHash(msgid1, -1, Buffer.from('wrong hash.')); }).to.throw(RangeError);
+
+		done();
+	});
+
+	//
+	// ChmpxNode::sendBatch(), receiveBatch() - No Callback
+	//
+	it('Slave test - ChmpxNode::sendBatch(), receiveBatch() - No Callback', function(done){
+		expect(msgid1).to.not.be.null;
+
+		// send
+		const counts: Int32Array = chmpxslaveobj.sendBatch(msgid1, [Buffer.from('send batch 1'), 'send batch 2', ['send ', Buffer.from('batch 3')]]);
+		expect(counts).to.be.an.instanceof(Int32Array);
+		expect(counts.length).to.equal(3);
+		expect(counts[0]).to.not.equal(-1);
+		expect(counts[1]).to.not.equal(-1);
+		expect(counts[2]).to.not.equal(-1);
+
+		// receive
+		const rcvstrs: string[] = [];
+		while(rcvstrs.length < 3){
+			const rcvlist: [Buffer, Buffer][] = chmpxslaveobj.receiveBatch(msgid1, 10, 1000);
+			expect(rcvlist).to.be.an('array');
+			expect(rcvlist.length).to.not.equal(0);
+			for(const pair of rcvlist){
+				rcvstrs.push(pair[1].toString());
+			}
+		}
+		expect(rcvstrs).to.deep.equal(['Reply(send batch 1)', 'Reply(send batch 2)', 'Reply(send batch 3)']);
+
+		done();
+	});
+
+	//
+	// ChmpxNode::sendBatch(), receive() - inline Callback
+	//
+	it('Slave test - ChmpxNode::sendBatch(), receive() - inline Callback', function(done){
+		expect(msgid1).to.not.be.null;
+
+		// send
+		expect(chmpxslaveobj.sendBatch(msgid1, [Buffer.from('send batch callback')], function(error: any, counts: Int32Array)
+		{
+			expect(error).to.be.null;
+			expect(counts).to.be.an.instanceof(Int32Array);
+			expect(counts.length).to.equal(1);
+
+			// receive
+			const buffarr: Buffer[] = [];
+			expect(chmpxslaveobj.receive(msgid1, buffarr, 1000)).to.be.a('boolean').to.be.true;
+			expect(buffarr[1].toString()).to.equal('Reply(send batch callback)');
+
+			done();
+		})).to.be.a('boolean').to.be.true;
+	});
+
+	//
+	// ChmpxNode.configurePool() - static
+	//
+	it('Slave test - ChmpxNode.configurePool() - static', function(done){
+		expect(chmpxnode.ChmpxNode.configurePool({ size: 2, threadName: 'chmpx-test', maxPerNode: 0 })).to.be.a('boolean').to.be.true;
+		expect(function(){ chmpxnode.ChmpxNode.configurePool({ size: 0 }); }).to.throw(TypeError);
+
+		done();
+	});
+
+	//
+	// ChmpxNode::sendFast(), receiveFast() - fast path
+	//
+	it('Slave test - ChmpxNode::sendFast(), receiveFast() - fast path', function(done){
+		expect(msgid1).to.not.be.null;
+
+		expect(chmpxslaveobj.sendFast(msgid1, Buffer.from('send fast'))).to.be.a('number').to.not.equal(-1);
+		const rcvresult: [Buffer, Buffer] = chmpxslaveobj.receiveFast(msgid1, 1000);
+		expect(rcvresult).to.be.an('array');
+		expect(rcvresult[1].toString()).to.equal('Reply(send fast)');
+
+		// string and array bodies are accepted as same as send
+		expect(chmpxslaveobj.sendFast(msgid1, ['send ', Buffer.from('fast pieces')])).to.be.a('number').to.not.equal(-1);
+		const rcvpieces: [Buffer, Buffer] = chmpxslaveobj.receiveFast(msgid1, 1000);
+		expect(rcvpieces).to.be.an('array');
+		expect(rcvpieces[1].toString()).to.equal('Reply(send fast pieces)');
+
+		// fixed signature
+		expect(function(){ chmpxslaveobj.sendFast(msgid1, Buffer.from('send fast'), true); }).to.throw(TypeError);
+		expect(function(){ chmpxslaveobj.receiveFast(msgid1); }).to.throw(TypeError);
+
+		done();
+	});
+
+	//
+	// ChmpxNode::sendAsync(), receive() - ordered on same msgid
+	//
+	it('Slave test - ChmpxNode::sendAsync(), receive() - ordered on same msgid', async function(){
+		expect(msgid1).to.not.be.null;
+
+		// send(the pool has 2 threads and no limit per node, but the sends on same msgid run in order)
+		const counts: number[] = await Promise.all([
+			chmpxslaveobj.sendAsync(msgid1, Buffer.from('ordered 1')),
+			chmpxslaveobj.sendAsync(msgid1, Buffer.from('ordered 2')),
+			chmpxslaveobj.sendAsync(msgid1, Buffer.from('ordered 3'))
+		]);
+		for(const count of counts){
+			expect(count).to.be.a('number').to.not.equal(-1);
+		}
+
+		// receive
+		const rcvstrs: string[] = [];
+		while(rcvstrs.length < 3){
+			const buffarr: Buffer[] = [];
+			expect(chmpxslaveobj.receive(msgid1, buffarr, 1000)).to.be.a('boolean').to.be.true;
+			rcvstrs.push(buffarr[1].toString());
+		}
+		expect(rcvstrs).to.deep.equal(['Reply(ordered 1)', 'Reply(ordered 2)', 'Reply(ordered 3)']);
+	});
+
+	//
+	// ChmpxNode.configurePool(coalesce), sendAsync(), send() - coalesced completion
+	//
+	it('Slave test - ChmpxNode.configurePool(coalesce), sendAsync(), send() - coalesced completion', async function(){
+		expect(msgid1).to.not.be.null;
+		expect(chmpxnode.ChmpxNode.configurePool({ coalesce: true })).to.be.a('boolean').to.be.true;
+		expect(function(){ chmpxnode.ChmpxNode.configurePool({ coalesce: 1 }); }).to.throw(TypeError);
+
+		try{
+			// Promise and callback are completed in the same way
+			const sending: Promise<number>[] = [];
+			for(let cnt = 1; cnt <= 4; ++cnt){
+				sending.push(chmpxslaveobj.sendAsync(msgid1, Buffer.from('coalesce ' + cnt)));
+			}
+			sending.push(new Promise<number>((resolve, reject) => {
+				chmpxslaveobj.send(msgid1, Buffer.from('coalesce 5'), function(error: any, receivecount: number){
+					if(null !== error){
+						reject(error);
+					}else{
+						resolve(receivecount);
+					}
+				});
+			}));
+			for(const count of await Promise.all(sending)){
+				expect(count).to.be.a('number').to.not.equal(-1);
+			}
+
+			// receive
+			const rcvstrs: string[] = [];
+			while(rcvstrs.length < 5){
+				const buffarr: Buffer[] = [];
+				expect(chmpxslaveobj.receive(msgid1, buffarr, 1000)).to.be.a('boolean').to.be.true;
+				rcvstrs.push(buffarr[1].toString());
+			}
+			expect(rcvstrs).to.deep.equal(['Reply(coalesce 1)', 'Reply(coalesce 2)', 'Reply(coalesce 3)', 'Reply(coalesce 4)', 'Reply(coalesce 5)']);
+		}finally{
+			chmpxnode.ChmpxNode.configurePool({ coalesce: false });
+		}
+	});
+
+	//
+	// ChmpxNode.configurePool(coalesce), send(), sendAsync() - callback throws in coalesced batch
+	//
+	it('Slave test - ChmpxNode.configurePool(coalesce), send(), sendAsync() - callback throws in coalesced batch', async function(){
+		expect(msgid1).to.not.be.null;
+		expect(chmpxnode.ChmpxNode.configurePool({ coalesce: true })).to.be.a('boolean').to.be.true;
+
+		// [NOTE]
+		// The exception thrown by the callback is reported as the uncaught
+		// exception, so the listeners of mocha are replaced while testing.
+		//
+		const listeners	= process.listeners('uncaughtException');
+		const uncaughts: any[] = [];
+		process.removeAllListeners('uncaughtException');
+		process.on('uncaughtException', (error: any) => { uncaughts.push(error); });
+
+		try{
+			const sending: Promise<number>[] = [];
+			expect(chmpxslaveobj.send(msgid1, Buffer.from('coalesce throw 1'), function(){
+				throw new Error('callback error');
+			})).to.be.a('boolean');
+			for(let cnt = 2; cnt <= 4; ++cnt){
+				sending.push(chmpxslaveobj.sendAsync(msgid1, Buffer.from('coalesce throw ' + cnt)));
+			}
+
+			// the following Promises are settled
+			for(const count of await Promise.all(sending)){
+				expect(count).to.be.a('number').to.not.equal(-1);
+			}
+			expect(uncaughts.length).to.equal(1);
+			expect(uncaughts[0].message).to.equal('callback error');
+
+			// receive
+			for(let cnt = 1; cnt <= 4; ++cnt){
+				const [, data] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+				expect(data.toString()).to.equal('Reply(coalesce throw ' + cnt + ')');
+			}
+		}finally{
+			process.removeAllListeners('uncaughtException');
+			for(const listener of listeners){
+				process.on('uncaughtException', listener);
+			}
+			chmpxnode.ChmpxNode.configurePool({ coalesce: false });
+		}
+	});
+
+	//
+	// ChmpxNode::setFlowOptions(), send(), onDrain() - backpressure
+	//
+	it('Slave test - ChmpxNode::setFlowOptions(), send(), onDrain() - backpressure', function(done){
+		expect(msgid1).to.not.be.null;
+		expect(chmpxslaveobj.setFlowOptions({ maxInFlight: 2 })).to.be.a('boolean').to.be.true;
+		expect(function(){ chmpxslaveobj.setFlowOptions({ maxInFlight: -1 }); }).to.throw(TypeError);
+
+		let	sentcnt = 0;
+		const sendCb = function(error: any, receivecount: number){
+			expect(error).to.be.null;
+			expect(receivecount).to.be.a('number').to.not.equal(-1);
+			++sentcnt;
+		};
+
+		expect(chmpxslaveobj.onDrain(function(error: any){
+			expect(error).to.be.null;
+			expect(sentcnt).to.be.at.least(1);
+			expect(chmpxslaveobj.offDrain()).to.be.a('boolean').to.be.true;
+			expect(chmpxslaveobj.setFlowOptions({ maxInFlight: 0 })).to.be.a('boolean').to.be.true;
+
+			// receive
+			for(let cnt = 0; cnt < 2; ++cnt){
+				const buffarr: Buffer[] = [];
+				expect(chmpxslaveobj.receive(msgid1, buffarr, 1000)).to.be.a('boolean').to.be.true;
+				expect(buffarr[1].toString()).to.match(/^Reply\(flow [12]\)$/);
+			}
+			done();
+		})).to.be.a('boolean').to.be.true;
+
+		// second send reaches the limit
+		expect(chmpxslaveobj.send(msgid1, Buffer.from('flow 1'), sendCb)).to.be.a('boolean').to.be.true;
+		expect(chmpxslaveobj.send(msgid1, Buffer.from('flow 2'), sendCb)).to.be.a('boolean').to.be.false;
+	});
+
+	//
+	// ChmpxNode::sendAsync(), receiveAsync() - Promise
+	//
+	it('Slave test - ChmpxNode::sendAsync(), receiveAsync() - Promise', async function(){
+		expect(msgid1).to.not.be.null;
+
+		// send
+		const receivecount: number = await chmpxslaveobj.sendAsync(msgid1, Buffer.from('send receive async.'));
+		expect(receivecount).to.be.a('number').to.not.equal(-1);
+
+		// receive
+		const [compkt, data] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+		expect(compkt).to.not.be.null;
+		expect(data.toString()).to.equal('Reply(send receive async.)');
+	});
+
+	//
+	// ChmpxNode::messages() - async iterator
+	//
+	it('Slave test - ChmpxNode::send(), messages() - async iterator', async function(){
+		expect(msgid1).to.not.be.null;
+
+		for(let cnt = 1; cnt <= 3; ++cnt){
+			expect(chmpxslaveobj.send(msgid1, Buffer.from('iterator ' + cnt))).to.be.a('number').to.not.equal(-1);
+		}
+
+		// receiving is paused at highWaterMark until the data are taken
+		const rcvstrs: string[] = [];
+		for await (const [compkt, body] of chmpxslaveobj.messages(msgid1, { timeout: 1000, highWaterMark: 1 })){
+			expect(compkt).to.not.be.null;
+			rcvstrs.push(body.toString());
+			if(3 <= rcvstrs.length){
+				break;
+			}
+		}
+		expect(rcvstrs).to.deep.equal(['Reply(iterator 1)', 'Reply(iterator 2)', 'Reply(iterator 3)']);
+
+		// batch, and the iteration ends by timeout
+		for(let cnt = 1; cnt <= 2; ++cnt){
+			expect(chmpxslaveobj.send(msgid1, Buffer.from('batch iterator ' + cnt))).to.be.a('number').to.not.equal(-1);
+		}
+		const batchstrs: string[] = [];
+		for await (const rcvlist of chmpxslaveobj.messages(msgid1, { timeout: 500, batch: 8 })){
+			expect(rcvlist).to.be.an('array').to.have.length.within(1, 8);
+			for(const [, body] of rcvlist){
+				batchstrs.push(body.toString());
+			}
+		}
+		expect(batchstrs).to.deep.equal(['Reply(batch iterator 1)', 'Reply(batch iterator 2)']);
+
+		expect(function(){ chmpxslaveobj.messages(msgid1, { highWaterMark: 0 }); }).to.throw(TypeError);
+	});
+
+	//
+	// ChmpxNode::createReadStream() - Readable
+	//
+	it('Slave test - ChmpxNode::send(), createReadStream() - Readable', async function(){
+		expect(msgid1).to.not.be.null;
+
+		for(let cnt = 1; cnt <= 2; ++cnt){
+			expect(chmpxslaveobj.send(msgid1, Buffer.from('stream ' + cnt))).to.be.a('number').to.not.equal(-1);
+		}
+
+		const rcvstrs: string[] = [];
+		const stream = chmpxslaveobj.createReadStream(msgid1, { timeout: 500, highWaterMark: 1 });
+		expect(stream.readableObjectMode).to.be.true;
+		for await (const [, body] of stream){
+			rcvstrs.push(body.toString());
+		}
+		expect(rcvstrs).to.deep.equal(['Reply(stream 1)', 'Reply(stream 2)']);
+	});
+
+	//
+	// ChmpxNode::send(), sendAsync() - array of pieces
+	//
+	it('Slave test - ChmpxNode::send(), sendAsync() - array of pieces', async function(){
+		expect(msgid1).to.not.be.null;
+
+		// No Callback
+		expect(chmpxslaveobj.send(msgid1, [Buffer.from('gather '), new Uint8Array(0), Buffer.from('send')])).to.be.a('number').to.not.equal(-1);
+		const [, data1] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+		expect(data1.toString()).to.equal('Reply(gather send)');
+
+		// Promise(pieces are not referenced after calling)
+		const pieces = [Buffer.from('gather '), Buffer.from('async')];
+		const result = chmpxslaveobj.sendAsync(msgid1, pieces);
+		pieces[1].fill(0);
+		expect(await result).to.be.a('number').to.not.equal(-1);
+		const [, data2] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+		expect(data2.toString()).to.equal('Reply(gather async)');
+
+		// the getter of a piece sends again while gathering
+		const reentered: any[] = [Buffer.from('gather '), null];
+		Object.defineProperty(reentered, 1, { get: () => {
+			expect(chmpxslaveobj.send(msgid1, ['gather ', 'inner'])).to.be.a('number').to.not.equal(-1);
+			return Buffer.from('outer');
+		}});
+		expect(chmpxslaveobj.send(msgid1, reentered)).to.be.a('number').to.not.equal(-1);
+		const [, data3] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+		const [, data4] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+		expect(data3.toString()).to.equal('Reply(gather inner)');
+		expect(data4.toString()).to.equal('Reply(gather outer)');
+
+		expect(function(){ chmpxslaveobj.send(msgid1, [Buffer.from('gather '), 12345 as any]); }).to.throw(TypeError);
+	});
+
+	//
+	// ChmpxNode::openSendRing(), ChmpxSendRing::push(), close()
+	//
+	it('Slave test - ChmpxNode::openSendRing(), ChmpxSendRing::push(), close()', async function(){
+		expect(msgid1).to.not.be.null;
+
+		const ring = chmpxslaveobj.openSendRing(msgid1, { size: 4096 });
+		expect(ring.buffer).to.be.an.instanceof(SharedArrayBuffer);
+		expect(ring.closed).to.be.false;
+
+		for(let cnt = 1; cnt <= 3; ++cnt){
+			expect(ring.push(Buffer.from('ring ' + cnt))).to.be.true;
+		}
+
+		// wait for sending by the sender thread
+		for(let cnt = 0; cnt < 100 && ring.sent < 3; ++cnt){
+			await new Promise((resolve) => setTimeout(resolve, 10));
+		}
+		expect(ring.sent).to.equal(3);
+		expect(ring.errors).to.equal(0);
+
+		const rcvstrs: string[] = [];
+		for(let cnt = 1; cnt <= 3; ++cnt){
+			const [, data] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+			rcvstrs.push(data.toString());
+		}
+		expect(rcvstrs).to.deep.equal(['Reply(ring 1)', 'Reply(ring 2)', 'Reply(ring 3)']);
+
+		expect(function(){ ring.push(Buffer.alloc(4096)); }).to.throw(RangeError);
+		expect(ring.close()).to.be.true;
+		expect(ring.closed).to.be.true;
+		expect(ring.push(Buffer.from('after close'))).to.be.false;
+		expect(function(){ chmpxslaveobj.openSendRing(msgid1, { size: 0 }); }).to.throw(TypeError);
+	});
+
+	//
+	// ChmpxSendRing::push() - record larger than the rest of data area
+	//
+	it('Slave test - ChmpxSendRing::push() - record larger than the rest of data area', async function(){
+		expect(msgid1).to.not.be.null;
+
+		const ring		= chmpxslaveobj.openSendRing(msgid1, { size: 4096 });
+		const waitSent	= async (count: number) => {
+			for(let cnt = 0; cnt < 100 && ring.sent < count; ++cnt){
+				await new Promise((resolve) => setTimeout(resolve, 10));
+			}
+			expect(ring.sent).to.equal(count);
+		};
+
+		// partial fill, then a record which is larger than capacity/2 wraps
+		expect(ring.push(Buffer.alloc(2000, 'a'))).to.be.true;
+		await waitSent(1);
+
+		let	pushed = false;
+		for(let cnt = 0; cnt < 100 && !pushed; ++cnt){
+			pushed = ring.push(Buffer.alloc(3000, 'b'));
+			if(!pushed){
+				await new Promise((resolve) => setTimeout(resolve, 10));
+			}
+		}
+		expect(pushed).to.be.true;
+		await waitSent(2);
+
+		const [, data1] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+		const [, data2] = await chmpxslaveobj.receiveAsync(msgid1, 1000);
+		expect(data1.toString()).to.equal('Reply(' + 'a'.repeat(2000) + ')');
+		expect(data2.toString()).to.equal('Reply(' + 'b'.repeat(3000) + ')');
+
+		expect(ring.close()).to.be.true;
+	});
+
+	//
+	// ChmpxSendRing - broken record length written by JS
+	//
+	it('Slave test - ChmpxSendRing - broken record length closes the ring', async function(){
+		expect(msgid1).to.not.be.null;
+
+		const ring		= chmpxslaveobj.openSendRing(msgid1, { size: 4096 });
+		const header	= new Int32Array(ring.buffer, 0, 16);
+		const record	= new Uint32Array(ring.buffer, 64, 4);
+
+		// length which wraps around when aligned
+		record[0] = 0xFFFFFFF9;
+		record[1] = 0;
+		Atomics.store(header, 1, 16);					// TAIL
+		ring.notify();
+
+		for(let cnt = 0; cnt < 100 && !ring.closed; ++cnt){
+			await new Promise((resolve) => setTimeout(resolve, 10));
+		}
+		expect(ring.closed).to.be.true;
+		expect(ring.sent).to.equal(0);
+		expect(ring.errors).to.equal(0);
+		expect(ring.push(Buffer.from('after broken'))).to.be.false;
+	});
+
+	//
+	// ChmpxNode::receiveAsync() - AbortSignal
+	//
+	it('Slave test - ChmpxNode::receiveAsync() - AbortSignal', async function(){
+		expect(msgid1).to.not.be.null;
+
+		// abort while waiting(long timeout)
+		const controller	= new AbortController();
+		const start			= Date.now();
+		setTimeout(() => controller.abort(), 100);
+
+		let	rcverror: any	= null;
+		try{
+			await chmpxslaveobj.receiveAsync(msgid1, 10000, controller.signal);
+		}catch(error: any){
+			rcverror = error;
+		}
+		expect(rcverror).to.not.be.null;
+		expect(rcverror.name).to.equal('AbortError');
+		expect(Date.now() - start).to.be.below(2000);
+
+		// already aborted
+		let	prerror: any	= null;
+		try{
+			await chmpxslaveobj.receiveAsync(msgid1, 10000, controller.signal);
+		}catch(error: any){
+			prerror = error;
+		}
+		expect(prerror).to.not.be.null;
+		expect(prerror.name).to.equal('AbortError');
+
+		// not allowed for synchronous receiving
+		expect(function(){ (chmpxslaveobj as any).receive(msgid1, [], 0, new AbortController().signal); }).to.throw(TypeError);
+	});
+
+	//
+	// ChmpxNode::openAsync(), closeAsync() - Promise
+	//
+	it('Slave test - ChmpxNode::openAsync(), closeAsync() - Promise', async function(){
+		const msgid: Buffer = await chmpxslaveobj.openAsync();
+		expect(msgid).to.not.be.null;
+
+		await chmpxslaveobj.closeAsync(msgid);
+	});
+
+	//
+	// ChmpxNode::openMsgIdAsync(), send(), receive(), close() - msgid handle and BigInt
+	//
+	it('Slave test - ChmpxNode::openMsgIdAsync(), send(), receive(), close() - msgid handle and BigInt', async function(){
+		const msgid: any = await chmpxslaveobj.openMsgIdAsync();
+		expect(msgid).to.not.be.null;
+		expect(msgid.closed).to.be.a('boolean').to.be.false;
+		expect(msgid.toBuffer()).to.be.an.instanceof(Buffer);
+		expect(msgid.toBuffer().length).to.equal(8);
+
+		// send/receive by handle
+		expect(await chmpxslaveobj.sendAsync(msgid, Buffer.from('send by handle'))).to.be.a('number').to.not.equal(-1);
+		const rcvresult: [Buffer, Buffer] = await chmpxslaveobj.receiveAsync(msgid, 1000);
+		expect(rcvresult[1].toString()).to.equal('Reply(send by handle)');
+
+		// send by BigInt and receive by Buffer
+		expect(chmpxslaveobj.send(msgid.toBigInt(), Buffer.from('send by bigint'))).to.be.a('number').to.not.equal(-1);
+		const buffarr: Buffer[] = [];
+		expect(chmpxslaveobj.receive(msgid.toBuffer(), buffarr, 1000)).to.be.a('boolean').to.be.true;
+		expect(buffarr[1].toString()).to.equal('Reply(send by bigint)');
+		expect(msgid.inflight).to.equal(0);
+
+		// close
+		expect(chmpxslaveobj.close(msgid)).to.be.a('boolean').to.be.true;
+		expect(msgid.closed).to.be.a('boolean').to.be.true;
+		expect(function(){ chmpxslaveobj.send(msgid, Buffer.from('after close')); }).to.throw(Error);
+	});
+
+	//
+	// ChmpxNode::request() - Promise(pipelined)
+	//
+	it('Slave test - ChmpxNode::request() - Promise(pipelined)', async function(){
+		const msgid: Buffer = await chmpxslaveobj.openAsync();
+		expect(msgid).to.not.be.null;
+
+		// requests in flight on one msgid
+		const replies: Buffer[] = await Promise.all([
+			chmpxslaveobj.request(msgid, Buffer.from('request 1'), 1000),
+			chmpxslaveobj.request(msgid, Buffer.from('request 2'), 1000),
+			chmpxslaveobj.request(msgid, Buffer.from('request 3'), 1000)
+		]);
+		expect(replies[0].toString()).to.equal('Reply(request 1)');
+		expect(replies[1].toString()).to.equal('Reply(request 2)');
+		expect(replies[2].toString()).to.equal('Reply(request 3)');
+
+		await chmpxslaveobj.closeAsync(msgid);
+	});
+
+	//
+	// ChmpxNode::request() - string and array of pieces
+	//
+	it('Slave test - ChmpxNode::request() - string and array of pieces', async function(){
+		const msgid: Buffer = await chmpxslaveobj.openAsync();
+		expect(msgid).to.not.be.null;
+
+		const replies: Buffer[] = await Promise.all([
+			chmpxslaveobj.request(msgid, 'string request', 1000),
+			chmpxslaveobj.request(msgid, ['pieces ', Buffer.from('request')], 1000)
+		]);
+		expect(replies[0].toString()).to.equal('Reply(string request)');
+		expect(replies[1].toString()).to.equal('Reply(pieces request)');
+
+		await chmpxslaveobj.closeAsync(msgid);
+	});
+
+	//
+	// ChmpxMsgId::getStats(), resetStats(), pending
+	//
+	it('Slave test - ChmpxMsgId::getStats(), resetStats(), pending', async function(){
+		const msgid: any = await chmpxslaveobj.openMsgIdAsync();
+		expect(msgid).to.not.be.null;
+		expect(msgid.pending).to.equal(0);
+		expect(msgid.getStats().send.count).to.equal(0);
+
+		// send by handle and by Buffer are counted on the handle
+		const senddata = Buffer.from('msgid stats');
+		expect(chmpxslaveobj.send(msgid, senddata)).to.be.a('number').to.not.equal(-1);
+		expect(chmpxslaveobj.send(msgid.toBuffer(), senddata)).to.be.a('number').to.not.equal(-1);
+		const buffarr: Buffer[] = [];
+		expect(chmpxslaveobj.receive(msgid, buffarr, 1000)).to.be.a('boolean').to.be.true;
+		expect(chmpxslaveobj.receive(msgid, buffarr, 1000)).to.be.a('boolean').to.be.true;
+
+		// request is pending until the reply
+		const reply: Promise<Buffer> = chmpxslaveobj.request(msgid, Buffer.from('msgid request'), 1000);
+		expect(msgid.pending).to.equal(1);
+		expect((await reply).toString()).to.equal('Reply(msgid request)');
+		expect(msgid.pending).to.equal(0);
+
+		const stats = msgid.getStats();
+		expect(stats.send.count).to.equal(2);
+		expect(stats.send.bytes).to.equal(senddata.length * 2);
+		expect(stats.receive.count).to.equal(2);
+		expect(stats.request.count).to.equal(1);
+
+		// reset only the handle
+		expect(msgid.resetStats()).to.be.a('boolean').to.be.true;
+		expect(msgid.getStats().send.count).to.equal(0);
+
+		await chmpxslaveobj.closeAsync(msgid);
+	});
+
+	//
+	// ChmpxNode::openPoolAsync(), ChmpxMsgPool::request(), send(), close() - Promise and inline Callback
+	//
+	it('Slave test - ChmpxNode::openPoolAsync(), ChmpxMsgPool::request(), send(), close()', async function(){
+		const pool: any = await chmpxslaveobj.openPoolAsync(3);
+		expect(pool).to.not.be.null;
+
+		const msgids: Buffer[] = pool.msgids();
+		expect(msgids).to.be.an('array');
+		expect(msgids.length).to.equal(3);
+
+		// requests are spread over msgids in the pool
+		const replies: Buffer[] = await Promise.all([
+			pool.request(Buffer.from('pool request 1'), 1000),
+			pool.request(Buffer.from('pool request 2'), 1000),
+			pool.request(Buffer.from('pool request 3'), 1000),
+			pool.request(Buffer.from('pool request 4'), 1000)
+		]);
+		expect(replies.map((reply: Buffer) => reply.toString())).to.deep.equal(['Reply(pool request 1)', 'Reply(pool request 2)', 'Reply(pool request 3)', 'Reply(pool request 4)']);
+
+		// send with callback(gathered from pieces)
+		const receivecount: number = await new Promise((resolve, reject) => {
+			expect(pool.send(['pool ', Buffer.from('send')], function(error: any, count: number)
+			{
+				if(error){
+					reject(new Error(error));
+				}else{
+					resolve(count);
+				}
+			})).to.be.a('boolean').to.be.true;
+		});
+		expect(receivecount).to.be.a('number').to.not.equal(-1);
+
+		// close
+		expect(pool.close()).to.be.a('boolean').to.be.true;
+		expect(function(){ pool.send(Buffer.from('after close')); }).to.throw(Error);
+		expect(function(){ chmpxslaveobj.openPool(0); }).to.throw(RangeError);
+	});
+
+	//
+	// ChmpxNode::getStats(), resetStats()
+	//
+	it('Slave test - ChmpxNode::getStats(), resetStats()', function(done){
+		expect(msgid1).to.not.be.null;
+		expect(chmpxslaveobj.resetStats()).to.be.a('boolean').to.be.true;
+
+		// send and receive
+		const senddata = Buffer.from('stats test');
+		expect(chmpxslaveobj.send(msgid1, senddata)).to.be.a('number').to.not.equal(-1);
+
+		const outarr: [Buffer?, Buffer?] = [];
+		expect(chmpxslaveobj.receive(msgid1, outarr, 1000)).to.be.a('boolean').to.be.true;
+
+		const stats = chmpxslaveobj.getStats();
+		expect(stats.send.count).to.equal(1);
+		expect(stats.send.bytes).to.equal(senddata.length);
+		expect(stats.receive.count).to.equal(1);
+		expect(stats.send.latency).to.be.an('array').to.have.lengthOf(32);
+		expect(stats.send.latency.reduce((sum: number, cnt: number) => sum + cnt, 0)).to.equal(1);
+
+		// reset
+		expect(chmpxslaveobj.resetStats()).to.be.a('boolean').to.be.true;
+		expect(chmpxslaveobj.getStats().send.count).to.equal(0);
+
+		done();
+	});
+
+	//
+	// ChmpxNode::destroy(), destroyAsync()
+	//
+	it('Slave test - ChmpxNode::destroy(), destroyAsync() - inline Callback and Promise', function(done){
+		const slaveobj: any = new chmpxnode();
+		expect(slaveobj.initializeOnSlave(testsdir + '/chmpx_slave.ini', true)).to.be.a('boolean').to.be.true;
+
+		const msgid: Buffer = slaveobj.open();
+		expect(msgid).to.not.be.null;
+
+		// destroy with callback(cleanup runs off JS thread)
+		expect(slaveobj.destroy(function(error: any)
+		{
+			expect(error).to.be.null;
+
+			// initialize again after destroying, then destroy by Promise
+			expect(slaveobj.initializeOnSlave(testsdir + '/chmpx_slave.ini', true)).to.be.a('boolean').to.be.true;
+			slaveobj.destroyAsync().then(() => {
+				done();
+			}).catch((err: any) => {
+				done(err);
+			});
+		})).to.be.a('boolean').to.be.true;
+	});
+
+	//
+	// ChmpxNode::drainAsync()
+	//
+	it('Slave test - ChmpxNode::drainAsync() - flush and close msgids', async function(){
+		const slaveobj: any = new chmpxnode();
+		expect(slaveobj.initializeOnSlave(testsdir + '/chmpx_slave.ini', true)).to.be.a('boolean').to.be.true;
+
+		const msgid: Buffer = slaveobj.open();
+		expect(msgid).to.not.be.null;
+
+		// operations in flight are flushed
+		const sending	= slaveobj.sendAsync(msgid, Buffer.from('before drain'));
+		const result	= await slaveobj.drainAsync(5000);
+		expect(await sending).to.be.a('number').to.not.equal(-1);
+		expect(result.flushed).to.be.a('number').to.be.at.least(1);
+		expect(result.abandoned).to.equal(0);
+		expect(result.closed).to.equal(1);
+
+		// new operations are not accepted
+		let	senderror: any = null;
+		try{
+			await slaveobj.sendAsync(msgid, Buffer.from('after drain'));
+		}catch(error: any){
+			senderror = error;
+		}
+		expect(senderror).to.not.be.null;
+		expect(() => slaveobj.send(msgid, Buffer.from('after drain'))).to.throw('draining');
+		expect(() => slaveobj.sendFast(msgid, Buffer.from('after drain'))).to.throw('draining');
+		expect(() => slaveobj.receive(msgid, [], 0)).to.throw('draining');
+
+		await slaveobj.destroyAsync();
+	});
+
 	//
 	// ChmpxNode::send() - error after closing msgid
 	//
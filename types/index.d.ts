@@ -49,8 +49,74 @@ declare namespace chmpx
 	export type ChmpxCloseCallback = (err?: Error | string | null) => void;
 	export type ChmpxSendCallback = (err?: Error | string | null, recievercnt?: number) => void;
 	export type ChmpxBroadcastCallback = (err?: Error | string | null, recievercnt?: number) => void;
+	export type ChmpxSendBatchCallback = (err?: Error | string | null, recievercnts?: Int32Array) => void;
 	export type ChmpxReplyCallback = (err?: Error | string | null) => void;
 	export type ChmpxReceiveCallback = (err?: Error | string | null, compkt?: Buffer, body?: Buffer) => void;
+	export type ChmpxReceiveBatchCallback = (err?: Error | string | null, rcvlist?: [Buffer, Buffer][]) => void;
+	export type ChmpxDestroyCallback = (err?: Error | string | null) => void;
+	export type ChmpxOpenPoolCallback = (err?: Error | string | null, pool?: ChmpxMsgPool) => void;
+	export type ChmpxOpenMsgIdCallback = (err?: Error | string | null, msgid?: ChmpxMsgId) => void;
+	export type ChmpxDrainCallback = (err?: Error | string | null, result?: ChmpxDrainResult) => void;
+
+	//---------------------------------------------------------
+	// Options for ChmpxNode
+	//---------------------------------------------------------
+	export type ChmpxMsgIdParam = Buffer | bigint | ChmpxMsgId;	// msgid Buffer, BigInt or handle
+	export type ChmpxSendPiece = string | ArrayBufferView | ArrayBuffer;		// string is encoded to UTF-8
+	export type ChmpxSendBody = ChmpxSendPiece | ChmpxSendPiece[];			// array of pieces is gathered into one message
+
+	export type ChmpxReceiveOptions = {
+		zeroCopy?:	boolean;		// body Buffer wraps the received memory without copying(default false)
+		encoding?:	'utf8' | 'buffer';	// 'utf8' is the body as string decoded natively, zeroCopy is ignored(default 'buffer')
+		requestHeader?:	boolean;	// only on server, strip the request header of request() and put it by reply()(default false)
+	};
+
+	export type ChmpxMessagesOptions = {
+		timeout?:			number;		// iteration ends when no data arrives within this ms, negative is forever(default -1)
+		batch?:				number;		// each value is an array of up to batch [compkt, body], 0 is one [compkt, body](default 0)
+		highWaterMark?:		number;		// maximum received data queued before receiving is paused(default 16)
+		noGiveupRejoin?:	boolean;	// only on server(default false)
+	};
+
+	export type ChmpxFlowOptions = {
+		maxInFlight?:	number;		// maximum async send operations queued or running, 0 is no limit(default 0)
+	};
+
+	export type ChmpxPoolOptions = {
+		size?:			number;		// number of worker threads(default 4)
+		threadName?:	string;		// prefix of worker thread names(default "chmpx-pool")
+		maxPerNode?:	number;		// maximum running workers per ChmpxNode, 0 is no limit(default 0)
+		coalesce?:		boolean;	// complete finished workers together in one dispatch on JS thread(default false)
+	};
+
+	export type ChmpxSendRingOptions = {
+		size?:		number;		// bytes of record area, rounded up to power of 2 from 4096 to 1GB(default 1MB)
+		routing?:	boolean;	// send with routing mode(default true)
+	};
+
+	export type ChmpxOpStats = {
+		count:		number;			// succeeded operations
+		errors:		number;			// failed operations
+		timeouts:	number;			// timeouted operations(receive and request)
+		bytes:		number;			// total body bytes
+		latency:	number[];		// log2 histogram, element N counts latency less than 2^(N+1) us
+	};
+
+	export type ChmpxDrainResult = {
+		flushed:	number;			// async operations completed while draining
+		abandoned:	number;			// async operations not completed at timeout, and rejected requests
+		closed:		number;			// closed msgids
+	};
+
+	export type ChmpxStats = {
+		send:		ChmpxOpStats;
+		broadcast:	ChmpxOpStats;
+		receive:	ChmpxOpStats;
+		reply:		ChmpxOpStats;
+		open:		ChmpxOpStats;
+		close:		ChmpxOpStats;
+		request:	ChmpxOpStats;
+	};
 
 	//---------------------------------------------------------
 	// Emitter callback types for ChmpxNode
@@ -64,6 +130,7 @@ declare namespace chmpx
 	export type OnChmpxBroadcastEmitterCallback = (err?: string | null, recievercnt?: number) => void;
 	export type OnChmpxReplyEmitterCallback = (err?: string | null) => void;
 	export type OnChmpxReceiveEmitterCallback = (err?: string | null, compkt?: Buffer, body?: Buffer) => void;
+	export type OnChmpxDrainEmitterCallback = (err?: string | null) => void;
 
 	//---------------------------------------------------------
 	// ChmpxNode Class
@@ -73,6 +140,9 @@ declare namespace chmpx
 		// Constructor
 		constructor();	// always no arguments
 
+		// Configure worker thread pool for all ChmpxNode(operations on same msgid run in order)
+		static configurePool(options: ChmpxPoolOptions): boolean;
+
 		//-----------------------------------------------------
 		// Methods (Callback can be called)
 		//-----------------------------------------------------
@@ -84,24 +154,46 @@ declare namespace chmpx
 		initializeOnSlave(filename: string, cb?: ChmpxInitializeOnSlaveCallback): boolean;
 		initializeOnSlave(filename: string, is_auto_rejoin: boolean, cb?: ChmpxInitializeOnSlaveCallback): boolean;
 
-		// send
-		send(msgid: Buffer, body: Buffer, cb: ChmpxSendCallback): boolean;
-		send(msgid: Buffer, body: Buffer, is_routing: boolean, cb: ChmpxSendCallback): boolean;
+		// send(with callback, returns false when maxInFlight is reached and waits for "drain")
+		send(msgid: ChmpxMsgIdParam, body: ChmpxSendBody, cb: ChmpxSendCallback): boolean;
+		send(msgid: ChmpxMsgIdParam, body: ChmpxSendBody, is_routing: boolean, cb: ChmpxSendCallback): boolean;
 
 		// broadcast
-		broadcast(msgid: Buffer, body: Buffer, cb: ChmpxBroadcastCallback): boolean;
+		broadcast(msgid: ChmpxMsgIdParam, body: ChmpxSendBody, cb: ChmpxBroadcastCallback): boolean;
+
+		// send by key/hash
+		sendByKey(msgid: ChmpxMsgIdParam, key: Buffer | string, body: ChmpxSendBody, cb: ChmpxSendCallback): boolean;
+		sendByKey(msgid: ChmpxMsgIdParam, key: Buffer | string, body: ChmpxSendBody, is_routing: boolean, cb: ChmpxSendCallback): boolean;
+		sendWithHash(msgid: ChmpxMsgIdParam, hash: number | bigint, body: ChmpxSendBody, cb: ChmpxSendCallback): boolean;
+		sendWithHash(msgid: ChmpxMsgIdParam, hash: number | bigint, body: ChmpxSendBody, is_routing: boolean, cb: ChmpxSendCallback): boolean;
+
+		// send/broadcast batch
+		sendBatch(msgid: ChmpxMsgIdParam, bodies: ChmpxSendBody[], cb: ChmpxSendBatchCallback): boolean;
+		sendBatch(msgid: ChmpxMsgIdParam, bodies: ChmpxSendBody[], is_routing: boolean, cb: ChmpxSendBatchCallback): boolean;
+		broadcastBatch(msgid: ChmpxMsgIdParam, bodies: ChmpxSendBody[], cb: ChmpxSendBatchCallback): boolean;
 
 		// reply
-		reply(compkt: Buffer, body: Buffer, cb?: ChmpxReplyCallback): boolean;
+		reply(compkt: Buffer, body: ChmpxSendBody, cb?: ChmpxReplyCallback): boolean;
 
 		// receive on server
 		receive(cb?: ChmpxReceiveCallback): boolean;
 		receive(timeout_ms: number, cb?: ChmpxReceiveCallback): boolean;
 		receive(timeout_ms: number, no_giveup_rejoin: boolean, cb?: ChmpxReceiveCallback): boolean;
+		receive(timeout_ms: number, no_giveup_rejoin: boolean, cb: ChmpxReceiveCallback, signal: AbortSignal): boolean;
 
 		// receive on slave
-		receive(msgid: Buffer, cb?: ChmpxReceiveCallback): boolean;
-		receive(msgid: Buffer, timeout_ms: number, cb?: ChmpxReceiveCallback): boolean;
+		receive(msgid: ChmpxMsgIdParam, cb?: ChmpxReceiveCallback): boolean;
+		receive(msgid: ChmpxMsgIdParam, timeout_ms: number, cb?: ChmpxReceiveCallback): boolean;
+		receive(msgid: ChmpxMsgIdParam, timeout_ms: number, cb: ChmpxReceiveCallback, signal: AbortSignal): boolean;
+
+		// receive batch on server
+		receiveBatch(maxcount: number, cb: ChmpxReceiveBatchCallback): boolean;
+		receiveBatch(maxcount: number, timeout_ms: number, cb: ChmpxReceiveBatchCallback): boolean;
+		receiveBatch(maxcount: number, timeout_ms: number, no_giveup_rejoin: boolean, cb: ChmpxReceiveBatchCallback, signal?: AbortSignal): boolean;
+
+		// receive batch on slave
+		receiveBatch(msgid: ChmpxMsgIdParam, maxcount: number, cb: ChmpxReceiveBatchCallback): boolean;
+		receiveBatch(msgid: ChmpxMsgIdParam, maxcount: number, timeout_ms: number, cb: ChmpxReceiveBatchCallback, signal?: AbortSignal): boolean;
 
 		// open
 		open(): Buffer;
@@ -110,35 +202,105 @@ declare namespace chmpx
 		open(cb: ChmpxOpenCallback): boolean;
 		open(no_giveup_rejoin: boolean, cb: ChmpxOpenCallback): boolean;
 
-		// close
-		close(msgid: Buffer, cb?: ChmpxCloseCallback): boolean;
+		// close(with callback, returns false when maxInFlight is reached and waits for "drain")
+		close(msgid: ChmpxMsgIdParam, cb?: ChmpxCloseCallback): boolean;
+
+		// open msgid handle
+		openMsgId(no_giveup_rejoin?: boolean): ChmpxMsgId | null;
+		openMsgId(cb: ChmpxOpenMsgIdCallback): boolean;
+		openMsgId(no_giveup_rejoin: boolean, cb: ChmpxOpenMsgIdCallback): boolean;
+
+		// open msgid pool(count is 1 to 256)
+		openPool(count: number): ChmpxMsgPool | null;
+		openPool(count: number, no_giveup_rejoin: boolean): ChmpxMsgPool | null;
+
+		openPool(count: number, cb: ChmpxOpenPoolCallback): boolean;
+		openPool(count: number, no_giveup_rejoin: boolean, cb: ChmpxOpenPoolCallback): boolean;
+
+		// open send ring drained by a native sender thread on msgid
+		openSendRing(msgid: ChmpxMsgIdParam, options?: ChmpxSendRingOptions): ChmpxSendRing;
+
+		// receiving loop on server
+		startReceiving(cb?: ChmpxReceiveCallback): boolean;
+		startReceiving(timeout_ms: number, cb?: ChmpxReceiveCallback): boolean;
+		startReceiving(timeout_ms: number, no_giveup_rejoin: boolean, cb?: ChmpxReceiveCallback): boolean;
+
+		// receiving loop on slave
+		startReceiving(msgid: ChmpxMsgIdParam, cb?: ChmpxReceiveCallback): boolean;
+		startReceiving(msgid: ChmpxMsgIdParam, timeout_ms: number, cb?: ChmpxReceiveCallback): boolean;
+
+		// stop receiving loop
+		stopReceiving(): boolean;
+
+		// async iterator and object mode Readable of received data on server
+		messages(options?: ChmpxMessagesOptions): ChmpxMsgIterator;
+		createReadStream(options?: ChmpxMessagesOptions): import('stream').Readable;
+
+		// async iterator and object mode Readable of received data on slave
+		messages(msgid: ChmpxMsgIdParam, options?: ChmpxMessagesOptions): ChmpxMsgIterator;
+		createReadStream(msgid: ChmpxMsgIdParam, options?: ChmpxMessagesOptions): import('stream').Readable;
 
 		//-----------------------------------------------------
 		// Methods (no callback)
 		//-----------------------------------------------------
 		// send
-		send(msgid: Buffer, body: Buffer): number;
-		send(msgid: Buffer, body: Buffer, is_routing: boolean): number;
+		send(msgid: ChmpxMsgIdParam, body: ChmpxSendBody): number;
+		send(msgid: ChmpxMsgIdParam, body: ChmpxSendBody, is_routing: boolean): number;
 
 		// broadcast
-		broadcast(msgid: Buffer, body: Buffer): number;
+		broadcast(msgid: ChmpxMsgIdParam, body: ChmpxSendBody): number;
+
+		// send by key/hash
+		sendByKey(msgid: ChmpxMsgIdParam, key: Buffer | string, body: ChmpxSendBody, is_routing?: boolean): number;
+		sendWithHash(msgid: ChmpxMsgIdParam, hash: number | bigint, body: ChmpxSendBody, is_routing?: boolean): number;
+
+		// send/broadcast batch
+		sendBatch(msgid: ChmpxMsgIdParam, bodies: ChmpxSendBody[], is_routing?: boolean): Int32Array;
+		broadcastBatch(msgid: ChmpxMsgIdParam, bodies: ChmpxSendBody[]): Int32Array;
 
 		// reply
-		reply(compkt: Buffer, body: Buffer): number;
+		reply(compkt: Buffer, body: ChmpxSendBody): number;
 
 		// receive on server
 		receive(rcvarr: [Buffer?, Buffer?]): boolean;
 		receive(rcvarr: [Buffer?, Buffer?], timeout_ms: number, no_giveup_rejoin?: boolean): boolean;
 
 		// receive on slave
-		receive(msgid: Buffer, rcvarr: [Buffer?, Buffer?], timeout_ms?: number): boolean;
+		receive(msgid: ChmpxMsgIdParam, rcvarr: [Buffer?, Buffer?], timeout_ms?: number): boolean;
+
+		// receive batch on server
+		receiveBatch(maxcount: number, timeout_ms?: number, no_giveup_rejoin?: boolean): [Buffer, Buffer][] | null;
+
+		// receive batch on slave
+		receiveBatch(msgid: ChmpxMsgIdParam, maxcount: number, timeout_ms?: number): [Buffer, Buffer][] | null;
 
 		// check
 		isChmpxExit(): boolean;
 
+		// destroy(cleanup runs off JS thread with callback)
+		destroy(cb?: ChmpxDestroyCallback): boolean;
+
+		// drain(stops accepting new operations, negative timeout_ms waits forever)
+		drain(cb: ChmpxDrainCallback): boolean;
+		drain(timeout_ms: number, cb: ChmpxDrainCallback): boolean;
+
+		// options
+		setReceiveOptions(options: ChmpxReceiveOptions): boolean;
+		setFlowOptions(options: ChmpxFlowOptions): boolean;
+
+		// statistics
+		getStats(): ChmpxStats;
+		resetStats(): boolean;
+
+		// fast path(fixed signature, no callback and no emitter, msgid is ignored on server)
+		sendFast(msgid: ChmpxMsgIdParam, body: ChmpxSendBody): number;
+		receiveFast(msgid: ChmpxMsgIdParam | null, timeout_ms: number): [Buffer, Buffer] | null;
+		replyFast(compkt: Buffer, body: ChmpxSendBody): boolean;
+
 		//-----------------------------------------------------
 		// Emitter registration/unregistration
 		//-----------------------------------------------------
+		// on() adds the listener(an emitter can have multiple listeners)
 		on(emitter: string, cb: OnChmpxEmitterCallback): boolean;
 		onInitializeOnServer(cb: OnChmpxInitializeOnServerEmitterCallback): boolean;
 		onInitializeOnSlave(cb: OnChmpxInitializeOnSlaveEmitterCallback): boolean;
@@ -148,25 +310,145 @@ declare namespace chmpx
 		onBroadcast(cb: OnChmpxBroadcastEmitterCallback): boolean;
 		onReply(cb: OnChmpxReplyEmitterCallback): boolean;
 		onReceive(cb: OnChmpxReceiveEmitterCallback): boolean;
+		onDrain(cb: OnChmpxDrainEmitterCallback): boolean;
 
-		off(emitter: string): boolean;
-		offInitializeOnServer(): boolean;
-		offInitializeOnSlave(): boolean;
-		offOpen(): boolean;
-		offClose(): boolean;
-		offSend(): boolean;
-		offBroadcast(): boolean;
-		offReply(): boolean;
-		offReceive(): boolean;
+		// off() removes the listener, or all listeners if cb is omitted
+		off(emitter: string, cb?: OnChmpxEmitterCallback): boolean;
+		offInitializeOnServer(cb?: OnChmpxInitializeOnServerEmitterCallback): boolean;
+		offInitializeOnSlave(cb?: OnChmpxInitializeOnSlaveEmitterCallback): boolean;
+		offOpen(cb?: OnChmpxOpenEmitterCallback): boolean;
+		offClose(cb?: OnChmpxCloseEmitterCallback): boolean;
+		offSend(cb?: OnChmpxSendEmitterCallback): boolean;
+		offBroadcast(cb?: OnChmpxBroadcastEmitterCallback): boolean;
+		offReply(cb?: OnChmpxReplyEmitterCallback): boolean;
+		offReceive(cb?: OnChmpxReceiveEmitterCallback): boolean;
+		offDrain(cb?: OnChmpxDrainEmitterCallback): boolean;
 
 		//-----------------------------------------------------
-		// Promise APIs(Currently no imprelemnts)
+		// Promise APIs
 		//-----------------------------------------------------
-		// [NOTE]
-		// Although it is not currently implemented, here is an example definition:
-		//
-		// ex.	receive(rcvarr: [Buffer?, Buffer?], timeout_ms: number, no_giveup_rejoin: boolean): Promise<boolean>;
-		//
+		// initialize
+		initializeOnServerAsync(filename: string, is_auto_rejoin?: boolean): Promise<void>;
+		initializeOnSlaveAsync(filename: string, is_auto_rejoin?: boolean): Promise<void>;
+
+		// send/broadcast
+		sendAsync(msgid: ChmpxMsgIdParam, body: ChmpxSendBody, is_routing?: boolean): Promise<number>;
+		broadcastAsync(msgid: ChmpxMsgIdParam, body: ChmpxSendBody): Promise<number>;
+
+		// receive on server(signal cancels waiting, negative timeout_ms waits forever)
+		receiveAsync(timeout_ms?: number, no_giveup_rejoin?: boolean, signal?: AbortSignal): Promise<[Buffer, Buffer]>;
+
+		// receive on slave
+		receiveAsync(msgid: ChmpxMsgIdParam, timeout_ms?: number, signal?: AbortSignal): Promise<[Buffer, Buffer]>;
+
+		// receive batch on server
+		receiveBatchAsync(maxcount: number, timeout_ms?: number, no_giveup_rejoin?: boolean, signal?: AbortSignal): Promise<[Buffer, Buffer][]>;
+
+		// receive batch on slave
+		receiveBatchAsync(msgid: ChmpxMsgIdParam, maxcount: number, timeout_ms?: number, signal?: AbortSignal): Promise<[Buffer, Buffer][]>;
+
+		// reply
+		replyAsync(compkt: Buffer, body: ChmpxSendBody): Promise<void>;
+
+		// open/close
+		openAsync(no_giveup_rejoin?: boolean): Promise<Buffer>;
+		closeAsync(msgid: ChmpxMsgIdParam): Promise<void>;
+		openMsgIdAsync(no_giveup_rejoin?: boolean): Promise<ChmpxMsgId>;
+		openPoolAsync(count: number, no_giveup_rejoin?: boolean): Promise<ChmpxMsgPool>;
+
+		// destroy
+		destroyAsync(): Promise<void>;
+
+		// drain
+		drainAsync(timeout_ms?: number): Promise<ChmpxDrainResult>;
+
+		// request/reply on slave(resolved with the reply body)
+		request(msgid: ChmpxMsgIdParam, body: ChmpxSendBody, timeout_ms?: number, is_routing?: boolean): Promise<Buffer>;
+	}
+
+	//---------------------------------------------------------
+	// ChmpxMsgId Class(created only by ChmpxNode::openMsgId)
+	//---------------------------------------------------------
+	export class ChmpxMsgId
+	{
+		private constructor();
+
+		readonly inflight:	number;		// async operations in flight on this handle
+		readonly pending:	number;		// requests waiting for the reply on this handle
+		readonly closed:	boolean;	// closed by ChmpxNode::close
+
+		toBuffer(): Buffer;
+		toBigInt(): bigint;
+		toString(): string;
+
+		// statistics of the operations on this msgid until it is closed
+		getStats(): ChmpxStats;
+		resetStats(): boolean;
+	}
+
+	//---------------------------------------------------------
+	// ChmpxMsgPool Class(created only by ChmpxNode::openPool)
+	//---------------------------------------------------------
+	export class ChmpxMsgPool
+	{
+		private constructor();
+
+		// send on the least busy msgid
+		send(body: ChmpxSendBody): number;
+		send(body: ChmpxSendBody, is_routing: boolean): number;
+
+		send(body: ChmpxSendBody, cb: ChmpxSendCallback): boolean;
+		send(body: ChmpxSendBody, is_routing: boolean, cb: ChmpxSendCallback): boolean;
+
+		// request on the least busy msgid(resolved with the reply body)
+		request(body: ChmpxSendBody, timeout_ms?: number, is_routing?: boolean): Promise<Buffer>;
+
+		// close all msgids
+		close(cb?: ChmpxCloseCallback): boolean;
+
+		// msgids in the pool(for receiving the replies of send)
+		msgids(): Buffer[];
+	}
+
+	//---------------------------------------------------------
+	// ChmpxMsgIterator Class(created only by ChmpxNode::messages)
+	//---------------------------------------------------------
+	// [NOTE]
+	// T is [Buffer, Buffer][] if the batch option is specified.
+	//
+	export class ChmpxMsgIterator<T = [Buffer, Buffer]> implements AsyncIterableIterator<T>
+	{
+		private constructor();
+
+		next(): Promise<IteratorResult<T, undefined>>;
+		return(value?: any): Promise<IteratorResult<T, undefined>>;
+		[Symbol.asyncIterator](): ChmpxMsgIterator<T>;
+	}
+
+	//---------------------------------------------------------
+	// ChmpxSendRing Class(created only by ChmpxNode::openSendRing)
+	//---------------------------------------------------------
+	// [NOTE]
+	// push() writes one record into the shared buffer without calling
+	// native code, and returns false if the ring is full or closed.
+	// The hash is computed from body when it is not specified.
+	//
+	export class ChmpxSendRing
+	{
+		private constructor();
+
+		readonly buffer:	SharedArrayBuffer;
+		readonly sent:		number;			// sent records
+		readonly errors:	number;			// records failed to send
+		readonly closed:	boolean;
+
+		push(body: Buffer | Uint8Array, hash?: number | bigint): boolean;
+
+		// wake up the sender thread(push calls this only when needed)
+		notify(): boolean;
+
+		// stop the sender thread, pushed records are sent after returning(does not wait)
+		close(): boolean;
 	}
 
 	//---------------------------------------------------------
@@ -213,7 +495,22 @@ declare module 'chmpx'
 	// ex. "import type { ChmpxNode } from 'chmpx'"
 	//
 	export type ChmpxNode			= chmpx.ChmpxNode;
+	export type ChmpxMsgId			= chmpx.ChmpxMsgId;
+	export type ChmpxMsgIdParam		= chmpx.ChmpxMsgIdParam;
+	export type ChmpxSendPiece		= chmpx.ChmpxSendPiece;
+	export type ChmpxSendBody		= chmpx.ChmpxSendBody;
+	export type ChmpxMsgPool		= chmpx.ChmpxMsgPool;
+	export type ChmpxMsgIterator<T = [Buffer, Buffer]>	= chmpx.ChmpxMsgIterator<T>;
+	export type ChmpxSendRing		= chmpx.ChmpxSendRing;
 	export type ChmpxFactoryType	= chmpx.ChmpxFactoryType;
+	export type ChmpxReceiveOptions	= chmpx.ChmpxReceiveOptions;
+	export type ChmpxMessagesOptions= chmpx.ChmpxMessagesOptions;
+	export type ChmpxFlowOptions	= chmpx.ChmpxFlowOptions;
+	export type ChmpxPoolOptions	= chmpx.ChmpxPoolOptions;
+	export type ChmpxSendRingOptions= chmpx.ChmpxSendRingOptions;
+	export type ChmpxOpStats		= chmpx.ChmpxOpStats;
+	export type ChmpxStats			= chmpx.ChmpxStats;
+	export type ChmpxDrainResult	= chmpx.ChmpxDrainResult;
 
 	// Add convenient alias (PascalCase)
 	export type Chmpx				= ChmpxNode;